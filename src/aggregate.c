@@ -0,0 +1,379 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "aggregate.h"
+#include "iio_posix.h"
+#include "verify.h"
+#include "content.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#ifdef HAVE_MPI
+
+typedef struct {
+	gboolean aggregator;	// this process wrote
+	glong bytes;
+	glong writes;
+	gdouble shuffleTime;
+	gdouble writeTime;
+} AggregateRun;
+
+
+/**
+ * Generates the data of a piece at its file offset. Like everywhere else
+ * --verify and --content generation isn't part of the measured time.
+ */
+static void aggregate_fill(gchar* buffer, glong length, guint64 key, off_t offset)
+{
+	if (verifyEnabled)
+		verify_fill(buffer, length, key, offset);
+	else
+		content_fill(buffer, length);
+}
+
+static gboolean aggregate_pwritev(int fd, struct iovec* iov, gint* iovcnt, off_t offset, glong length, AggregateRun* run)
+{
+	ssize_t rc = pwritev(fd, iov, *iovcnt, offset);
+
+	*iovcnt = 0;
+	run->writes++;
+
+	if (rc != length) {
+		Warning("(AggWrite) Wrote %ld of %ld bytes at offset %ld", (glong) rc, length, (glong) offset);
+		return FALSE;
+	}
+
+	run->bytes += length;
+	return TRUE;
+}
+
+/**
+ * Shuffle over MPI: round k covers the aggregators * stripeSize bytes
+ * from k * aggregators * stripeSize on, aggregator a receives stripe a of
+ * the round. Pieces travel in file order, so an aggregator finds the
+ * piece of every block at the front of the data of its owner.
+ */
+static gboolean aggregate_exchange(int fd, guint64 key, glong blockSize, glong count,
+		gint aggregators, glong stripeSize, MPI_Comm comm, AggregateRun* run)
+{
+	gint n, me, a, myStripe = -1;
+	gboolean success = TRUE;
+	GTimer* timer = g_timer_new();
+
+	MPI_Comm_size(comm, &n);
+	MPI_Comm_rank(comm, &me);
+
+	off_t total = (off_t) count * n * blockSize;
+	off_t roundSize = (off_t) aggregators * stripeSize;
+	off_t base, j;
+
+	for (a = 0; a < aggregators; ++a)
+		if (a * n / aggregators == me)
+			myStripe = a;
+	run->aggregator = (myStripe >= 0);
+
+	gint* sendCounts = g_new0(gint, n);
+	gint* sendDispls = g_new0(gint, n);
+	gint* recvCounts = g_new0(gint, n);
+	gint* recvDispls = g_new0(gint, n);
+	gint* used = g_new0(gint, n);
+	gchar* sendBuffer = g_malloc(MIN(roundSize, count * blockSize));
+	gchar* recvBuffer = g_malloc(run->aggregator? stripeSize : 1);
+	gchar* stripeBuffer = g_malloc(run->aggregator? stripeSize : 1);
+
+	for (base = 0; base < total; base += roundSize) {
+		glong offset = 0;
+
+		// pack the pieces of this process for every aggregator
+		memset(sendCounts, 0, n * sizeof(gint));
+		for (a = 0; a < aggregators; ++a) {
+			off_t start = MIN(base + (off_t) a * stripeSize, total);
+			off_t end = MIN(start + stripeSize, total);
+			gint dest = a * n / aggregators;
+
+			sendDispls[dest] = offset;
+			for (j = start / blockSize; j * blockSize < end; ++j) {
+				if (j % n != me)
+					continue;
+				off_t pieceStart = MAX(start, j * blockSize);
+				off_t pieceEnd = MIN(end, (j+1) * blockSize);
+				aggregate_fill(sendBuffer + offset, pieceEnd - pieceStart, key, pieceStart);
+				offset += pieceEnd - pieceStart;
+			}
+			sendCounts[dest] = offset - sendDispls[dest];
+		}
+
+		off_t start = MIN(base + (off_t) MAX(myStripe, 0) * stripeSize, total);
+		off_t end = MIN(start + stripeSize, total);
+
+		memset(recvCounts, 0, n * sizeof(gint));
+		if (run->aggregator) {
+			for (j = start / blockSize; j * blockSize < end; ++j)
+				recvCounts[j % n] += MIN(end, (j+1) * blockSize) - MAX(start, j * blockSize);
+			for (a = 1; a < n; ++a)
+				recvDispls[a] = recvDispls[a-1] + recvCounts[a-1];
+		}
+
+		g_timer_start(timer);
+		MPI_Alltoallv(sendBuffer, sendCounts, sendDispls, MPI_BYTE,
+				recvBuffer, recvCounts, recvDispls, MPI_BYTE, comm);
+
+		if (run->aggregator) {
+			memset(used, 0, n * sizeof(gint));
+			for (j = start / blockSize; j * blockSize < end; ++j) {
+				gint owner = j % n;
+				off_t pieceStart = MAX(start, j * blockSize);
+				glong length = MIN(end, (j+1) * blockSize) - pieceStart;
+				memcpy(stripeBuffer + (pieceStart - start), recvBuffer + recvDispls[owner] + used[owner], length);
+				used[owner] += length;
+			}
+		}
+		run->shuffleTime += g_timer_elapsed(timer, NULL);
+
+		if (run->aggregator && end > start && success) {
+			struct iovec iov = { stripeBuffer, end - start };
+			gint iovcnt = 1;
+
+			g_timer_start(timer);
+			success = aggregate_pwritev(fd, &iov, &iovcnt, start, end - start, run);
+			run->writeTime += g_timer_elapsed(timer, NULL);
+		}
+	}
+
+	g_timer_destroy(timer);
+	g_free(sendCounts);
+	g_free(sendDispls);
+	g_free(recvCounts);
+	g_free(recvDispls);
+	g_free(used);
+	g_free(sendBuffer);
+	g_free(recvBuffer);
+	g_free(stripeBuffer);
+	return success;
+}
+
+/**
+ * Shuffle through shared memory: every process copies its blocks into its
+ * segment of a window shared by the node, the lowest rank of the node
+ * then writes straight from the segments with pwritev. Runs of adjacent
+ * blocks are gathered until the next stripe boundary.
+ */
+static gboolean aggregate_shared(const gchar* path, guint64 key, glong blockSize, glong count,
+		glong stripeSize, MPI_Comm comm, AggregateRun* run)
+{
+	MPI_Comm node;
+	MPI_Win win;
+	gint n, me, nodeRank, nodeSize, q;
+	gboolean success = TRUE;
+	gchar* segment;
+	glong i;
+
+	MPI_Comm_size(comm, &n);
+	MPI_Comm_rank(comm, &me);
+	MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, me, MPI_INFO_NULL, &node);
+	MPI_Comm_rank(node, &nodeRank);
+	MPI_Comm_size(node, &nodeSize);
+
+	gint* members = g_new(gint, nodeSize);	// ranks in comm, ascending
+	MPI_Allgather(&me, 1, MPI_INT, members, 1, MPI_INT, node);
+
+	MPI_Win_allocate_shared(count * blockSize, 1, MPI_INFO_NULL, node, &segment, &win);
+	MPI_Win_fence(0, win);
+
+	GTimer* timer = g_timer_new();
+	gchar* block = g_malloc(blockSize);
+
+	for (i = 0; i < count; ++i) {
+		aggregate_fill(block, blockSize, key, ((off_t) i * n + me) * blockSize);
+		g_timer_start(timer);
+		memcpy(segment + i * blockSize, block, blockSize);
+		run->shuffleTime += g_timer_elapsed(timer, NULL);
+	}
+
+	g_timer_start(timer);
+	MPI_Win_fence(0, win);
+	run->shuffleTime += g_timer_elapsed(timer, NULL);
+
+	if (nodeRank == 0) {
+		gchar** segments = g_new(gchar*, nodeSize);
+		struct iovec iov[IOV_MAX];
+		gint iovcnt = 0;
+		off_t runStart = 0, runEnd = 0;
+		int fd;
+
+		for (q = 0; q < nodeSize; ++q) {
+			MPI_Aint segmentSize;
+			gint dispUnit;
+			MPI_Win_shared_query(win, q, &segmentSize, &dispUnit, &segments[q]);
+		}
+
+		run->aggregator = TRUE;
+		if ((fd = open(path, O_WRONLY|O_CREAT, DEFAULT_OPEN_MODE)) == -1) {
+			Warning("(AggWrite) Couldn't open \"%s\" for writing", path);
+			success = FALSE;
+		}
+
+		g_timer_start(timer);
+		for (i = 0; i < count && success; ++i) {
+			for (q = 0; q < nodeSize && success; ++q) {
+				off_t offset = ((off_t) i * n + members[q]) * blockSize;
+				gchar* data = segments[q] + i * blockSize;
+				glong left = blockSize;
+
+				while (left > 0 && success) {
+					off_t stripeEnd = (offset / stripeSize + 1) * stripeSize;
+					glong length = MIN(left, stripeEnd - offset);
+
+					if (iovcnt > 0 && (offset != runEnd || iovcnt == IOV_MAX))
+						success = aggregate_pwritev(fd, iov, &iovcnt, runStart, runEnd - runStart, run);
+					if (iovcnt == 0)
+						runStart = offset;
+
+					iov[iovcnt].iov_base = data;
+					iov[iovcnt].iov_len = length;
+					iovcnt++;
+					runEnd = offset + length;
+
+					if (runEnd == stripeEnd && success)
+						success = aggregate_pwritev(fd, iov, &iovcnt, runStart, runEnd - runStart, run);
+
+					offset += length;
+					data += length;
+					left -= length;
+				}
+			}
+		}
+		if (iovcnt > 0 && success)
+			success = aggregate_pwritev(fd, iov, &iovcnt, runStart, runEnd - runStart, run);
+		run->writeTime += g_timer_elapsed(timer, NULL);
+
+		if (fd != -1)
+			close(fd);
+		g_free(segments);
+	}
+
+	MPI_Win_fence(MPI_MODE_NOSUCCEED, win);
+	MPI_Win_free(&win);
+	MPI_Comm_free(&node);
+
+	g_timer_destroy(timer);
+	g_free(block);
+	g_free(members);
+	return success;
+}
+
+/**
+ * Collective over comm. Rank 0 creates or truncates the file before the
+ * aggregators open it, a failure on any process fails the statement on
+ * all of them. The core time is the shuffle and write time of the process.
+ */
+IOStatus aggregate_write(const gchar* path, glong blockSize, glong count, gint aggregators, glong stripeSize, MPI_Comm comm)
+{
+	AggregateRun run;
+	guint64 key = verify_key(path);
+	gint n, me, ok, allOk;
+	int fd = -1;
+
+	memset(&run, 0, sizeof(AggregateRun));
+	MPI_Comm_size(comm, &n);
+	MPI_Comm_rank(comm, &me);
+	aggregators = MIN(aggregators, n);
+
+	ok = TRUE;
+	if (me == 0) {
+		if ((fd = open(path, O_WRONLY|O_CREAT|O_TRUNC, DEFAULT_OPEN_MODE)) == -1) {
+			Warning("(AggWrite) Couldn't create \"%s\"", path);
+			ok = FALSE;
+		}
+		else
+			close(fd);
+	}
+	MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_LAND, comm);
+	if (!allOk)
+		return iostatus_new(FALSE, 0, 0);
+
+	if (aggregators > 0) {
+		gboolean aggregator = FALSE;
+		gint a;
+
+		for (a = 0; a < aggregators; ++a)
+			aggregator |= (a * n / aggregators == me);
+
+		if (aggregator && (fd = open(path, O_WRONLY, DEFAULT_OPEN_MODE)) == -1) {
+			Warning("(AggWrite) Couldn't open \"%s\" for writing", path);
+			ok = FALSE;
+		}
+		MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_LAND, comm);
+
+		if (allOk)
+			ok = aggregate_exchange(fd, key, blockSize, count, aggregators, stripeSize, comm, &run);
+		if (fd != -1)
+			close(fd);
+	}
+	else
+		ok = aggregate_shared(path, key, blockSize, count, stripeSize, comm, &run);
+
+	MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_LAND, comm);
+
+	gdouble time = run.shuffleTime + run.writeTime;
+
+	Verbose("(AggWrite) %ld bytes in %ld writes, shuffle %fs, write %fs%s", run.bytes, run.writes,
+			run.shuffleTime, run.writeTime, (run.aggregator? ", aggregator" : ""));
+
+	aggregateStats.runs++;
+	aggregateStats.bytes += run.bytes;
+	aggregateStats.writes += run.writes;
+	aggregateStats.aggregators += run.aggregator;
+	aggregateStats.time += time;
+	aggregateStats.shuffleTime += run.shuffleTime;
+	aggregateStats.writeTime += run.writeTime;
+
+	return iostatus_new(allOk, time, count * blockSize);
+}
+
+#endif
+
+void aggregate_reduce()
+{
+#ifdef HAVE_MPI
+	glong counts[3] = { aggregateStats.bytes, aggregateStats.writes, aggregateStats.aggregators };
+	gdouble times[3] = { aggregateStats.time, aggregateStats.shuffleTime, aggregateStats.writeTime };
+	glong sumCounts[3], maxRuns;
+	gdouble maxTimes[3];
+
+	MPI_Reduce(counts, sumCounts, 3, MPI_LONG, MPI_SUM, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(&aggregateStats.runs, &maxRuns, 1, MPI_LONG, MPI_MAX, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(times, maxTimes, 3, MPI_DOUBLE, MPI_MAX, MASTER, MPI_COMM_WORLD);
+
+	if (rank == MASTER) {
+		aggregateStats.runs = maxRuns;
+		aggregateStats.bytes = sumCounts[0];
+		aggregateStats.writes = sumCounts[1];
+		aggregateStats.aggregators = sumCounts[2];
+		aggregateStats.time = maxTimes[0];
+		aggregateStats.shuffleTime = maxTimes[1];
+		aggregateStats.writeTime = maxTimes[2];
+	}
+#endif
+}
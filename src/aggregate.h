@@ -0,0 +1,63 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AGGREGATE_H_
+#define AGGREGATE_H_
+
+#include "iio.h"
+
+#include <glib.h>
+
+/**
+ * Two-phase aggregated N-1 writes on POSIX level. Each process contributes
+ * count blocks of blockSize bytes to a shared file, block i of process r
+ * lies at offset (i * size + r) * blockSize, the strided layout that turns
+ * independent writes into many small unaligned ones. Instead the blocks
+ * are shipped to a few aggregators (shuffle phase) which issue large
+ * stripe-aligned pwrites (write phase), like the collective buffering of
+ * ROMIO but under control of the benchmark.
+ *
+ * With aggregators > 0 the file is dealt round-robin in stripes of
+ * stripeSize bytes to that many processes spread evenly over the ranks,
+ * the data moves with MPI_Alltoallv one round of stripes at a time. With
+ * aggregators == 0 the processes of each node copy their blocks into an
+ * MPI-3 shared memory window and the lowest rank of the node writes them,
+ * split at stripe boundaries.
+ */
+
+#define AGGREGATE_STRIPE_SIZE (1024*1024)	// default stripe size
+
+typedef struct {
+	glong runs;				// executed aggwrite statements
+	glong bytes;			// bytes written by the aggregators
+	glong writes;			// pwrite calls of the aggregators
+	glong aggregators;		// aggregators summed over all runs
+	gdouble time;			// seconds of shuffle and write
+	gdouble shuffleTime;	// seconds spent moving data to the aggregators
+	gdouble writeTime;		// seconds spent in pwrite
+} AggregateStats;
+
+AggregateStats aggregateStats;
+
+
+#ifdef HAVE_MPI
+IOStatus aggregate_write(const gchar* path, glong blockSize, glong count, gint aggregators, glong stripeSize, MPI_Comm comm);
+#endif
+void     aggregate_reduce();
+
+#endif /* AGGREGATE_H_ */
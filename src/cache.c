@@ -0,0 +1,188 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "cache.h"
+#include "iio_posix.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/**
+ * Writes back the dirty pages of a file and drops its cached pages.
+ * POSIX_FADV_DONTNEED only drops clean pages, so the file is synced first.
+ */
+static gboolean cache_evict_file(const gchar* path)
+{
+	int fd = open(path, O_RDONLY);
+	gboolean success;
+
+	if (fd == -1) {
+		Warning("(Evict) Couldn't open file \"%s\"", path);
+		return FALSE;
+	}
+
+	success = (fdatasync(fd) == 0);
+	success &= (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+	close(fd);
+
+	return success;
+}
+
+static gboolean cache_evict_path(const gchar* path)
+{
+	struct stat st;
+
+	if (lstat(path, &st) == -1) {
+		Warning("(Evict) Couldn't stat \"%s\"", path);
+		return FALSE;
+	}
+
+	if (S_ISREG(st.st_mode))
+		return cache_evict_file(path);
+
+	if (!S_ISDIR(st.st_mode))
+		return TRUE;
+
+	GDir* dir = g_dir_open(path, 0, NULL);
+	const gchar* name;
+	gboolean success = TRUE;
+
+	if (!dir) {
+		Warning("(Evict) Couldn't open directory \"%s\"", path);
+		return FALSE;
+	}
+
+	while ((name = g_dir_read_name(dir))) {
+		gchar* child = g_build_filename(path, name, NULL);
+		success &= cache_evict_path(child);
+		g_free(child);
+	}
+	g_dir_close(dir);
+
+	return success;
+}
+
+/**
+ * Evicts a file or all regular files below a directory from the page
+ * cache. Symbolic links are not followed.
+ */
+IOStatus cache_evict(const gchar* path)
+{
+	CORETIME_START();
+	gboolean success = cache_evict_path(path);
+	CORETIME_STOP(time);
+
+	return iostatus_new(success, time, 0);
+}
+
+/**
+ * Drops page cache, dentries and inodes of the whole node. Fails with a
+ * warning if the process isn't allowed to write to CACHE_DROP_FILE.
+ */
+IOStatus cache_drop()
+{
+	gboolean success = FALSE;
+	int fd;
+
+	CORETIME_START();
+	sync();
+	if ((fd = open(CACHE_DROP_FILE, O_WRONLY)) != -1) {
+		success = (write(fd, "3", 1) == 1);
+		close(fd);
+	}
+	CORETIME_STOP(time);
+
+	if (!success)
+		Warning("(DropCaches) Couldn't write to %s, root privileges are required", CACHE_DROP_FILE);
+
+	return iostatus_new(success, time, 0);
+}
+
+/**
+ * Physical memory of the node in bytes or 0 if unknown.
+ */
+glong cache_memory_size()
+{
+	glong pages = sysconf(_SC_PHYS_PAGES);
+	glong pageSize = sysconf(_SC_PAGESIZE);
+
+	return (pages > 0 && pageSize > 0)? pages * pageSize : 0;
+}
+
+/**
+ * Writes a scratch file of the given size and reads it back, so the cache
+ * is filled with pages nobody is interested in. A size of 0 selects the
+ * physical memory of the node plus an eighth. The file is removed
+ * afterwards. Processes on the same node share the memory, so usually
+ * only one of them should run this.
+ */
+IOStatus cache_scratch(const gchar* path, glong size)
+{
+	glong done = 0;
+	gboolean success = TRUE;
+	ssize_t rc = 0;
+	int fd;
+
+	if (size <= 0) {
+		size = cache_memory_size();
+		size += size / 8;
+	}
+
+	if (size <= 0) {
+		Warning("(EvictScratch) Couldn't determine the memory size, specify the scratch size");
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	gchar* buffer = g_malloc(CACHE_SCRATCH_CHUNK);
+	memset(buffer, '0', CACHE_SCRATCH_CHUNK);
+
+	CORETIME_START();
+	fd = open(path, O_RDWR|O_CREAT|O_TRUNC, DEFAULT_OPEN_MODE);
+
+	if (fd != -1) {
+		while (done < size && (rc = write(fd, buffer, MIN(size - done, CACHE_SCRATCH_CHUNK))) > 0)
+			done += rc;
+		success = (done == size && fdatasync(fd) == 0);
+
+		lseek(fd, 0, SEEK_SET);
+		done = 0;
+		while (success && (rc = read(fd, buffer, CACHE_SCRATCH_CHUNK)) > 0)
+			done += rc;
+		success &= (rc == 0 && done == size);
+
+		close(fd);
+		unlink(path);
+	}
+	else
+		success = FALSE;
+	CORETIME_STOP(time);
+
+	if (fd == -1)
+		Warning("(EvictScratch) Couldn't open scratch file \"%s\"", path);
+
+	g_free(buffer);
+
+	return iostatus_new(success, time, 0);
+}
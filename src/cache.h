@@ -0,0 +1,51 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include "iio.h"
+
+#include <glib.h>
+
+/**
+ * Cache control between benchmark phases. Reading back a file the same
+ * node has just written mostly measures the page cache, these functions
+ * push the data out before a read phase. They always act on the local
+ * file system, independent of the selected I/O engine, and are timed as
+ * core time like any other I/O call.
+ *
+ *   evict(path)          write back and drop the cached pages of a file
+ *                        or of all files below a directory
+ *   dropcaches()         sync and drop all clean caches of the node,
+ *                        needs root
+ *   evictscratch(path)   write and read a scratch file larger than the
+ *                        memory of the node, works without privileges
+ */
+
+#define CACHE_DROP_FILE "/proc/sys/vm/drop_caches"
+#define CACHE_SCRATCH_CHUNK (1024*1024)		// transfer size of the scratch file
+
+
+IOStatus cache_evict(const gchar* path);
+IOStatus cache_drop();
+IOStatus cache_scratch(const gchar* path, glong size);
+
+glong cache_memory_size();
+
+#endif /* CACHE_H_ */
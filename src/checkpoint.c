@@ -0,0 +1,309 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "checkpoint.h"
+#include "phases.h"
+#include "iio_posix.h"
+
+/*
+ * Checkpoint/restart in the common layouts. Every process writes size
+ * bytes in CHECKPOINT_BLOCK_SIZE transfers, optionally reads back the
+ * checkpoint of the process shift ranks further (so it can't come from
+ * its own page cache) and removes the files again. Write, restart and
+ * remove are phases (see phases.c), so the Phase Report shows their
+ * aggregated bandwidth and the time of the slowest process.
+ *
+ *   N-N  path/ckpt.<rank>, below path/ckpt.<rank % count>/ with count shards
+ *   N-1  path/ckpt.shared, segments start at multiples of size rounded up to align
+ *   N-M  path/ckpt.<f>.sub, rank r writes to subfile f = r * count / procs
+ */
+
+typedef struct {
+	const CheckpointParams* params;
+	const gchar* path;
+	gint procs;				// processes of the group
+	gint groupRank;
+	glong count;			// shard directories or subfiles in use
+	gboolean success;
+} Checkpoint;
+
+
+static void checkpoint_account(Checkpoint* ckpt, IOStatus ioStatus, glong* ops, glong* data)
+{
+	dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+	if (ioStatus.success) {
+		(*ops)++;
+		if (data) (*data) += ioStatus.coreTime.data;
+	}
+	else ckpt->success = FALSE;
+}
+
+/**
+ * First rank of the N-M subfile f, the ranks of a subfile are consecutive.
+ */
+static gint checkpoint_subfile_first(const Checkpoint* ckpt, glong f)
+{
+	return (f * ckpt->procs + ckpt->count - 1) / ckpt->count;
+}
+
+/**
+ * Returns the file holding the checkpoint of process r and the offset of
+ * it in there.
+ */
+static gchar* checkpoint_location(const Checkpoint* ckpt, gint r, off_t* offset)
+{
+	const CheckpointParams* params = ckpt->params;
+
+	switch (params->layout) {
+		case CHECKPOINT_N1: {
+			glong stride = (params->size + params->align - 1) / params->align * params->align;
+			*offset = (off_t) r * stride;
+			return g_strdup_printf("%s/ckpt.shared", ckpt->path);
+		}
+
+		case CHECKPOINT_NM: {
+			glong f = (glong) r * ckpt->count / ckpt->procs;
+			*offset = (off_t) (r - checkpoint_subfile_first(ckpt, f)) * params->size;
+			return g_strdup_printf("%s/ckpt.%ld.sub", ckpt->path, f);
+		}
+
+		default:
+			*offset = 0;
+			if (ckpt->count > 1)
+				return g_strdup_printf("%s/ckpt.%ld/ckpt.%d", ckpt->path, r % ckpt->count, r);
+			return g_strdup_printf("%s/ckpt.%d", ckpt->path, r);
+	}
+}
+
+/**
+ * The owner of a shared file creates and removes it.
+ */
+static gboolean checkpoint_owner(const Checkpoint* ckpt)
+{
+	switch (ckpt->params->layout) {
+		case CHECKPOINT_N1:
+			return ckpt->groupRank == 0;
+		case CHECKPOINT_NM:
+			return checkpoint_subfile_first(ckpt, (glong) ckpt->groupRank * ckpt->count / ckpt->procs) == ckpt->groupRank;
+		default:
+			return FALSE;
+	}
+}
+
+static gboolean checkpoint_sharded(const Checkpoint* ckpt)
+{
+	return ckpt->params->layout == CHECKPOINT_NN && ckpt->count > 1 && ckpt->groupRank < ckpt->count;
+}
+
+/**
+ * Creates the shard directories and (truncates) the shared files, this
+ * isn't part of the phases.
+ */
+static void checkpoint_prepare(Checkpoint* ckpt)
+{
+	off_t offset;
+	File* file;
+
+	if (checkpoint_sharded(ckpt)) {
+		gchar* dir = g_strdup_printf("%s/ckpt.%d", ckpt->path, ckpt->groupRank);
+		if (!iio_mkdir(dir).success)
+			Warning("(Checkpoint) Couldn't create shard directory \"%s\"", dir);
+		g_free(dir);
+	}
+
+	if (checkpoint_owner(ckpt)) {
+		gchar* path = checkpoint_location(ckpt, ckpt->groupRank, &offset);
+		if (iio_fopen(path, O_WRONLY|O_CREAT|O_TRUNC, &file).success)
+			iio_fclose(file);
+		else
+			Warning("(Checkpoint) Couldn't create \"%s\"", path);
+		g_free(path);
+	}
+}
+
+static void checkpoint_write(Checkpoint* ckpt, PhaseContext* ctx)
+{
+	const CheckpointParams* params = ckpt->params;
+	gint flags = (params->layout == CHECKPOINT_NN)? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY;
+	glong ops = 0, data = 0, done;
+	off_t offset;
+	File* file;
+
+	gchar* path = checkpoint_location(ckpt, ckpt->groupRank, &offset);
+
+	phase_begin(ctx);
+	IOStatus ioStatus = iio_fopen(path, flags, &file);
+	checkpoint_account(ckpt, ioStatus, &ops, NULL);
+
+	if (ioStatus.success) {
+		if (file->type == FILE_POSIX)
+			iio_set_sync_policy(file, params->sync, (params->sync == SYNC_FDATASYNC)? CHECKPOINT_BLOCK_SIZE : 1);
+
+		for (done = 0; done < params->size && ckpt->success; done += CHECKPOINT_BLOCK_SIZE)
+			checkpoint_account(ckpt, iio_fwrite(file, MIN(CHECKPOINT_BLOCK_SIZE, params->size - done), offset + done), &ops, &data);
+		checkpoint_account(ckpt, iio_fclose(file), &ops, NULL);
+	}
+	phase_end(ctx, "write", ops, data);
+
+	g_free(path);
+}
+
+static void checkpoint_restart(Checkpoint* ckpt, PhaseContext* ctx)
+{
+	const CheckpointParams* params = ckpt->params;
+	gint source = ((ckpt->groupRank + params->shift) % ckpt->procs + ckpt->procs) % ckpt->procs;
+	glong ops = 0, data = 0, done;
+	off_t offset;
+	File* file;
+
+	gchar* path = checkpoint_location(ckpt, source, &offset);
+
+	phase_begin(ctx);
+	IOStatus ioStatus = iio_fopen(path, O_RDONLY, &file);
+	checkpoint_account(ckpt, ioStatus, &ops, NULL);
+
+	if (ioStatus.success) {
+		for (done = 0; done < params->size && ckpt->success; done += CHECKPOINT_BLOCK_SIZE)
+			checkpoint_account(ckpt, iio_fread(file, MIN(CHECKPOINT_BLOCK_SIZE, params->size - done), offset + done), &ops, &data);
+		checkpoint_account(ckpt, iio_fclose(file), &ops, NULL);
+	}
+	phase_end(ctx, "restart", ops, data);
+
+	g_free(path);
+}
+
+static void checkpoint_remove(Checkpoint* ckpt, PhaseContext* ctx)
+{
+	glong ops = 0;
+	off_t offset;
+
+	phase_begin(ctx);
+	if (ckpt->params->layout == CHECKPOINT_NN || checkpoint_owner(ckpt)) {
+		gchar* path = checkpoint_location(ckpt, ckpt->groupRank, &offset);
+		checkpoint_account(ckpt, iio_delete(path), &ops, NULL);
+		g_free(path);
+	}
+	phase_end(ctx, "remove", ops, 0);
+
+	if (ckpt->params->layout == CHECKPOINT_NN && ckpt->count > 1) {
+#ifdef HAVE_MPI
+		MPI_ASSERT(MPI_Barrier(ctx->comm), "Checkpoint", TRUE)
+#endif
+		if (checkpoint_sharded(ckpt)) {
+			gchar* dir = g_strdup_printf("%s/ckpt.%d", ckpt->path, ckpt->groupRank);
+			iio_rmdir(dir);
+			g_free(dir);
+		}
+	}
+}
+
+/**
+ * Parses the layout of the checkpoint statement: nn, n1 or nm, optionally
+ * followed by ":value" with k, m or g suffix. The value is the number of
+ * shard directories for nn, the segment alignment for n1 and the number of
+ * subfiles for nm.
+ */
+gboolean checkpoint_layout_parse(const gchar* spec, CheckpointParams* params)
+{
+	gchar** parts = g_strsplit(spec, ":", 2);
+	gboolean valid = TRUE;
+	glong value = 0;
+	gchar* end;
+
+	if (g_ascii_strcasecmp(parts[0], "nn") == 0)
+		params->layout = CHECKPOINT_NN;
+	else if (g_ascii_strcasecmp(parts[0], "n1") == 0)
+		params->layout = CHECKPOINT_N1;
+	else if (g_ascii_strcasecmp(parts[0], "nm") == 0)
+		params->layout = CHECKPOINT_NM;
+	else
+		valid = FALSE;
+
+	if (valid && parts[1]) {
+		value = g_ascii_strtoll(parts[1], &end, 10);
+		switch (g_ascii_tolower(*end)) {
+			case 'k': value *= 1024; end++; break;
+			case 'm': value *= 1024 * 1024; end++; break;
+			case 'g': value *= 1024 * 1024 * 1024; end++; break;
+		}
+		valid = (*end == '\0' && value > 0);
+	}
+
+	g_strfreev(parts);
+
+	params->count = (params->layout == CHECKPOINT_NN && value == 0)? 1 : value;
+	params->align = (value > 0)? value : CHECKPOINT_ALIGN;
+	return valid;
+}
+
+/**
+ * Runs write, restart and remove of a checkpoint below path. Has to be
+ * called collectively by all processes of the active group. Returns FALSE
+ * if any operation failed.
+ */
+gboolean checkpoint_run(const gchar* path, const CheckpointParams* params)
+{
+	g_assert(params->size > 0);
+
+	Checkpoint ckpt;
+	PhaseContext ctx;
+
+	phase_context_init(&ctx, "checkpoint");
+
+	ckpt.params = params;
+	ckpt.path = path;
+	ckpt.procs = 1;
+	ckpt.groupRank = 0;
+	ckpt.count = params->count;
+	ckpt.success = TRUE;
+
+#ifdef HAVE_MPI
+	MPI_Comm_rank(ctx.comm, &ckpt.groupRank);
+	MPI_Comm_size(ctx.comm, &ckpt.procs);
+
+	// N-M without a count: one subfile per node
+	if (params->layout == CHECKPOINT_NM && ckpt.count == 0) {
+		MPI_Comm node;
+		gint nodeRank, leader, nodes;
+
+		MPI_Comm_split_type(ctx.comm, MPI_COMM_TYPE_SHARED, ckpt.groupRank, MPI_INFO_NULL, &node);
+		MPI_Comm_rank(node, &nodeRank);
+		leader = (nodeRank == 0);
+		MPI_Allreduce(&leader, &nodes, 1, MPI_INT, MPI_SUM, ctx.comm);
+		MPI_Comm_free(&node);
+		ckpt.count = nodes;
+	}
+#endif
+	ckpt.count = CLAMP(ckpt.count, 1, ckpt.procs);
+
+	Verbose("(Checkpoint) path = %s, layout = %d, count = %ld, size = %ld, restart = %d, shift = %d",
+			path, params->layout, ckpt.count, params->size, params->restart, params->shift);
+
+	checkpoint_prepare(&ckpt);
+	checkpoint_write(&ckpt, &ctx);
+	if (params->restart)
+		checkpoint_restart(&ckpt, &ctx);
+	checkpoint_remove(&ckpt, &ctx);
+
+	phase_context_free(&ctx);
+
+	return ckpt.success;
+}
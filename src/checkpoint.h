@@ -0,0 +1,49 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include "iio.h"
+
+#include <glib.h>
+
+#define CHECKPOINT_BLOCK_SIZE (1024*1024)	// transfer size of writes and reads
+#define CHECKPOINT_ALIGN (1024*1024)		// default segment alignment of N-1
+
+typedef enum {
+	CHECKPOINT_NN,		// file per process, sharded over directories
+	CHECKPOINT_N1,		// one shared file with aligned segments
+	CHECKPOINT_NM		// subfiles shared by consecutive ranks
+} CheckpointLayout;
+
+typedef struct {
+	CheckpointLayout layout;
+	glong count;			// N-N: shard directories, N-M: subfiles (0 = one per node)
+	glong align;			// N-1: alignment of the segments
+	glong size;				// bytes per process
+	SyncPolicyType sync;	// sync policy of the checkpoint files
+	gboolean restart;		// read a checkpoint back after writing
+	gint shift;				// restart from the checkpoint of rank + shift
+} CheckpointParams;
+
+
+gboolean checkpoint_layout_parse(const gchar* spec, CheckpointParams* params);
+gboolean checkpoint_run(const gchar* path, const CheckpointParams* params);
+
+#endif /* CHECKPOINT_H_ */
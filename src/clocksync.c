@@ -0,0 +1,128 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "clocksync.h"
+
+#include <time.h>
+
+
+void clock_init()
+{
+	clockOffset = 0;
+	clockError = 0;
+	clockStart = 0;
+	clockGlobal = FALSE;
+}
+
+/**
+ * Local clock in seconds, MPI_Wtime if available.
+ */
+gdouble clock_local()
+{
+#ifdef HAVE_MPI
+	return MPI_Wtime();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+gdouble clock_global()
+{
+	return clock_local() + clockOffset;
+}
+
+/**
+ * Seconds since the kernel was started, comparable between processes.
+ */
+gdouble clock_elapsed()
+{
+	return clock_global() - clockStart;
+}
+
+/**
+ * Estimates the offset of every process to the master's clock. The
+ * processes exchange CLOCKSYNC_ROUNDS ping-pongs with the master one after
+ * another, the exchange with the shortest round trip gives the offset
+ * (NTP style, assuming symmetric latencies). Has to be called by all
+ * processes of MPI_COMM_WORLD.
+ */
+void clock_sync()
+{
+#ifdef HAVE_MPI
+	MPI_Status stat;
+	gint* isGlobal;
+	gint flag, i, j;
+	gdouble masterTime;
+
+	MPI_Comm_get_attr(MPI_COMM_WORLD, MPI_WTIME_IS_GLOBAL, &isGlobal, &flag);
+	clockGlobal = (flag && *isGlobal);
+
+	if (clockGlobal || size == 1) {
+		clockOffset = clockError = 0;
+		return;
+	}
+
+	if (rank == MASTER) {
+		for (i=1; i<size; i++) {
+			for (j=0; j<CLOCKSYNC_ROUNDS; j++) {
+				MPI_Recv(NULL, 0, MPI_BYTE, i, 10, MPI_COMM_WORLD, &stat);
+				masterTime = clock_local();
+				MPI_Send(&masterTime, 1, MPI_DOUBLE, i, 11, MPI_COMM_WORLD);
+			}
+		}
+		clockOffset = clockError = 0;
+	}
+	else {
+		gdouble bestRtt = G_MAXDOUBLE;
+
+		for (j=0; j<CLOCKSYNC_ROUNDS; j++) {
+			gdouble sent = clock_local();
+			MPI_Send(NULL, 0, MPI_BYTE, MASTER, 10, MPI_COMM_WORLD);
+			MPI_Recv(&masterTime, 1, MPI_DOUBLE, MASTER, 11, MPI_COMM_WORLD, &stat);
+			gdouble received = clock_local();
+
+			if (received - sent < bestRtt) {
+				bestRtt = received - sent;
+				clockOffset = masterTime - (sent + received) / 2;
+				clockError = bestRtt / 2;
+			}
+		}
+	}
+#else
+	clockOffset = clockError = 0;
+#endif
+}
+
+/**
+ * Sets the time origin of all events to now on the master's clock.
+ * Collective over MPI_COMM_WORLD.
+ */
+void clock_start()
+{
+#ifdef HAVE_MPI
+	MPI_Barrier(MPI_COMM_WORLD);
+	clockStart = clock_global();
+	MPI_Bcast(&clockStart, 1, MPI_DOUBLE, MASTER, MPI_COMM_WORLD);
+#else
+	clockStart = clock_global();
+#endif
+}
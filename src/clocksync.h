@@ -0,0 +1,47 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLOCKSYNC_H_
+#define CLOCKSYNC_H_
+
+#include <glib.h>
+
+/**
+ * Global timeline. The master's clock is the reference, every process
+ * estimates the offset of its own clock once at startup, so event start
+ * and end times of different processes can be compared. All timestamps
+ * of events are given in seconds since the kernel started on the master.
+ */
+
+#define CLOCKSYNC_ROUNDS 16		// ping-pong exchanges per process
+
+gdouble clockOffset;		// add to the local clock to get the master's clock
+gdouble clockError;			// uncertainty of the offset (half round trip time)
+gdouble clockStart;			// master clock when the kernel was started
+gboolean clockGlobal;		// MPI_Wtime is already synchronized (MPI_WTIME_IS_GLOBAL)
+
+
+void clock_init();
+void clock_sync();
+void clock_start();
+
+gdouble clock_local();
+gdouble clock_global();
+gdouble clock_elapsed();
+
+#endif /* CLOCKSYNC_H_ */
@@ -0,0 +1,171 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "content.h"
+
+#include <string.h>
+
+static guint64* pool = NULL;
+static glong poolWords = 0;
+static guint64 blockCounter = 0;	// blocks generated by this process
+
+
+static inline guint64 content_mix(guint64 x)
+{
+	// splitmix64 finalizer
+	x += G_GUINT64_CONSTANT(0x9E3779B97F4A7C15);
+	x = (x ^ (x >> 30)) * G_GUINT64_CONSTANT(0xBF58476D1CE4E5B9);
+	x = (x ^ (x >> 27)) * G_GUINT64_CONSTANT(0x94D049BB133111EB);
+	return x ^ (x >> 31);
+}
+
+/**
+ * Fills the pool with xorshift128+ output. The lanes are independent, so
+ * the inner loop uses shifts, xors and adds on vector registers.
+ */
+static void content_pool_init(glong size)
+{
+	enum { LANES = 8 };
+	guint64 s0[LANES], s1[LANES];
+	glong i;
+	gint j;
+
+	poolWords = size / sizeof(guint64);
+	pool = g_malloc(poolWords * sizeof(guint64));
+
+	for (j=0; j<LANES; j++) {
+		s0[j] = content_mix(((guint64) rank << 32) + 2*j);
+		s1[j] = content_mix(((guint64) rank << 32) + 2*j + 1);
+	}
+
+	for (i=0; i+LANES<=poolWords; i+=LANES) {
+		for (j=0; j<LANES; j++) {
+			guint64 x = s0[j];
+			guint64 y = s1[j];
+			s0[j] = y;
+			x ^= x << 23;
+			s1[j] = x ^ y ^ (x >> 17) ^ (y >> 26);
+			pool[i+j] = s1[j] + y;
+		}
+	}
+}
+
+/**
+ * Parses MODE[:RATIO[:SIZE]] and prepares the random pool.
+ */
+gboolean content_configure(const gchar* spec)
+{
+	gchar** parts = g_strsplit(spec, ":", 3);
+	gboolean valid = TRUE;
+	gchar* end;
+
+	contentRatio = 1;
+	contentBlockSize = CONTENT_BLOCK_SIZE;
+
+	if (g_ascii_strcasecmp(parts[0], "zeros") == 0)
+		contentMode = CONTENT_ZEROS;
+	else if (g_ascii_strcasecmp(parts[0], "random") == 0)
+		contentMode = CONTENT_RANDOM;
+	else if (g_ascii_strcasecmp(parts[0], "compress") == 0)
+		contentMode = CONTENT_COMPRESS;
+	else if (g_ascii_strcasecmp(parts[0], "dedup") == 0)
+		contentMode = CONTENT_DEDUP;
+	else
+		valid = FALSE;
+
+	// ratios only apply to compress and dedup, the block size to both
+	if (valid && parts[1]) {
+		contentRatio = g_ascii_strtod(parts[1], &end);
+		valid = (contentMode >= CONTENT_COMPRESS && *end == '\0' && contentRatio >= 1);
+	}
+
+	if (valid && parts[1] && parts[2]) {
+		contentBlockSize = g_ascii_strtoll(parts[2], &end, 10);
+		switch (g_ascii_tolower(*end)) {
+			case 'k': contentBlockSize *= 1024; end++; break;
+			case 'm': contentBlockSize *= 1024 * 1024; end++; break;
+		}
+		valid = (*end == '\0' && contentBlockSize >= 64 && contentBlockSize % sizeof(guint64) == 0);
+	}
+
+	g_strfreev(parts);
+
+	if (!valid) {
+		contentMode = CONTENT_ZEROS;
+		return FALSE;
+	}
+
+	if (contentMode != CONTENT_ZEROS && !pool)
+		content_pool_init(MAX(CONTENT_POOL_SIZE, 2 * contentBlockSize));
+
+	return TRUE;
+}
+
+void content_free()
+{
+	g_free(pool);
+	pool = NULL;
+	poolWords = 0;
+}
+
+/**
+ * Fills one block of length bytes (at most contentBlockSize) with the
+ * content of block id.
+ */
+static void content_block(gchar* block, glong length, guint64 id, glong random)
+{
+	guint64 key = content_mix(id ^ ((guint64) rank << 40));
+	glong blockWords = contentBlockSize / sizeof(guint64);
+	const guint64* src = pool + key % (poolWords - blockWords + 1);
+	guint64* dst = (guint64*) block;
+	glong words = MIN(random, length) / sizeof(guint64);
+	glong i;
+
+	// scrambling with the key keeps copies of the pool from compressing
+	for (i=0; i<words; i++)
+		dst[i] = src[i] ^ key;
+
+	for (i=words*sizeof(guint64); i<MIN(random, length); i++)
+		block[i] = ((const gchar*) src)[i] ^ (gchar) key;
+
+	if (length > random)
+		memset(block + random, 0, length - random);
+}
+
+void content_fill(gchar* buffer, glong length)
+{
+	glong random = contentBlockSize;
+	glong pos, bytes;
+
+	if (contentMode == CONTENT_ZEROS)
+		return;
+
+	// the compressible part of a block is left zero, at least one word stays random
+	if (contentMode == CONTENT_COMPRESS)
+		random = MAX(sizeof(guint64), (glong) (contentBlockSize / contentRatio) & ~7L);
+
+	for (pos=0; pos<length; pos+=bytes) {
+		bytes = MIN(contentBlockSize, length - pos);
+
+		// RATIO consecutive blocks share their id
+		guint64 id = (contentMode == CONTENT_DEDUP)? (guint64) (blockCounter / contentRatio) : blockCounter;
+		content_block(buffer + pos, bytes, id, random);
+		blockCounter++;
+	}
+}
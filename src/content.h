@@ -0,0 +1,60 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTENT_H_
+#define CONTENT_H_
+
+#include <glib.h>
+
+/**
+ * Content of the buffers sent by the write statements (--content). Storage
+ * with inline compression or deduplication reports very different
+ * bandwidths depending on what is written, constant buffers only show the
+ * best case.
+ *
+ *   zeros              constant buffers (default)
+ *   random             incompressible, every block unique
+ *   compress:RATIO     every block compresses by about RATIO
+ *   dedup:RATIO[:SIZE] only one of RATIO blocks of SIZE bytes is unique
+ *
+ * Blocks are copied from a pool of random data at a varying position and
+ * scrambled with a per block key, so every write gets fresh content at
+ * memory speed. Filling is done outside of the core time.
+ */
+
+#define CONTENT_BLOCK_SIZE 4096			// default block size of dedup and compress
+#define CONTENT_POOL_SIZE (4*1024*1024)	// minimum size of the random pool
+
+typedef enum {
+	CONTENT_ZEROS,
+	CONTENT_RANDOM,
+	CONTENT_COMPRESS,
+	CONTENT_DEDUP
+} ContentMode;
+
+ContentMode contentMode;
+gdouble contentRatio;		// target compression or dedup ratio
+glong contentBlockSize;		// granularity of the ratio
+
+
+gboolean content_configure(const gchar* spec);
+void     content_free();
+
+void content_fill(gchar* buffer, glong length);
+
+#endif /* CONTENT_H_ */
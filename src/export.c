@@ -0,0 +1,639 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "export.h"
+#include "imbalance.h"
+#include "iio.h"
+#include "iio_posix.h"
+#include "xml.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glib/gstdio.h>
+#include <glib/gprintf.h>
+
+#ifndef BUILD_FLAGS
+#define BUILD_FLAGS ""
+#endif
+
+static ExportFormat exportFormat;
+static FILE* exportFile = NULL;			// jsonl and csv output
+static XmlDocument* exportDoc = NULL;	// xml output
+static const gchar* exportList = NULL;	// type of the open xml EventList
+
+static gchar* hosts = NULL;				// HOST_SIZE bytes per rank (master only)
+
+
+gboolean export_format_parse(const gchar* name, ExportFormat* format)
+{
+	if (g_ascii_strcasecmp(name, "xml") == 0)
+		*format = EXPORT_XML;
+	else if (g_ascii_strcasecmp(name, "jsonl") == 0 || g_ascii_strcasecmp(name, "json") == 0)
+		*format = EXPORT_JSONL;
+	else if (g_ascii_strcasecmp(name, "csv") == 0)
+		*format = EXPORT_CSV;
+	else
+		return FALSE;
+
+	return TRUE;
+}
+
+const gchar* export_default_path(ExportFormat format)
+{
+	switch (format) {
+		case EXPORT_JSONL: return "results.jsonl";
+		case EXPORT_CSV:   return "results.csv";
+		default:           return "results.xml";
+	}
+}
+
+/**
+ * Collects the hostname of every process on the master. Has to be called
+ * by all processes.
+ */
+void export_gather_hosts()
+{
+	gchar host[HOST_SIZE] = "";
+
+	g_free(hosts);
+	hosts = (rank == MASTER)? g_malloc0(size * HOST_SIZE) : NULL;
+
+#ifdef HAVE_MPI
+	gchar name[MPI_MAX_PROCESSOR_NAME];
+	int length;
+
+	MPI_Get_processor_name(name, &length);
+	g_strlcpy(host, name, HOST_SIZE);
+	MPI_Gather(host, HOST_SIZE, MPI_CHAR, hosts, HOST_SIZE, MPI_CHAR, MASTER, MPI_COMM_WORLD);
+#else
+	g_strlcpy(host, g_get_host_name(), HOST_SIZE);
+	memcpy(hosts, host, HOST_SIZE);
+#endif
+}
+
+gboolean export_open(ExportFormat format, const gchar* path)
+{
+	exportFormat = format;
+	exportList = NULL;
+
+	if (format == EXPORT_XML) {
+		exportDoc = xml_document_new(path);
+		return exportDoc != NULL;
+	}
+
+	exportFile = g_fopen(path, "w");
+	return exportFile != NULL;
+}
+
+void export_close()
+{
+	if (exportDoc) {
+		xml_document_free(exportDoc);
+		exportDoc = NULL;
+	}
+
+	if (exportFile) {
+		fclose(exportFile);
+		exportFile = NULL;
+	}
+
+	g_free(hosts);
+	hosts = NULL;
+}
+
+
+/* JSON and CSV helpers */
+
+static void json_string(const gchar* value)
+{
+	const gchar* c;
+
+	fputc('"', exportFile);
+	for (c=value; *c; c++) {
+		if (*c == '"' || *c == '\\')
+			g_fprintf(exportFile, "\\%c", *c);
+		else if ((guchar) *c < 0x20)
+			g_fprintf(exportFile, "\\u%04x", (guchar) *c);
+		else
+			fputc(*c, exportFile);
+	}
+	fputc('"', exportFile);
+}
+
+static void json_double(const gchar* key, gdouble value)
+{
+	// JSON has no representation for nan and inf
+	if (isfinite(value))
+		g_fprintf(exportFile, ",\"%s\":%.9g", key, value);
+	else
+		g_fprintf(exportFile, ",\"%s\":null", key);
+}
+
+static void json_long(const gchar* key, glong value)
+{
+	g_fprintf(exportFile, ",\"%s\":%ld", key, value);
+}
+
+static void json_start(const gchar* type, gint rank, gint id, const gchar* name)
+{
+	g_fprintf(exportFile, "{\"type\":\"%s\"", type);
+	if (rank >= 0)
+		json_long("rank", rank);
+	json_long("id", id);
+	fputs(",\"name\":", exportFile);
+	json_string(name);
+}
+
+static void csv_string(const gchar* value)
+{
+	const gchar* c;
+
+	if (!strpbrk(value, ";\"\n")) {
+		fputs(value, exportFile);
+		return;
+	}
+
+	fputc('"', exportFile);
+	for (c=value; *c; c++) {
+		if (*c == '"')
+			fputc('"', exportFile);
+		fputc(*c, exportFile);
+	}
+	fputc('"', exportFile);
+}
+
+static void csv_row(const gchar* type, gint rank, gint id, const gchar* name, const gchar* metric, gdouble value)
+{
+	if (rank >= 0)
+		g_fprintf(exportFile, "%s;%d;%d;", type, rank, id);
+	else
+		g_fprintf(exportFile, "%s;;%d;", type, id);
+
+	csv_string(name);
+	g_fprintf(exportFile, ";%s;%.9g\n", metric, value);
+}
+
+/**
+ * Opens an EventList of the given type unless it is already open.
+ */
+static void xml_event_list(const gchar* type)
+{
+	if (exportList && strcmp(exportList, type) == 0)
+		return;
+
+	if (exportList)
+		xml_end_element(exportDoc); // <EventList>
+
+	xml_start_element(exportDoc, "EventList");
+	xml_add_attribute_string(exportDoc, "type", type);
+	exportList = type;
+}
+
+static void xml_timeline(gdouble start, gdouble end)
+{
+	xml_start_element(exportDoc, "Timeline");
+	xml_add_attribute_double(exportDoc, "start", start);
+	xml_add_attribute_double(exportDoc, "end", end);
+	xml_end_element(exportDoc);
+}
+
+
+/* run description */
+
+typedef struct {
+	const gchar* key;
+	const gchar* value;
+} Property;
+
+#ifdef HAVE_MPI
+static GPtrArray* export_hints()
+{
+	GPtrArray* hints = g_ptr_array_new();
+	gchar key[MPI_MAX_INFO_KEY + 1];
+	gchar* value;
+	int i, num, flag, initialized;
+
+	// the info object only exists after MPI_Init
+	MPI_Initialized(&initialized);
+	if (!initialized)
+		return hints;
+
+	value = g_malloc(MPI_MAX_INFO_VAL + 1);
+	MPI_Info_get_nkeys(info, &num);
+	for (i=0; i<num; i++) {
+		MPI_Info_get_nthkey(info, i, key);
+		MPI_Info_get(info, key, MPI_MAX_INFO_VAL, value, &flag);
+
+		if (flag) {
+			g_ptr_array_add(hints, g_strdup(key));
+			g_ptr_array_add(hints, g_strdup(value));
+		}
+	}
+
+	g_free(value);
+	return hints;
+}
+#endif
+
+/**
+ * Writes the run description. Must be the first record of the export and
+ * needs the hostnames collected by export_gather_hosts().
+ */
+void export_run(const gchar* kernelName, gint numParams, gchar** params)
+{
+	gchar* date = date_str();
+	gchar* time = time_str();
+	gint i;
+
+#ifdef HAVE_MPI
+	GPtrArray* hints = export_hints();
+#else
+	GPtrArray* hints = g_ptr_array_new();
+#endif
+
+	Property properties[] = {
+		{ "kernel",  kernelName },
+		{ "date",    date },
+		{ "time",    time },
+		{ "version", VERSION },
+		{ "backend", ioEngine->name },
+		{ "build",   BUILD_FLAGS },
+	};
+	gint numProperties = G_N_ELEMENTS(properties);
+
+	switch (exportFormat) {
+		case EXPORT_XML:
+			xml_start_element(exportDoc, "Report");
+			xml_add_attribute_string(exportDoc, "date", date);
+			xml_add_attribute_string(exportDoc, "time", time);
+			xml_add_attribute_int(exportDoc, "size", size);
+			xml_add_attribute_string(exportDoc, "kernel", kernelName);
+
+			xml_start_element(exportDoc, "Run");
+			xml_add_attribute_string(exportDoc, "version", VERSION);
+			xml_add_attribute_string(exportDoc, "backend", ioEngine->name);
+			xml_add_attribute_string(exportDoc, "build", BUILD_FLAGS);
+
+			for (i=0; i<numParams; i++)
+				xml_add_element_with_content(exportDoc, "Parameter", params[i]);
+
+			for (i=0; i<hints->len; i+=2) {
+				xml_start_element(exportDoc, "Hint");
+				xml_add_attribute_string(exportDoc, "key", g_ptr_array_index(hints, i));
+				xml_add_attribute_string(exportDoc, "value", g_ptr_array_index(hints, i+1));
+				xml_end_element(exportDoc);
+			}
+
+			for (i=0; hosts && i<size; i++) {
+				xml_start_element(exportDoc, "Host");
+				xml_add_attribute_int(exportDoc, "rank", i);
+				xml_add_attribute_string(exportDoc, "name", hosts + i*HOST_SIZE);
+				xml_end_element(exportDoc);
+			}
+			xml_end_element(exportDoc); // <Run>
+			break;
+
+		case EXPORT_JSONL:
+			fputs("{\"type\":\"run\"", exportFile);
+			for (i=0; i<numProperties; i++) {
+				g_fprintf(exportFile, ",\"%s\":", properties[i].key);
+				json_string(properties[i].value);
+			}
+			json_long("size", size);
+
+			fputs(",\"parameters\":[", exportFile);
+			for (i=0; i<numParams; i++) {
+				if (i) fputc(',', exportFile);
+				json_string(params[i]);
+			}
+
+			fputs("],\"hints\":{", exportFile);
+			for (i=0; i<hints->len; i+=2) {
+				if (i) fputc(',', exportFile);
+				json_string(g_ptr_array_index(hints, i));
+				fputc(':', exportFile);
+				json_string(g_ptr_array_index(hints, i+1));
+			}
+
+			fputs("},\"hosts\":[", exportFile);
+			for (i=0; hosts && i<size; i++) {
+				if (i) fputc(',', exportFile);
+				json_string(hosts + i*HOST_SIZE);
+			}
+			fputs("]}\n", exportFile);
+			break;
+
+		case EXPORT_CSV:
+			for (i=0; i<numProperties; i++)
+				g_fprintf(exportFile, "# %s: %s\n", properties[i].key, properties[i].value);
+			g_fprintf(exportFile, "# size: %d\n", size);
+
+			for (i=0; i<numParams; i++)
+				g_fprintf(exportFile, "# parameter %d: %s\n", i+1, params[i]);
+			for (i=0; i<hints->len; i+=2)
+				g_fprintf(exportFile, "# hint %s: %s\n",
+						(gchar*) g_ptr_array_index(hints, i), (gchar*) g_ptr_array_index(hints, i+1));
+			for (i=0; hosts && i<size; i++)
+				g_fprintf(exportFile, "# host %d: %s\n", i, hosts + i*HOST_SIZE);
+
+			fputs("type;rank;id;name;metric;value\n", exportFile);
+			break;
+	}
+
+	g_ptr_array_foreach(hints, (GFunc) g_free, NULL);
+	g_ptr_array_free(hints, TRUE);
+	g_free(date);
+	g_free(time);
+}
+
+
+/* events */
+
+void export_time_event(const TimeEvent* event)
+{
+	switch (exportFormat) {
+		case EXPORT_XML:
+			xml_event_list("Time");
+			xml_start_element(exportDoc, "Event");
+			xml_add_attribute_int(exportDoc, "rank", event->proc);
+			xml_add_attribute_int(exportDoc, "id", event->id);
+			xml_add_attribute_string(exportDoc, "name", event->name);
+
+			xml_start_element(exportDoc, "Walltime");
+			xml_add_attribute_double(exportDoc, "value", event->value);
+			xml_end_element(exportDoc);
+
+			xml_timeline(event->start, event->end);
+			xml_end_element(exportDoc); // <Event>
+			break;
+
+		case EXPORT_JSONL:
+			json_start("time", event->proc, event->id, event->name);
+			json_double("walltime", event->value);
+			json_double("start", event->start);
+			json_double("end", event->end);
+			fputs("}\n", exportFile);
+			break;
+
+		case EXPORT_CSV:
+			csv_row("time", event->proc, event->id, event->name, "walltime", event->value);
+			csv_row("time", event->proc, event->id, event->name, "start", event->start);
+			csv_row("time", event->proc, event->id, event->name, "end", event->end);
+			break;
+	}
+}
+
+void export_coretime_event(const CoreTimeEvent* event)
+{
+	CoreTime avgCoreTime = event->avgCoreTime;
+	CoreTime minCoreTime = event->minCoreTime;
+	CoreTime maxCoreTime = event->maxCoreTime;
+	gdouble avgTP = (avgCoreTime.time? avgCoreTime.data/avgCoreTime.time : 0);
+	gdouble minTP = (minCoreTime.time? minCoreTime.data/minCoreTime.time : 0);
+	gdouble maxTP = (maxCoreTime.time? maxCoreTime.data/maxCoreTime.time : 0);
+	gdouble avgTime = (event->numCalls? event->avgCoreTime.time/event->numCalls : 0);
+	glong ioops = (event->numCalls>0? event->numCalls/event->avgCoreTime.time : 0);
+
+	struct {
+		const gchar* metric;
+		gdouble value;
+	} rows[] = {
+		{ "throughput_avg", avgTP },
+		{ "throughput_min", minTP },
+		{ "throughput_max", maxTP },
+		{ "calltime_avg",   avgTime },
+		{ "calltime_min",   event->minCallTime },
+		{ "calltime_max",   event->maxCallTime },
+		{ "calls",          event->numCalls },
+		{ "time",           avgCoreTime.time },
+		{ "bytes",          avgCoreTime.data },
+		{ "ioops",          ioops },
+		{ "syncs",          event->numSyncs },
+		{ "synctime",       event->syncTime },
+		{ "synctime_max",   event->maxSyncTime },
+		{ "start",          event->start },
+		{ "end",            event->end },
+	};
+	gint i;
+
+	switch (exportFormat) {
+		case EXPORT_XML:
+			xml_event_list("CoreTime");
+			xml_start_element(exportDoc, "Event");
+			xml_add_attribute_int(exportDoc, "rank", event->proc);
+			xml_add_attribute_int(exportDoc, "id", event->id);
+			xml_add_attribute_string(exportDoc, "name", event->name);
+
+			xml_start_element(exportDoc, "Throughput");
+			xml_add_attribute_double(exportDoc, "avg", avgTP);
+			xml_add_attribute_double(exportDoc, "min", minTP);
+			xml_add_attribute_double(exportDoc, "max", maxTP);
+			xml_end_element(exportDoc);
+
+			xml_start_element(exportDoc, "Calltime");
+			xml_add_attribute_double(exportDoc, "avg", avgTime);
+			xml_add_attribute_double(exportDoc, "min", event->minCallTime);
+			xml_add_attribute_double(exportDoc, "max", event->maxCallTime);
+			xml_end_element(exportDoc);
+
+			xml_start_element(exportDoc, "Requests");
+			xml_add_attribute_long(exportDoc, "num", event->numCalls);
+			xml_add_attribute_double(exportDoc, "time", avgCoreTime.time);
+			xml_add_attribute_long(exportDoc, "ioops", ioops);
+			xml_end_element(exportDoc);
+
+			xml_start_element(exportDoc, "Sync");
+			xml_add_attribute_long(exportDoc, "num", event->numSyncs);
+			xml_add_attribute_double(exportDoc, "time", event->syncTime);
+			xml_add_attribute_double(exportDoc, "max", event->maxSyncTime);
+			xml_end_element(exportDoc);
+
+			xml_timeline(event->start, event->end);
+			xml_end_element(exportDoc); // <Event>
+			break;
+
+		case EXPORT_JSONL:
+			json_start("ctime", event->proc, event->id, event->name);
+			for (i=0; i<G_N_ELEMENTS(rows); i++)
+				json_double(rows[i].metric, rows[i].value);
+			fputs("}\n", exportFile);
+			break;
+
+		case EXPORT_CSV:
+			for (i=0; i<G_N_ELEMENTS(rows); i++)
+				csv_row("ctime", event->proc, event->id, event->name, rows[i].metric, rows[i].value);
+			break;
+	}
+}
+
+void export_stat_event(const StatEvent* event)
+{
+	struct {
+		const gchar* metric;
+		gdouble value;
+	} rows[] = {
+		{ "samples", event->samples },
+		{ "warmup",  event->warmup },
+		{ "mean",    event->mean },
+		{ "stddev",  event->stddev },
+		{ "median",  event->median },
+		{ "min",     event->min },
+		{ "max",     event->max },
+		{ "ci95",    event->ci },
+		{ "start",   event->start },
+		{ "end",     event->end },
+	};
+	const gchar* type = (event->core? "ctime" : "time");
+	gint i;
+
+	switch (exportFormat) {
+		case EXPORT_XML:
+			xml_event_list("Statistics");
+			xml_start_element(exportDoc, "Event");
+			xml_add_attribute_int(exportDoc, "rank", event->proc);
+			xml_add_attribute_int(exportDoc, "id", event->id);
+			xml_add_attribute_string(exportDoc, "name", event->name);
+			xml_add_attribute_string(exportDoc, "type", (event->core? "CoreTime" : "Time"));
+
+			xml_start_element(exportDoc, "Samples");
+			xml_add_attribute_long(exportDoc, "num", event->samples);
+			xml_add_attribute_long(exportDoc, "warmup", event->warmup);
+			xml_end_element(exportDoc);
+
+			xml_start_element(exportDoc, "Seconds");
+			xml_add_attribute_double(exportDoc, "mean", event->mean);
+			xml_add_attribute_double(exportDoc, "stddev", event->stddev);
+			xml_add_attribute_double(exportDoc, "median", event->median);
+			xml_add_attribute_double(exportDoc, "min", event->min);
+			xml_add_attribute_double(exportDoc, "max", event->max);
+			xml_add_attribute_double(exportDoc, "ci95", event->ci);
+			xml_end_element(exportDoc);
+
+			xml_timeline(event->start, event->end);
+			xml_end_element(exportDoc); // <Event>
+			break;
+
+		case EXPORT_JSONL:
+			json_start("stats", event->proc, event->id, event->name);
+			fputs(",\"of\":", exportFile);
+			json_string(type);
+			for (i=0; i<G_N_ELEMENTS(rows); i++)
+				json_double(rows[i].metric, rows[i].value);
+			fputs("}\n", exportFile);
+			break;
+
+		case EXPORT_CSV:
+			for (i=0; i<G_N_ELEMENTS(rows); i++)
+				csv_row((event->core? "stats_ctime" : "stats_time"), event->proc, event->id,
+						event->name, rows[i].metric, rows[i].value);
+			break;
+	}
+}
+
+void export_phase_event(const PhaseEvent* event)
+{
+	gint i;
+	struct {
+		const gchar* metric;
+		gdouble value;
+	} rows[] = {
+		{ "procs", event->procs },
+		{ "ops",   event->ops },
+		{ "bytes", event->data },
+		{ "min",   event->minTime },
+		{ "max",   event->maxTime },
+	};
+
+	switch (exportFormat) {
+		case EXPORT_XML:
+			xml_event_list("Phase");
+			xml_start_element(exportDoc, "Event");
+			xml_add_attribute_int(exportDoc, "rank", event->proc);
+			xml_add_attribute_int(exportDoc, "id", event->id);
+			xml_add_attribute_string(exportDoc, "name", event->name);
+			xml_add_attribute_string(exportDoc, "phase", event->phase);
+
+			xml_start_element(exportDoc, "Requests");
+			xml_add_attribute_int(exportDoc, "procs", event->procs);
+			xml_add_attribute_long(exportDoc, "ops", event->ops);
+			xml_add_attribute_long(exportDoc, "data", event->data);
+			xml_end_element(exportDoc);
+
+			xml_start_element(exportDoc, "Seconds");
+			xml_add_attribute_double(exportDoc, "min", event->minTime);
+			xml_add_attribute_double(exportDoc, "max", event->maxTime);
+			xml_end_element(exportDoc);
+
+			xml_end_element(exportDoc); // <Event>
+			break;
+
+		case EXPORT_JSONL:
+			json_start("phase", event->proc, event->id, event->name);
+			fputs(",\"phase\":", exportFile);
+			json_string(event->phase);
+			for (i=0; i<G_N_ELEMENTS(rows); i++)
+				json_double(rows[i].metric, rows[i].value);
+			fputs("}\n", exportFile);
+			break;
+
+		case EXPORT_CSV:
+			{
+				gchar* name = g_strdup_printf("%s/%s", event->name, event->phase);
+				for (i=0; i<G_N_ELEMENTS(rows); i++)
+					csv_row("phase", event->proc, event->id, name, rows[i].metric, rows[i].value);
+				g_free(name);
+			}
+			break;
+	}
+}
+
+/**
+ * Returns TRUE if events are written while they are gathered.
+ */
+gboolean export_streaming()
+{
+	return exportFormat != EXPORT_XML;
+}
+
+static void export_sorted(const gchar* type, GSList* events, GCompareFunc compare, GFunc write)
+{
+	GSList* list = g_slist_copy(events);
+
+	// the EventList of every type is written, even without events
+	if (exportFormat == EXPORT_XML)
+		xml_event_list(type);
+
+	list = g_slist_sort(list, compare);
+	g_slist_foreach(list, write, NULL);
+	g_slist_free(list);
+}
+
+/**
+ * Writes all gathered events of the master sorted by name, rank and id, core
+ * time events first. Used by the formats that don't stream.
+ */
+void export_events()
+{
+	export_sorted("CoreTime", coreTimeList, compare_coretime_events_full, (GFunc) export_coretime_event);
+	export_sorted("Time", timeList, compare_time_events_full, (GFunc) export_time_event);
+	export_sorted("Statistics", statList, compare_stat_events, (GFunc) export_stat_event);
+	export_sorted("Phase", phaseList, compare_phase_events, (GFunc) export_phase_event);
+}
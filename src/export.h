@@ -0,0 +1,65 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORT_H_
+#define EXPORT_H_
+
+#include "timing.h"
+#include "phases.h"
+
+#include <glib.h>
+
+/*
+ * Result export. For jsonl and csv the master writes every event to the
+ * output file as soon as it is gathered. The xml export keeps the layout of
+ * results.xml: the sorted CoreTime, Time, Statistics and Phase EventLists
+ * are written by export_events() once all events are gathered. The first
+ * record describes the run (kernel, parameters, hosts, MPI hints and build
+ * flags).
+ *
+ *   xml    one Report element with an EventList per event type
+ *   jsonl  one JSON object per line, the "type" field tells the record apart
+ *   csv    ';' separated rows type;rank;id;name;metric;value, the run
+ *          description is written as '#' comment lines
+ */
+
+typedef enum {
+	EXPORT_XML,
+	EXPORT_JSONL,
+	EXPORT_CSV
+} ExportFormat;
+
+
+gboolean     export_format_parse(const gchar* name, ExportFormat* format);
+const gchar* export_default_path(ExportFormat format);
+
+void     export_gather_hosts();
+gboolean export_open(ExportFormat format, const gchar* path);
+void     export_close();
+
+void export_run(const gchar* kernelName, gint numParams, gchar** params);
+
+gboolean export_streaming();
+void     export_events();
+
+void export_time_event(const TimeEvent* event);
+void export_coretime_event(const CoreTimeEvent* event);
+void export_stat_event(const StatEvent* event);
+void export_phase_event(const PhaseEvent* event);
+
+#endif /* EXPORT_H_ */
@@ -54,6 +54,10 @@ glong expr_evaluate_to_int(Expression* expression, ExpressionStatus* status)
 					if (status) *status = STATUS_EVAL_OK;
 					return rank;
 				}
+				else if (strcmp(varName, "$size") == 0) {
+					if (status) *status = STATUS_EVAL_OK;
+					return size;
+				}
 				else if (strstr(varName, "rand") != NULL) {
 					if (status) *status = STATUS_EVAL_OK;
 					return g_random_int();
@@ -206,6 +210,10 @@ gchar* expr_evaluate_to_string(Expression* expression, ExpressionStatus* status)
 					if (status) *status = STATUS_EVAL_OK;
 					g_string_append_printf(buffer, "%d", rank);
 				}
+				else if (strcmp(varName, "$size") == 0) {
+					if (status) *status = STATUS_EVAL_OK;
+					g_string_append_printf(buffer, "%d", size);
+				}
 				else if (strstr(varName, "rand") != NULL) {
 					if (status) *status = STATUS_EVAL_OK;
 					g_string_append_printf(buffer, "%u", g_random_int());
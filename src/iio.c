@@ -35,8 +35,12 @@ File* file_new(FileType type, gconstpointer handle)
 			break;
 #endif
 		case FILE_POSIX:
+		case FILE_DIR:
 			memcpy(& file->handle.posixfh, handle, sizeof(int));
 			break;
+		case FILE_MODULE:
+			memcpy(& file->handle.modfh, handle, sizeof(gpointer));
+			break;
 		case FILE_WIN32:
 			g_assert(FALSE);
 			break;
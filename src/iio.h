@@ -40,16 +40,34 @@ typedef union {
 	MPI_File mpifh;
 #endif
 	int posixfh;
+	gpointer modfh;			// ModuleHandle of a runtime loaded module
 } FileHandle;
 
 typedef enum {
 	FILE_STDIO, FILE_MPI,
-	FILE_POSIX, FILE_WIN32
+	FILE_POSIX, FILE_WIN32,
+	FILE_DIR,				// posix directory descriptor (*at() calls)
+	FILE_MODULE				// handle owned by a runtime loaded module
 } FileType;
 
+typedef enum {
+	SYNC_NONE,				// never sync implicitly
+	SYNC_FDATASYNC,			// fdatasync after every interval bytes written
+	SYNC_FSYNC,				// fsync after every interval write calls
+	SYNC_CLOSE				// fsync before the handle is closed
+} SyncPolicyType;
+
+typedef struct {
+	SyncPolicyType type;
+	glong interval;			// bytes (SYNC_FDATASYNC) or calls (SYNC_FSYNC)
+	glong pending;			// bytes or calls since the last sync
+} SyncPolicy;
+
 typedef struct {
 	FileHandle handle;
 	FileType type;
+	SyncPolicy sync;		// durability policy for writes on this handle
+	guint64 key;			// identifies the path in the --verify pattern
 } File;
 
 typedef struct {
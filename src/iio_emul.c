@@ -0,0 +1,529 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Emulation I/O engine (--backend=emul). Wraps the POSIX or the memfs
+ * engine and injects latencies and a bandwidth cap per operation type,
+ * so kernels and the reporting can be tested without a parallel file
+ * system. The configuration is a key file given by --emul-config:
+ *
+ *   [emul]
+ *   backend = posix          # wrapped engine: posix or memfs
+ *   seed = 1                 # latencies are reproducible per rank
+ *
+ *   [default]                # used for every key missing in a section
+ *   latency = 200            # mean latency in microseconds
+ *   jitter = 50              # spread in microseconds
+ *   distribution = normal    # constant, uniform, normal or exponential
+ *   bandwidth = 100m         # bytes per second and server, 0 = unlimited
+ *
+ *   [write]                  # open, close, read, write, sync, readdir, metadata
+ *   latency = 500
+ *
+ *   [contention]
+ *   servers = 4              # emulated servers, 0 disables contention
+ *   factor = 0.25            # latency increase per additional rank on a server
+ *
+ * The ranks of the job are spread evenly over the servers. Every rank more
+ * than one on a server increases the latency by factor and shares the
+ * server bandwidth. This is a static worst case computed once from the
+ * number of processes: it assumes that all ranks do I/O at the same time,
+ * also inside master blocks or groups where only some of them are active.
+ * The injected time is added to the core time of the call.
+ */
+
+#include "iio.h"
+#include "iio_posix.h"
+
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+typedef enum {
+	EMUL_OPEN, EMUL_CLOSE, EMUL_READ, EMUL_WRITE,
+	EMUL_SYNC, EMUL_READDIR, EMUL_META,
+	__EMUL_NUM_OPS__
+} EmulOp;
+
+typedef enum {
+	DIST_CONSTANT, DIST_UNIFORM, DIST_NORMAL, DIST_EXPONENTIAL
+} EmulDistribution;
+
+typedef struct {
+	gdouble latency;			// mean latency in seconds
+	gdouble jitter;				// spread in seconds
+	EmulDistribution distribution;
+	gdouble bandwidth;			// bytes per second and server, 0 = unlimited
+} EmulOpConfig;
+
+static const gchar* emulOpNames[__EMUL_NUM_OPS__] = {
+	"open", "close", "read", "write", "sync", "readdir", "metadata"
+};
+
+static const gchar* emulDistNames[] = {
+	"constant", "uniform", "normal", "exponential", NULL
+};
+
+static EmulOpConfig emulOps[__EMUL_NUM_OPS__];
+static const IOEngine* emulBase = &posixEngine;
+static GRand* emulRand = NULL;
+static gdouble emulWorstContention = 1.0;	// latency multiplier if all ranks do I/O
+static gint emulWorstSharing = 1;			// ranks of the job placed on a server
+
+
+static gdouble emul_parse_size(const gchar* value)
+{
+	gchar* end;
+	gdouble number = g_ascii_strtod(value, &end);
+
+	switch (g_ascii_tolower(*end)) {
+		case 'k': return number * 1024;
+		case 'm': return number * 1024 * 1024;
+		case 'g': return number * 1024 * 1024 * 1024;
+		default:  return number;
+	}
+}
+
+/**
+ * Returns the value of key in group, falling back to the [default] group.
+ */
+static gchar* emul_get(GKeyFile* config, const gchar* group, const gchar* key)
+{
+	gchar* value = g_key_file_get_string(config, group, key, NULL);
+
+	if (!value)
+		value = g_key_file_get_string(config, "default", key, NULL);
+
+	return value;
+}
+
+static gboolean emul_load_op(GKeyFile* config, EmulOp op)
+{
+	EmulOpConfig* opConfig = &emulOps[op];
+	const gchar* group = emulOpNames[op];
+	gchar* value;
+	gint i;
+
+	if ((value = emul_get(config, group, "latency")))
+		opConfig->latency = g_ascii_strtod(value, NULL) / 1e6;
+	g_free(value);
+
+	if ((value = emul_get(config, group, "jitter")))
+		opConfig->jitter = g_ascii_strtod(value, NULL) / 1e6;
+	g_free(value);
+
+	if ((value = emul_get(config, group, "bandwidth")))
+		opConfig->bandwidth = emul_parse_size(value);
+	g_free(value);
+
+	if ((value = emul_get(config, group, "distribution"))) {
+		g_strstrip(value);
+		for (i=0; emulDistNames[i] && strcmp(emulDistNames[i], value) != 0; i++);
+
+		if (!emulDistNames[i]) {
+			Warning("(Emul) Unknown distribution \"%s\" for %s", value, group);
+			g_free(value);
+			return FALSE;
+		}
+		opConfig->distribution = i;
+	}
+	g_free(value);
+
+	return TRUE;
+}
+
+/**
+ * Loads the emulation parameters. Without a configuration file the
+ * wrapped engine runs without any injection.
+ */
+gboolean iio_emul_configure(const gchar* path)
+{
+	GKeyFile* config = g_key_file_new();
+	GError* error = NULL;
+	gint seed = 1, servers = 0;
+	gdouble factor = 0;
+	gchar* backend;
+	gint op;
+
+	memset(emulOps, 0, sizeof(emulOps));
+
+	if (path && !g_key_file_load_from_file(config, path, 0, &error)) {
+		Warning("(Emul) Couldn't load \"%s\": %s", path, error->message);
+		g_error_free(error);
+		g_key_file_free(config);
+		return FALSE;
+	}
+
+	if ((backend = g_key_file_get_string(config, "emul", "backend", NULL))) {
+		g_strstrip(backend);
+		if (strcmp(backend, "memfs") == 0)
+			emulBase = &memfsEngine;
+		else if (strcmp(backend, "posix") == 0)
+			emulBase = &posixEngine;
+		else {
+			Warning("(Emul) Unknown backend \"%s\", use posix or memfs", backend);
+			g_free(backend);
+			g_key_file_free(config);
+			return FALSE;
+		}
+		g_free(backend);
+	}
+
+	if (g_key_file_has_key(config, "emul", "seed", NULL))
+		seed = g_key_file_get_integer(config, "emul", "seed", NULL);
+	if (g_key_file_has_key(config, "contention", "servers", NULL))
+		servers = g_key_file_get_integer(config, "contention", "servers", NULL);
+	if (g_key_file_has_key(config, "contention", "factor", NULL))
+		factor = g_key_file_get_double(config, "contention", "factor", NULL);
+
+	for (op=0; op<__EMUL_NUM_OPS__; op++) {
+		if (!emul_load_op(config, op)) {
+			g_key_file_free(config);
+			return FALSE;
+		}
+	}
+
+	g_key_file_free(config);
+
+	// every rank draws its own reproducible sequence
+	if (emulRand)
+		g_rand_free(emulRand);
+	emulRand = g_rand_new_with_seed(seed + rank);
+
+	emulWorstSharing = (servers > 0)? MAX(1, (size + servers - 1) / servers) : 1;
+	emulWorstContention = 1.0 + factor * (emulWorstSharing - 1);
+
+	Verbose("(Emul) %s backend, %d ranks per server, worst case contention x%.2f",
+			emulBase->name, emulWorstSharing, emulWorstContention);
+
+	return TRUE;
+}
+
+static gdouble emul_sample(const EmulOpConfig* opConfig)
+{
+	gdouble latency = opConfig->latency;
+
+	switch (opConfig->distribution) {
+		case DIST_CONSTANT:
+			break;
+		case DIST_UNIFORM:
+			latency += g_rand_double_range(emulRand, -opConfig->jitter, opConfig->jitter);
+			break;
+		case DIST_NORMAL: {
+			// Box-Muller transform
+			gdouble u1 = 1.0 - g_rand_double(emulRand);
+			gdouble u2 = g_rand_double(emulRand);
+			latency += opConfig->jitter * sqrt(-2.0 * log(u1)) * cos(2.0 * G_PI * u2);
+			break;
+		}
+		case DIST_EXPONENTIAL:
+			latency = -opConfig->latency * log(1.0 - g_rand_double(emulRand));
+			break;
+	}
+
+	return (latency > 0)? latency * emulWorstContention : 0;
+}
+
+static gdouble emul_now()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Waits for the given time. Sleeps for the bulk and spins for the last
+ * part, since sleeping alone is too coarse for microsecond latencies.
+ */
+static gdouble emul_wait(gdouble seconds)
+{
+	gdouble start = emul_now();
+	gdouble end = start + seconds;
+
+	if (seconds > 0.002) {
+		gdouble sleep = seconds - 0.001;
+		struct timespec request = { (time_t) sleep, (long) ((sleep - (time_t) sleep) * 1e9) };
+		nanosleep(&request, NULL);
+	}
+
+	while (emul_now() < end);
+
+	return emul_now() - start;
+}
+
+static IOStatus emul_inject(EmulOp op, IOStatus status)
+{
+	const EmulOpConfig* opConfig = &emulOps[op];
+	gdouble delay = 0;
+
+	if (!emulRand)
+		emulRand = g_rand_new_with_seed(1 + rank);
+
+	if (status.success) {
+		delay = emul_sample(opConfig);
+
+		// the transfer can't be faster than the share of the server bandwidth
+		if (opConfig->bandwidth > 0 && status.coreTime.data > 0) {
+			gdouble transfer = status.coreTime.data / (opConfig->bandwidth / emulWorstSharing);
+			if (transfer > status.coreTime.time)
+				delay += transfer - status.coreTime.time;
+		}
+	}
+
+	if (delay > 0) {
+		delay = emul_wait(delay);
+		status.coreTime.time += delay;
+		if (op == EMUL_SYNC)
+			status.coreTime.sync += delay;
+	}
+
+	return status;
+}
+
+static IOStatus emul_fcreat(const gchar* filename, File** file)
+{
+	return emul_inject(EMUL_OPEN, emulBase->fcreat(filename, file));
+}
+
+static IOStatus emul_fopen(const gchar* filename, const gint flags, File** file)
+{
+	return emul_inject(EMUL_OPEN, emulBase->fopen(filename, flags, file));
+}
+
+static IOStatus emul_fclose(File* file)
+{
+	return emul_inject(EMUL_CLOSE, emulBase->fclose(file));
+}
+
+static IOStatus emul_fwrite(File* file, glong amount, off_t offset)
+{
+	return emul_inject(EMUL_WRITE, emulBase->fwrite(file, amount, offset));
+}
+
+static IOStatus emul_fread(const File* file, glong amount, off_t offset)
+{
+	return emul_inject(EMUL_READ, emulBase->fread(file, amount, offset));
+}
+
+static IOStatus emul_fseek(const File* file, off_t offset, gint whence)
+{
+	return emul_inject(EMUL_META, emulBase->fseek(file, offset, whence));
+}
+
+static IOStatus emul_fsync(const File* file)
+{
+	return emul_inject(EMUL_SYNC, emulBase->fsync(file));
+}
+
+static IOStatus emul_fdatasync(const File* file)
+{
+	return emul_inject(EMUL_SYNC, emulBase->fdatasync(file));
+}
+
+static IOStatus emul_fstat(const File* file)
+{
+	return emul_inject(EMUL_META, emulBase->fstat(file));
+}
+
+static IOStatus emul_fcntl(const File* file, int cmd, glong arg)
+{
+	return emul_inject(EMUL_META, emulBase->fcntl(file, cmd, arg));
+}
+
+static IOStatus emul_fallocate(const File* file, off_t offset, off_t length, gint mode)
+{
+	return emul_inject(EMUL_META, emulBase->fallocate(file, offset, length, mode));
+}
+
+static IOStatus emul_ftruncate(const File* file, off_t length)
+{
+	return emul_inject(EMUL_META, emulBase->ftruncate(file, length));
+}
+
+static IOStatus emul_fadvise(const File* file, off_t offset, off_t length, gint advice)
+{
+	return emul_inject(EMUL_META, emulBase->fadvise(file, offset, length, advice));
+}
+
+static IOStatus emul_fsyncrange(const File* file, off_t offset, off_t length, guint flags)
+{
+	return emul_inject(EMUL_SYNC, emulBase->fsyncrange(file, offset, length, flags));
+}
+
+static IOStatus emul_write(const gchar* filename, glong amount, glong offset)
+{
+	return emul_inject(EMUL_WRITE, emulBase->write(filename, amount, offset));
+}
+
+static IOStatus emul_append(const gchar* filename, glong amount)
+{
+	return emul_inject(EMUL_WRITE, emulBase->append(filename, amount));
+}
+
+static IOStatus emul_read(const gchar* filename, glong amount, glong offset)
+{
+	return emul_inject(EMUL_READ, emulBase->read(filename, amount, offset));
+}
+
+static IOStatus emul_copy(const gchar* source, const gchar* dest, glong amount, CopyMethod method)
+{
+	IOStatus status = emul_inject(EMUL_WRITE, emulBase->copy(source, dest, amount, method));
+
+	// the data passes the client unless the copy is offloaded to the server
+	if (method != COPY_RANGE)
+		status = emul_inject(EMUL_READ, status);
+
+	return status;
+}
+
+static IOStatus emul_lookup(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->lookup(path));
+}
+
+static IOStatus emul_delete(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->delete(path));
+}
+
+static IOStatus emul_mkdir(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->mkdir(path));
+}
+
+static IOStatus emul_mkdir_all(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->mkdir_all(path));
+}
+
+static IOStatus emul_rmdir(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->rmdir(path));
+}
+
+static IOStatus emul_create(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->create(path));
+}
+
+static IOStatus emul_stat(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->stat(path));
+}
+
+static IOStatus emul_rename(const gchar* oldname, const gchar* newname)
+{
+	return emul_inject(EMUL_META, emulBase->rename(oldname, newname));
+}
+
+static IOStatus emul_link(const gchar* oldpath, const gchar* newpath)
+{
+	return emul_inject(EMUL_META, emulBase->link(oldpath, newpath));
+}
+
+static IOStatus emul_unlink(const gchar* path)
+{
+	return emul_inject(EMUL_META, emulBase->unlink(path));
+}
+
+static IOStatus emul_symlink(const gchar* oldpath, const gchar* newpath)
+{
+	return emul_inject(EMUL_META, emulBase->symlink(oldpath, newpath));
+}
+
+static IOStatus emul_chmod(const gchar* path, mode_t mode)
+{
+	return emul_inject(EMUL_META, emulBase->chmod(path, mode));
+}
+
+static IOStatus emul_chown(const gchar* path, uid_t owner, gid_t group)
+{
+	return emul_inject(EMUL_META, emulBase->chown(path, owner, group));
+}
+
+static IOStatus emul_opendir(const gchar* path, File** dir)
+{
+	return emul_inject(EMUL_OPEN, emulBase->opendir(path, dir));
+}
+
+static IOStatus emul_closedir(File* dir)
+{
+	return emul_inject(EMUL_CLOSE, emulBase->closedir(dir));
+}
+
+static IOStatus emul_readdir(const File* dir, glong bufferSize)
+{
+	return emul_inject(EMUL_READDIR, emulBase->readdir(dir, bufferSize));
+}
+
+static IOStatus emul_statat(const File* dir, const gchar* name)
+{
+	return emul_inject(EMUL_META, emulBase->statat(dir, name));
+}
+
+static IOStatus emul_createat(const File* dir, const gchar* name)
+{
+	return emul_inject(EMUL_META, emulBase->createat(dir, name));
+}
+
+static IOStatus emul_unlinkat(const File* dir, const gchar* name, gint flags)
+{
+	return emul_inject(EMUL_META, emulBase->unlinkat(dir, name, flags));
+}
+
+
+const IOEngine emulEngine = {
+	"emul",
+	emul_fcreat,
+	emul_fopen,
+	emul_fclose,
+	emul_fwrite,
+	emul_fread,
+	emul_fseek,
+	emul_fsync,
+	emul_fdatasync,
+	emul_fstat,
+	emul_fcntl,
+	emul_fallocate,
+	emul_ftruncate,
+	emul_fadvise,
+	emul_fsyncrange,
+	emul_write,
+	emul_append,
+	emul_read,
+	emul_copy,
+	emul_lookup,
+	emul_delete,
+	emul_mkdir,
+	emul_mkdir_all,
+	emul_rmdir,
+	emul_create,
+	emul_stat,
+	emul_rename,
+	emul_link,
+	emul_unlink,
+	emul_symlink,
+	emul_chmod,
+	emul_chown,
+	emul_opendir,
+	emul_closedir,
+	emul_readdir,
+	emul_statat,
+	emul_createat,
+	emul_unlinkat
+};
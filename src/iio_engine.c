@@ -0,0 +1,319 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "iio.h"
+#include "iio_posix.h"
+#include "trace.h"
+#include "verify.h"
+
+#include <string.h>
+
+const IOEngine* ioEngine = &posixEngine;
+
+static const IOEngine* engines[] = { &posixEngine, &nullEngine, &memfsEngine, &emulEngine, NULL };
+
+/**
+ * Selects the engine used by the POSIX statements. Has to be called
+ * before the kernel runs, handles of different engines must not be mixed.
+ */
+gboolean iio_engine_select(const gchar* name)
+{
+	const IOEngine** engine;
+
+	for (engine=engines; *engine; engine++) {
+		if (strcmp((*engine)->name, name) == 0) {
+			ioEngine = *engine;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+IOStatus iio_fcreat(const gchar* filename, File** file)
+{
+	IOStatus status = ioEngine->fcreat(filename, file);
+	if (status.success) {
+		(*file)->key = verify_key(filename);
+		trace_file_open(*file, filename);
+	}
+	TRACE_IO("fcreat", NULL, filename, -1, status);
+	return status;
+}
+
+IOStatus iio_fopen(const gchar* filename, const gint flags, File** file)
+{
+	IOStatus status = ioEngine->fopen(filename, flags, file);
+	if (status.success) {
+		(*file)->key = verify_key(filename);
+		trace_file_open(*file, filename);
+	}
+	TRACE_IO("fopen", NULL, filename, -1, status);
+	return status;
+}
+
+IOStatus iio_fclose(File* file)
+{
+	IOStatus status = ioEngine->fclose(file);
+	TRACE_IO("fclose", file, NULL, -1, status);
+	trace_file_close(file);
+	return status;
+}
+
+IOStatus iio_fwrite(File* file, glong amount, off_t offset)
+{
+	IOStatus status = ioEngine->fwrite(file, amount, offset);
+	TRACE_IO("fwrite", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_fread(const File* file, glong amount, off_t offset)
+{
+	IOStatus status = ioEngine->fread(file, amount, offset);
+	TRACE_IO("fread", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_fseek(const File* file, off_t offset, gint whence)
+{
+	IOStatus status = ioEngine->fseek(file, offset, whence);
+	TRACE_IO("fseek", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_fsync(const File* file)
+{
+	IOStatus status = ioEngine->fsync(file);
+	TRACE_IO("fsync", file, NULL, -1, status);
+	return status;
+}
+
+IOStatus iio_fdatasync(const File* file)
+{
+	IOStatus status = ioEngine->fdatasync(file);
+	TRACE_IO("fdatasync", file, NULL, -1, status);
+	return status;
+}
+
+IOStatus iio_fstat(const File* file)
+{
+	IOStatus status = ioEngine->fstat(file);
+	TRACE_IO("fstat", file, NULL, -1, status);
+	return status;
+}
+
+IOStatus iio_fcntl(const File* file, int cmd, glong arg)
+{
+	IOStatus status = ioEngine->fcntl(file, cmd, arg);
+	TRACE_IO("fcntl", file, NULL, -1, status);
+	return status;
+}
+
+IOStatus iio_fallocate(const File* file, off_t offset, off_t length, gint mode)
+{
+	IOStatus status = ioEngine->fallocate(file, offset, length, mode);
+	TRACE_IO("fallocate", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_ftruncate(const File* file, off_t length)
+{
+	IOStatus status = ioEngine->ftruncate(file, length);
+	TRACE_IO("ftruncate", file, NULL, length, status);
+	return status;
+}
+
+IOStatus iio_fadvise(const File* file, off_t offset, off_t length, gint advice)
+{
+	IOStatus status = ioEngine->fadvise(file, offset, length, advice);
+	TRACE_IO("fadvise", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_fsyncrange(const File* file, off_t offset, off_t length, guint flags)
+{
+	IOStatus status = ioEngine->fsyncrange(file, offset, length, flags);
+	TRACE_IO("fsyncrange", file, NULL, offset, status);
+	return status;
+}
+
+IOStatus iio_write(const gchar* filename, glong amount, glong offset)
+{
+	IOStatus status = ioEngine->write(filename, amount, offset);
+	TRACE_IO("write", NULL, filename, offset, status);
+	return status;
+}
+
+IOStatus iio_append(const gchar* filename, glong amount)
+{
+	IOStatus status = ioEngine->append(filename, amount);
+	TRACE_IO("append", NULL, filename, -1, status);
+	return status;
+}
+
+IOStatus iio_read(const gchar* filename, glong amount, glong offset)
+{
+	IOStatus status = ioEngine->read(filename, amount, offset);
+	TRACE_IO("read", NULL, filename, offset, status);
+	return status;
+}
+
+IOStatus iio_copy(const gchar* source, const gchar* dest, glong amount, CopyMethod method)
+{
+	static const gchar* names[] = { "copy", "copyrange", "sendfile", "splice" };
+
+	IOStatus status = ioEngine->copy(source, dest, amount, method);
+	TRACE_IO(names[method], NULL, source, -1, status);
+	return status;
+}
+
+IOStatus iio_lookup(const gchar* path)
+{
+	IOStatus status = ioEngine->lookup(path);
+	TRACE_IO("lookup", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_delete(const gchar* path)
+{
+	IOStatus status = ioEngine->delete(path);
+	TRACE_IO("delete", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_mkdir(const gchar* path)
+{
+	IOStatus status = ioEngine->mkdir(path);
+	TRACE_IO("mkdir", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_mkdir_all(const gchar* path)
+{
+	IOStatus status = ioEngine->mkdir_all(path);
+	TRACE_IO("mkdir_all", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_rmdir(const gchar* path)
+{
+	IOStatus status = ioEngine->rmdir(path);
+	TRACE_IO("rmdir", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_create(const gchar* path)
+{
+	IOStatus status = ioEngine->create(path);
+	TRACE_IO("create", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_stat(const gchar* path)
+{
+	IOStatus status = ioEngine->stat(path);
+	TRACE_IO("stat", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_rename(const gchar* oldname, const gchar* newname)
+{
+	IOStatus status = ioEngine->rename(oldname, newname);
+	TRACE_IO("rename", NULL, oldname, -1, status);
+	return status;
+}
+
+IOStatus iio_link(const gchar* oldpath, const gchar* newpath)
+{
+	IOStatus status = ioEngine->link(oldpath, newpath);
+	TRACE_IO("link", NULL, oldpath, -1, status);
+	return status;
+}
+
+IOStatus iio_unlink(const gchar* path)
+{
+	IOStatus status = ioEngine->unlink(path);
+	TRACE_IO("unlink", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_symlink(const gchar* oldpath, const gchar* newpath)
+{
+	IOStatus status = ioEngine->symlink(oldpath, newpath);
+	TRACE_IO("symlink", NULL, newpath, -1, status);
+	return status;
+}
+
+IOStatus iio_chmod(const gchar* path, mode_t mode)
+{
+	IOStatus status = ioEngine->chmod(path, mode);
+	TRACE_IO("chmod", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_chown(const gchar* path, uid_t owner, gid_t group)
+{
+	IOStatus status = ioEngine->chown(path, owner, group);
+	TRACE_IO("chown", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_opendir(const gchar* path, File** dir)
+{
+	IOStatus status = ioEngine->opendir(path, dir);
+	if (status.success)
+		trace_file_open(*dir, path);
+	TRACE_IO("opendir", NULL, path, -1, status);
+	return status;
+}
+
+IOStatus iio_closedir(File* dir)
+{
+	IOStatus status = ioEngine->closedir(dir);
+	TRACE_IO("closedir", dir, NULL, -1, status);
+	trace_file_close(dir);
+	return status;
+}
+
+IOStatus iio_readdir(const File* dir, glong bufferSize)
+{
+	IOStatus status = ioEngine->readdir(dir, bufferSize);
+	TRACE_IO("readdir", dir, NULL, -1, status);
+	return status;
+}
+
+IOStatus iio_statat(const File* dir, const gchar* name)
+{
+	IOStatus status = ioEngine->statat(dir, name);
+	TRACE_IO("statat", dir, name, -1, status);
+	return status;
+}
+
+IOStatus iio_createat(const File* dir, const gchar* name)
+{
+	IOStatus status = ioEngine->createat(dir, name);
+	TRACE_IO("createat", dir, name, -1, status);
+	return status;
+}
+
+IOStatus iio_unlinkat(const File* dir, const gchar* name, gint flags)
+{
+	IOStatus status = ioEngine->unlinkat(dir, name, flags);
+	TRACE_IO("unlinkat", dir, name, -1, status);
+	return status;
+}
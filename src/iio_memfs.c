@@ -0,0 +1,1063 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * In-memory I/O engine (--backend=memfs). Files, directories and links
+ * live in a per process hash table keyed by the normalized path, open
+ * handles index a descriptor table. Writes fill the file content with '0'
+ * characters and reads copy it into a scratch buffer, so transfers measure
+ * the harness overhead plus a memset or memcpy of the file data, metadata
+ * calls measure the overhead plus a hash table operation. Symbolic links
+ * are stored but not followed. MPI-IO statements are not affected.
+ */
+
+#include "iio.h"
+#include "iio_posix.h"
+
+#include <string.h>
+#include <errno.h>
+
+typedef enum {
+	MEM_FILE, MEM_DIR, MEM_SYMLINK
+} MemNodeType;
+
+typedef struct {
+	MemNodeType type;
+	GByteArray* data;		// file content
+	gchar* target;			// symlink target
+	mode_t mode;
+	uid_t uid;
+	gid_t gid;
+	gint links;				// names referring to this node
+	gint opened;			// descriptors referring to this node
+	gint entries;			// number of directory entries
+} MemNode;
+
+typedef struct {
+	MemNode* node;
+	gchar* path;			// normalized path (directory handles)
+	off_t offset;
+	gint flags;
+} MemFd;
+
+static GHashTable* memNodes = NULL;		// normalized path -> MemNode
+static GPtrArray* memFds = NULL;		// descriptor -> MemFd, NULL if unused
+
+
+static MemNode* memfs_node_new(MemNodeType type, mode_t mode)
+{
+	MemNode* node = g_malloc0(sizeof(MemNode));
+	node->type = type;
+	node->mode = mode;
+	node->uid = getuid();
+	node->gid = getgid();
+
+	if (type == MEM_FILE)
+		node->data = g_byte_array_new();
+
+	return node;
+}
+
+static void memfs_node_unref(MemNode* node)
+{
+	if (node->links > 0 || node->opened > 0)
+		return;
+
+	if (node->data)
+		g_byte_array_free(node->data, TRUE);
+	g_free(node->target);
+	g_free(node);
+}
+
+static void memfs_init()
+{
+	if (memNodes)
+		return;
+
+	memNodes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	memFds = g_ptr_array_new();
+
+	// the relative and the absolute root always exist
+	MemNode* root = memfs_node_new(MEM_DIR, 0755);
+	MemNode* cwd = memfs_node_new(MEM_DIR, 0755);
+	root->links = cwd->links = 1;
+	g_hash_table_insert(memNodes, g_strdup("/"), root);
+	g_hash_table_insert(memNodes, g_strdup(""), cwd);
+}
+
+/**
+ * Removes "." components, duplicate slashes and resolves "..". Relative
+ * paths are kept relative, the result has to be freed.
+ */
+static gchar* memfs_path(const gchar* path)
+{
+	gchar** parts = g_strsplit(path, "/", -1);
+	GPtrArray* stack = g_ptr_array_new();
+	GString* result = g_string_new(path[0] == '/'? "/" : "");
+	gchar** part;
+	guint i;
+
+	for (part=parts; *part; part++) {
+		if (**part == '\0' || strcmp(*part, ".") == 0)
+			continue;
+		else if (strcmp(*part, "..") == 0) {
+			if (stack->len > 0)
+				g_ptr_array_remove_index(stack, stack->len-1);
+		}
+		else
+			g_ptr_array_add(stack, *part);
+	}
+
+	for (i=0; i<stack->len; i++) {
+		if (i > 0)
+			g_string_append_c(result, '/');
+		g_string_append(result, g_ptr_array_index(stack, i));
+	}
+
+	g_ptr_array_free(stack, TRUE);
+	g_strfreev(parts);
+
+	return g_string_free(result, FALSE);
+}
+
+/**
+ * Returns the normalized parent of a normalized path.
+ */
+static gchar* memfs_parent(const gchar* path)
+{
+	const gchar* slash = strrchr(path, '/');
+
+	if (!slash)
+		return g_strdup("");
+	else if (slash == path)
+		return g_strdup("/");
+	else
+		return g_strndup(path, slash - path);
+}
+
+static gboolean memfs_is_root(const gchar* path)
+{
+	return (path[0] == '\0' || strcmp(path, "/") == 0);
+}
+
+static MemNode* memfs_lookup(const gchar* path)
+{
+	return g_hash_table_lookup(memNodes, path);
+}
+
+static MemNode* memfs_lookup_parent(const gchar* path)
+{
+	gchar* parent = memfs_parent(path);
+	MemNode* node = memfs_lookup(parent);
+	g_free(parent);
+
+	return (node && node->type == MEM_DIR)? node : NULL;
+}
+
+/**
+ * Adds a new name for node, the parent directory has to exist.
+ */
+static gboolean memfs_insert(const gchar* path, MemNode* node)
+{
+	MemNode* parent;
+
+	if (memfs_is_root(path) || memfs_lookup(path) || !(parent = memfs_lookup_parent(path)))
+		return FALSE;
+
+	node->links++;
+	parent->entries++;
+	g_hash_table_insert(memNodes, g_strdup(path), node);
+
+	return TRUE;
+}
+
+static void memfs_remove(const gchar* path)
+{
+	MemNode* node = memfs_lookup(path);
+	MemNode* parent = memfs_lookup_parent(path);
+
+	g_hash_table_remove(memNodes, path);
+	parent->entries--;
+	node->links--;
+	memfs_node_unref(node);
+}
+
+static gint memfs_fd_new(MemNode* node, const gchar* path, gint flags)
+{
+	MemFd* memfd = g_malloc0(sizeof(MemFd));
+	guint fd;
+
+	memfd->node = node;
+	memfd->path = g_strdup(path);
+	memfd->flags = flags;
+	node->opened++;
+
+	for (fd=0; fd<memFds->len; fd++) {
+		if (!g_ptr_array_index(memFds, fd)) {
+			g_ptr_array_index(memFds, fd) = memfd;
+			return fd;
+		}
+	}
+
+	g_ptr_array_add(memFds, memfd);
+	return memFds->len - 1;
+}
+
+static MemFd* memfs_fd_get(const File* file)
+{
+	g_assert(file);
+	gint fd = file->handle.posixfh;
+
+	if (fd < 0 || fd >= memFds->len)
+		return NULL;
+
+	return g_ptr_array_index(memFds, fd);
+}
+
+static gboolean memfs_fd_close(const File* file)
+{
+	MemFd* memfd = memfs_fd_get(file);
+
+	if (!memfd)
+		return FALSE;
+
+	g_ptr_array_index(memFds, file->handle.posixfh) = NULL;
+	memfd->node->opened--;
+	memfs_node_unref(memfd->node);
+	g_free(memfd->path);
+	g_free(memfd);
+
+	return TRUE;
+}
+
+/**
+ * Resizes the file content, new bytes are zeroed. The content is a
+ * GByteArray, so files can't grow beyond G_MAXUINT bytes.
+ */
+static gboolean memfs_resize(MemNode* node, off_t length)
+{
+	guint oldLength = node->data->len;
+
+	if (length < 0 || length > G_MAXUINT) {
+		Warning("(Memfs) File size %ld exceeds the limit of %u bytes", (glong) length, G_MAXUINT);
+		return FALSE;
+	}
+
+	g_byte_array_set_size(node->data, length);
+	if (length > oldLength)
+		memset(node->data->data + oldLength, 0, length - oldLength);
+	return TRUE;
+}
+
+/**
+ * Writes amount '0' characters at offset, growing the file if needed.
+ */
+static gboolean memfs_fill(MemNode* node, off_t offset, glong amount)
+{
+	if (offset + amount > node->data->len && !memfs_resize(node, offset + amount))
+		return FALSE;
+
+	memset(node->data->data + offset, '0', amount);
+	return TRUE;
+}
+
+/**
+ * Copies up to amount bytes from offset into buffer and returns the number
+ * of bytes read.
+ */
+static glong memfs_copy(MemNode* node, off_t offset, glong amount, gchar* buffer)
+{
+	if (offset >= node->data->len)
+		return 0;
+
+	if (offset + amount > node->data->len)
+		amount = node->data->len - offset;
+
+	memcpy(buffer, node->data->data + offset, amount);
+	return amount;
+}
+
+/**
+ * Opens or creates a file with open(2) semantics for the flags O_CREAT,
+ * O_EXCL, O_TRUNC, O_APPEND and the access mode.
+ */
+static MemNode* memfs_open(const gchar* path, gint flags)
+{
+	MemNode* node = memfs_lookup(path);
+
+	if (node && (flags & O_CREAT) && (flags & O_EXCL))
+		return NULL;
+
+	if (!node) {
+		if (!(flags & O_CREAT))
+			return NULL;
+
+		node = memfs_node_new(MEM_FILE, DEFAULT_OPEN_MODE);
+		if (!memfs_insert(path, node)) {
+			memfs_node_unref(node);
+			return NULL;
+		}
+	}
+
+	if (node->type != MEM_FILE)
+		return NULL;
+
+	if ((flags & O_TRUNC) && (flags & O_ACCMODE) != O_RDONLY)
+		memfs_resize(node, 0);
+
+	return node;
+}
+
+static IOStatus memfs_open_handle(const gchar* filename, gint flags, File** file)
+{
+	memfs_init();
+	gchar* path = memfs_path(filename);
+	gint fd = -1;
+
+	CORETIME_START();
+	MemNode* node = memfs_open(path, flags);
+	if (node)
+		fd = memfs_fd_new(node, path, flags);
+	CORETIME_STOP(time);
+
+	g_free(path);
+
+	if (fd != -1) {
+		*file = file_new(FILE_POSIX, &fd);
+		return iostatus_new(TRUE, time, 0);
+	}
+	else {
+		Warning("(FOpen) Couldn't open file \"%s\" with flags %d", filename, flags);
+		return iostatus_new(FALSE, time, 0);
+	}
+}
+
+static IOStatus memfs_fcreat(const gchar* filename, File** file)
+{
+	return memfs_open_handle(filename, O_WRONLY|O_CREAT|O_TRUNC, file);
+}
+
+static IOStatus memfs_fopen(const gchar* filename, const gint flags, File** file)
+{
+	return memfs_open_handle(filename, flags, file);
+}
+
+static IOStatus memfs_fclose(File* file)
+{
+	g_assert(file->type == FILE_POSIX);
+
+	CORETIME_START();
+	gboolean ret = memfs_fd_close(file);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_fwrite(File* file, glong amount, off_t offset)
+{
+	g_assert(file->type == FILE_POSIX);
+	MemFd* memfd = memfs_fd_get(file);
+
+	if (!memfd || (memfd->flags & O_ACCMODE) == O_RDONLY || amount < 0) {
+		Warning("(FWrite) Handle %d isn't open for writing", file->handle.posixfh);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (offset >= 0)
+		memfd->offset = offset;
+
+	CORETIME_START();
+	if (memfd->flags & O_APPEND)
+		memfd->offset = memfd->node->data->len;
+	gboolean success = memfs_fill(memfd->node, memfd->offset, amount);
+	if (success)
+		memfd->offset += amount;
+	CORETIME_STOP(time);
+
+	return iostatus_new(success, time, success? amount : 0);
+}
+
+static IOStatus memfs_fread(const File* file, glong amount, off_t offset)
+{
+	g_assert(file->type == FILE_POSIX);
+	MemFd* memfd = memfs_fd_get(file);
+	glong lSize, rSize;
+	gchar* buffer;
+
+	if (!memfd || (memfd->flags & O_ACCMODE) == O_WRONLY) {
+		Warning("(FRead) Handle %d isn't open for reading", file->handle.posixfh);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	// same file pointer semantics as the POSIX engine: READALL reads the
+	// file size, starting at offset if one is given
+	if (amount == READALL) {
+		lSize = memfd->node->data->len;
+		memfd->offset = 0;
+	}
+	else
+		lSize = amount;
+
+	if (offset >= 0)
+		memfd->offset = offset;
+
+	buffer = g_malloc(lSize);
+
+	CORETIME_START();
+	rSize = memfs_copy(memfd->node, memfd->offset, lSize, buffer);
+	memfd->offset += rSize;
+	CORETIME_STOP(time);
+
+	g_free(buffer);
+
+	if (rSize < lSize)
+		Warning("(FRead) Error during read! (%ld of %ld)", rSize, lSize);
+
+	return iostatus_new(rSize == lSize, time, rSize);
+}
+
+static IOStatus memfs_fseek(const File* file, off_t offset, gint whence)
+{
+	g_assert(file->type == FILE_POSIX);
+	MemFd* memfd = memfs_fd_get(file);
+	off_t position;
+
+	if (!memfd)
+		return iostatus_new(FALSE, 0, 0);
+
+	CORETIME_START();
+	switch (whence) {
+		case SEEK_SET: position = offset; break;
+		case SEEK_CUR: position = memfd->offset + offset; break;
+		case SEEK_END: position = memfd->node->data->len + offset; break;
+		default:       position = -1;
+	}
+	if (position >= 0)
+		memfd->offset = position;
+	CORETIME_STOP(time);
+
+	if (position < 0) {
+		Warning("(FSeek) Setting file pointer to offset %ld failed! (whence = %d)", (glong) offset, whence);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	return iostatus_new(TRUE, time, 0);
+}
+
+/**
+ * Checks the handle only, used for all calls without effect on memory.
+ */
+static IOStatus memfs_handle_op(const File* file)
+{
+	CORETIME_START();
+	MemFd* memfd = memfs_fd_get(file);
+	CORETIME_STOP(time);
+
+	return iostatus_new(memfd != NULL, time, 0);
+}
+
+static IOStatus memfs_fsync(const File* file)
+{
+	IOStatus status = memfs_handle_op(file);
+	status.coreTime.sync = status.coreTime.time;
+	return status;
+}
+
+static IOStatus memfs_fdatasync(const File* file)
+{
+	return memfs_fsync(file);
+}
+
+static IOStatus memfs_fstat(const File* file)
+{
+	return memfs_handle_op(file);
+}
+
+static IOStatus memfs_fcntl(const File* file, int cmd, glong arg)
+{
+	MemFd* memfd = memfs_fd_get(file);
+
+	if (memfd && cmd == F_SETFL)
+		memfd->flags = (memfd->flags & O_ACCMODE) | (arg & ~O_ACCMODE);
+
+	return memfs_handle_op(file);
+}
+
+static IOStatus memfs_fallocate(const File* file, off_t offset, off_t length, gint mode)
+{
+	MemFd* memfd = memfs_fd_get(file);
+	gboolean success = TRUE;
+
+	if (!memfd || offset < 0 || length <= 0)
+		return iostatus_new(FALSE, 0, 0);
+
+	MemNode* node = memfd->node;
+
+	CORETIME_START();
+	if (mode & FALLOC_FL_PUNCH_HOLE) {
+		if (offset < node->data->len)
+			memset(node->data->data + offset, 0, MIN(length, node->data->len - offset));
+	}
+	else {
+		if (mode & FALLOC_FL_ZERO_RANGE && offset < node->data->len)
+			memset(node->data->data + offset, 0, MIN(length, node->data->len - offset));
+		if (!(mode & FALLOC_FL_KEEP_SIZE) && offset + length > node->data->len)
+			success = memfs_resize(node, offset + length);
+	}
+	CORETIME_STOP(time);
+
+	return iostatus_new(success, time, 0);
+}
+
+static IOStatus memfs_ftruncate(const File* file, off_t length)
+{
+	MemFd* memfd = memfs_fd_get(file);
+
+	if (!memfd || length < 0)
+		return iostatus_new(FALSE, 0, 0);
+
+	CORETIME_START();
+	gboolean success = memfs_resize(memfd->node, length);
+	CORETIME_STOP(time);
+
+	return iostatus_new(success, time, 0);
+}
+
+static IOStatus memfs_fadvise(const File* file, off_t offset, off_t length, gint advice)
+{
+	return memfs_handle_op(file);
+}
+
+static IOStatus memfs_fsyncrange(const File* file, off_t offset, off_t length, guint flags)
+{
+	return memfs_handle_op(file);
+}
+
+/**
+ * Path based transfer with the open flags of the POSIX engine.
+ */
+static IOStatus memfs_transfer(const gchar* filename, gint flags, glong amount, glong offset)
+{
+	memfs_init();
+	gchar* path = memfs_path(filename);
+	MemNode* node = memfs_open(path, flags);
+	glong lSize = amount, rSize = 0;
+	gchar* buffer = NULL;
+
+	g_free(path);
+
+	if (!node) {
+		Warning("(Transfer) Couldn't open \"%s\"", filename);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	// READALL reads the file size from offset, like the POSIX engine
+	if ((flags & O_ACCMODE) == O_RDONLY) {
+		if (amount == READALL)
+			lSize = node->data->len;
+		buffer = g_malloc(lSize);
+	}
+
+	if (offset < 0)
+		offset = (flags & O_APPEND)? node->data->len : 0;
+
+	CORETIME_START();
+	if (buffer)
+		rSize = memfs_copy(node, offset, lSize, buffer);
+	else
+		rSize = memfs_fill(node, offset, amount)? amount : 0;
+	CORETIME_STOP(time);
+
+	g_free(buffer);
+
+	return iostatus_new(rSize == lSize, time, rSize);
+}
+
+static IOStatus memfs_write(const gchar* filename, glong amount, glong offset)
+{
+	return memfs_transfer(filename, O_WRONLY|O_TRUNC|O_CREAT, amount, offset);
+}
+
+static IOStatus memfs_append(const gchar* filename, glong amount)
+{
+	return memfs_transfer(filename, O_WRONLY|O_APPEND|O_CREAT, amount, OFFSET_CUR);
+}
+
+static IOStatus memfs_read(const gchar* filename, glong amount, glong offset)
+{
+	return memfs_transfer(filename, O_RDONLY, amount, offset);
+}
+
+/**
+ * All copy methods are a memcpy between the file contents. Like the POSIX
+ * engine the copy always starts at the beginning of source, READALL
+ * copies all of it. Like cp(1) copying a file onto itself (the same path
+ * or another hard link) fails, truncating dest would empty the source.
+ */
+static IOStatus memfs_copyfile(const gchar* source, const gchar* dest, glong amount, CopyMethod method)
+{
+	memfs_init();
+	gchar* sourcePath = memfs_path(source);
+	gchar* destPath = memfs_path(dest);
+	MemNode* in = memfs_open(sourcePath, O_RDONLY);
+	MemNode* out = NULL;
+	glong copied = 0;
+
+	if (in && memfs_lookup(destPath) == in) {
+		Warning("(Copy) \"%s\" and \"%s\" are the same file", source, dest);
+		g_free(sourcePath);
+		g_free(destPath);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (in)
+		out = memfs_open(destPath, O_WRONLY|O_CREAT|O_TRUNC);
+
+	g_free(sourcePath);
+	g_free(destPath);
+
+	if (!in || !out) {
+		Warning("(Copy) Couldn't open \"%s\" or \"%s\"", source, dest);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (amount == READALL)
+		amount = in->data->len;
+
+	CORETIME_START();
+	copied = MIN(amount, (glong) in->data->len);
+	memfs_resize(out, copied);
+	memcpy(out->data->data, in->data->data, copied);
+	CORETIME_STOP(time);
+
+	return iostatus_new(copied == amount, time, copied);
+}
+
+/**
+ * Metadata operations on a path. Path normalization is part of the
+ * measured time since the POSIX engine does path resolution in the call.
+ */
+typedef enum {
+	MEM_LOOKUP, MEM_DELETE, MEM_MKDIR, MEM_MKDIR_ALL, MEM_RMDIR,
+	MEM_CREATE, MEM_UNLINK
+} MemOp;
+
+static gboolean memfs_path_op(const gchar* path, MemOp op)
+{
+	MemNode* node = memfs_lookup(path);
+
+	switch (op) {
+		case MEM_LOOKUP:
+			return node != NULL;
+
+		case MEM_DELETE:
+			if (node && node->type == MEM_DIR)
+				return memfs_path_op(path, MEM_RMDIR);
+			return memfs_path_op(path, MEM_UNLINK);
+
+		case MEM_MKDIR: {
+			MemNode* dir = memfs_node_new(MEM_DIR, 0700);
+			if (memfs_insert(path, dir))
+				return TRUE;
+			memfs_node_unref(dir);
+			return FALSE;
+		}
+
+		case MEM_MKDIR_ALL: {
+			gchar* parent;
+			gboolean ret;
+
+			if (node || memfs_is_root(path))
+				return (node && node->type == MEM_DIR);
+
+			parent = memfs_parent(path);
+			ret = memfs_path_op(parent, MEM_MKDIR_ALL) && memfs_path_op(path, MEM_MKDIR);
+			g_free(parent);
+			return ret;
+		}
+
+		case MEM_RMDIR:
+			if (!node || node->type != MEM_DIR || node->entries > 0 || memfs_is_root(path))
+				return FALSE;
+			memfs_remove(path);
+			return TRUE;
+
+		case MEM_CREATE:
+			return memfs_open(path, O_WRONLY|O_CREAT|O_TRUNC) != NULL;
+
+		case MEM_UNLINK:
+			if (!node || node->type == MEM_DIR)
+				return FALSE;
+			memfs_remove(path);
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static IOStatus memfs_path_status(const gchar* filename, MemOp op)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* path = memfs_path(filename);
+	gboolean ret = memfs_path_op(path, op);
+	g_free(path);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_lookup_path(const gchar* path)
+{
+	return memfs_path_status(path, MEM_LOOKUP);
+}
+
+static IOStatus memfs_delete(const gchar* path)
+{
+	return memfs_path_status(path, MEM_DELETE);
+}
+
+static IOStatus memfs_mkdir(const gchar* path)
+{
+	return memfs_path_status(path, MEM_MKDIR);
+}
+
+static IOStatus memfs_mkdir_all(const gchar* path)
+{
+	return memfs_path_status(path, MEM_MKDIR_ALL);
+}
+
+static IOStatus memfs_rmdir(const gchar* path)
+{
+	return memfs_path_status(path, MEM_RMDIR);
+}
+
+static IOStatus memfs_create(const gchar* path)
+{
+	return memfs_path_status(path, MEM_CREATE);
+}
+
+static IOStatus memfs_stat(const gchar* path)
+{
+	return memfs_path_status(path, MEM_LOOKUP);
+}
+
+static IOStatus memfs_unlink(const gchar* path)
+{
+	return memfs_path_status(path, MEM_UNLINK);
+}
+
+/**
+ * Renames a node and, for directories, every entry below it. An existing
+ * target is replaced unless it is a non-empty directory.
+ */
+static gboolean memfs_do_rename(const gchar* oldpath, const gchar* newpath)
+{
+	MemNode* node = memfs_lookup(oldpath);
+	MemNode* target = memfs_lookup(newpath);
+	gsize oldLength = strlen(oldpath);
+
+	if (!node || memfs_is_root(oldpath) || !memfs_lookup_parent(newpath))
+		return FALSE;
+
+	if (strcmp(oldpath, newpath) == 0)
+		return TRUE;
+
+	// a directory can't be moved below itself
+	if (node->type == MEM_DIR && g_str_has_prefix(newpath, oldpath) && newpath[oldLength] == '/')
+		return FALSE;
+
+	if (target) {
+		if ((target->type == MEM_DIR) != (node->type == MEM_DIR) || target->entries > 0)
+			return FALSE;
+		memfs_remove(newpath);
+	}
+
+	if (node->type == MEM_DIR) {
+		GHashTableIter iter;
+		gpointer key, value;
+		GSList* moved = NULL, *cur;
+
+		g_hash_table_iter_init(&iter, memNodes);
+		while (g_hash_table_iter_next(&iter, &key, &value)) {
+			const gchar* path = key;
+			if (strncmp(path, oldpath, oldLength) == 0 && path[oldLength] == '/')
+				moved = g_slist_prepend(moved, g_strdup(path));
+		}
+
+		for (cur=moved; cur; cur=cur->next) {
+			gchar* path = cur->data;
+			gchar* renamed = g_strconcat(newpath, path + oldLength, NULL);
+
+			MemNode* child = memfs_lookup(path);
+			g_hash_table_remove(memNodes, path);
+			g_hash_table_insert(memNodes, renamed, child);
+			g_free(path);
+		}
+		g_slist_free(moved);
+	}
+
+	memfs_lookup_parent(oldpath)->entries--;
+	memfs_lookup_parent(newpath)->entries++;
+	g_hash_table_remove(memNodes, oldpath);
+	g_hash_table_insert(memNodes, g_strdup(newpath), node);
+
+	return TRUE;
+}
+
+static IOStatus memfs_rename(const gchar* oldname, const gchar* newname)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* oldpath = memfs_path(oldname);
+	gchar* newpath = memfs_path(newname);
+	gboolean ret = memfs_do_rename(oldpath, newpath);
+	g_free(oldpath);
+	g_free(newpath);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_link(const gchar* oldname, const gchar* newname)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* oldpath = memfs_path(oldname);
+	gchar* newpath = memfs_path(newname);
+	MemNode* node = memfs_lookup(oldpath);
+	gboolean ret = (node && node->type != MEM_DIR && memfs_insert(newpath, node));
+	g_free(oldpath);
+	g_free(newpath);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_symlink(const gchar* oldpath, const gchar* newname)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* newpath = memfs_path(newname);
+	MemNode* node = memfs_node_new(MEM_SYMLINK, 0777);
+	node->target = g_strdup(oldpath);
+	gboolean ret = memfs_insert(newpath, node);
+	if (!ret)
+		memfs_node_unref(node);
+	g_free(newpath);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_chmod(const gchar* filename, mode_t mode)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* path = memfs_path(filename);
+	MemNode* node = memfs_lookup(path);
+	if (node)
+		node->mode = mode;
+	g_free(path);
+	CORETIME_STOP(time);
+
+	return iostatus_new(node != NULL, time, 0);
+}
+
+static IOStatus memfs_chown(const gchar* filename, uid_t owner, gid_t group)
+{
+	memfs_init();
+
+	CORETIME_START();
+	gchar* path = memfs_path(filename);
+	MemNode* node = memfs_lookup(path);
+	if (node) {
+		if (owner != (uid_t) -1) node->uid = owner;
+		if (group != (gid_t) -1) node->gid = group;
+	}
+	g_free(path);
+	CORETIME_STOP(time);
+
+	return iostatus_new(node != NULL, time, 0);
+}
+
+static IOStatus memfs_opendir(const gchar* dirname, File** dir)
+{
+	memfs_init();
+	gint fd = -1;
+
+	CORETIME_START();
+	gchar* path = memfs_path(dirname);
+	MemNode* node = memfs_lookup(path);
+	if (node && node->type == MEM_DIR)
+		fd = memfs_fd_new(node, path, O_RDONLY|O_DIRECTORY);
+	g_free(path);
+	CORETIME_STOP(time);
+
+	if (fd != -1) {
+		*dir = file_new(FILE_DIR, &fd);
+		return iostatus_new(TRUE, time, 0);
+	}
+	else {
+		Warning("(OpenDir) Couldn't open directory \"%s\"", dirname);
+		return iostatus_new(FALSE, time, 0);
+	}
+}
+
+static IOStatus memfs_closedir(File* dir)
+{
+	g_assert(dir->type == FILE_DIR);
+
+	CORETIME_START();
+	gboolean ret = memfs_fd_close(dir);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+/**
+ * Lists the entries of a directory. Data processed is the size the
+ * entries would take as linux_dirent64 records, like the POSIX engine.
+ */
+static IOStatus memfs_readdir(const File* dir, glong bufferSize)
+{
+	g_assert(dir->type == FILE_DIR);
+	MemFd* memfd = memfs_fd_get(dir);
+	GHashTableIter iter;
+	gpointer key, value;
+	glong total = 0;
+
+	if (!memfd || bufferSize <= 0)
+		return iostatus_new(FALSE, 0, 0);
+
+	CORETIME_START();
+	g_hash_table_iter_init(&iter, memNodes);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		const gchar* path = key;
+		gchar* parent;
+
+		if (memfs_is_root(path))
+			continue;
+
+		parent = memfs_parent(path);
+		if (strcmp(parent, memfd->path) == 0) {
+			const gchar* name = strrchr(path, '/');
+			name = name? name+1 : path;
+			// d_ino, d_off, d_reclen, d_type and the name, 8 byte aligned
+			total += (19 + strlen(name) + 1 + 7) & ~7;
+		}
+		g_free(parent);
+	}
+	CORETIME_STOP(time);
+
+	return iostatus_new(TRUE, time, total);
+}
+
+static gchar* memfs_path_at(const File* dir, const gchar* name)
+{
+	MemFd* memfd = memfs_fd_get(dir);
+	gchar* joined;
+	gchar* path;
+
+	if (!memfd)
+		return NULL;
+
+	if (name[0] == '/')
+		return memfs_path(name);
+
+	joined = g_strconcat(memfd->path, "/", name, NULL);
+	path = memfs_path(joined[0] == '/' && memfd->path[0] == '\0'? joined+1 : joined);
+	g_free(joined);
+
+	return path;
+}
+
+static IOStatus memfs_at_status(const File* dir, const gchar* name, MemOp op)
+{
+	g_assert(dir->type == FILE_DIR);
+
+	CORETIME_START();
+	gchar* path = memfs_path_at(dir, name);
+	gboolean ret = (path && memfs_path_op(path, op));
+	g_free(path);
+	CORETIME_STOP(time);
+
+	return iostatus_new(ret, time, 0);
+}
+
+static IOStatus memfs_statat(const File* dir, const gchar* name)
+{
+	return memfs_at_status(dir, name, MEM_LOOKUP);
+}
+
+static IOStatus memfs_createat(const File* dir, const gchar* name)
+{
+	return memfs_at_status(dir, name, MEM_CREATE);
+}
+
+static IOStatus memfs_unlinkat(const File* dir, const gchar* name, gint flags)
+{
+	return memfs_at_status(dir, name, (flags & AT_REMOVEDIR)? MEM_RMDIR : MEM_UNLINK);
+}
+
+
+const IOEngine memfsEngine = {
+	"memfs",
+	memfs_fcreat,
+	memfs_fopen,
+	memfs_fclose,
+	memfs_fwrite,
+	memfs_fread,
+	memfs_fseek,
+	memfs_fsync,
+	memfs_fdatasync,
+	memfs_fstat,
+	memfs_fcntl,
+	memfs_fallocate,
+	memfs_ftruncate,
+	memfs_fadvise,
+	memfs_fsyncrange,
+	memfs_write,
+	memfs_append,
+	memfs_read,
+	memfs_copyfile,
+	memfs_lookup_path,
+	memfs_delete,
+	memfs_mkdir,
+	memfs_mkdir_all,
+	memfs_rmdir,
+	memfs_create,
+	memfs_stat,
+	memfs_rename,
+	memfs_link,
+	memfs_unlink,
+	memfs_symlink,
+	memfs_chmod,
+	memfs_chown,
+	memfs_opendir,
+	memfs_closedir,
+	memfs_readdir,
+	memfs_statat,
+	memfs_createat,
+	memfs_unlinkat
+};
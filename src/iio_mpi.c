@@ -18,27 +18,209 @@
 
 #include "iio.h"
 #include "iio_mpi.h"
+#include "verify.h"
+#include "content.h"
+
+#include <string.h>
 
 #ifdef HAVE_MPI
 
-gboolean iio_pfopen(const gchar* filename, const gchar* mode, MPI_Comm comm, File** file)
+/*
+ * The elements of all patterns are contiguous in the file, so the
+ * --verify pattern is generated and checked element by element at the
+ * file offsets given by the view. The view places every process on the
+ * elements it wrote itself, so each element has to carry its own rank
+ * (level 4 blocks have no fixed offset and aren't checked).
+ */
+static void mpi_verify_fill(MPI_File fh, guint64 key, gchar* buffer, const Pattern* pattern)
+{
+	MPI_Offset disp;
+	gint i;
+
+	for (i = 0; i < pattern->iter; ++i) {
+		MPI_File_get_byte_offset(fh, (MPI_Offset) i * pattern->elem, &disp);
+		verify_fill(buffer + i * pattern->elem, pattern->elem, key, disp);
+	}
+}
+
+static gboolean mpi_verify_check(MPI_File fh, guint64 key, const gchar* buffer, const Pattern* pattern, gint count)
+{
+	MPI_Offset disp;
+	gboolean valid = TRUE;
+	gint i;
+
+	for (i = 0; i < pattern->iter && i * pattern->elem < count; ++i) {
+		MPI_File_get_byte_offset(fh, (MPI_Offset) i * pattern->elem, &disp);
+		if (!verify_check(buffer + i * pattern->elem, MIN(pattern->elem, count - i * pattern->elem), key, disp, rank))
+			valid = FALSE;
+	}
+
+	return valid;
+}
+
+/*
+ * Translates the pfopen mode into MPI_MODE_* flags. The mode either names
+ * the flags ("MPI_MODE_RDWR|MPI_MODE_UNIQUE_OPEN") or combines the letters
+ * c(reate), r(ead), w(rite), a(ppend), x (exclusive), u(nique open),
+ * d(elete on close) and s(equential). Without r or w the file is opened
+ * read-write and created, like pfopen always did. Returns -1 for unknown
+ * letters.
+ */
+static gint mpi_translate_mode(const gchar* mode)
+{
+	gint amode = 0;
+	gboolean read = FALSE, write = FALSE;
+	const gchar* c;
+
+	if (strstr(mode, "MPI_MODE_") != NULL) {
+		if (strstr(mode, "MPI_MODE_RDONLY") != NULL)
+			amode |= MPI_MODE_RDONLY;
+		if (strstr(mode, "MPI_MODE_WRONLY") != NULL)
+			amode |= MPI_MODE_WRONLY;
+		if (strstr(mode, "MPI_MODE_RDWR") != NULL)
+			amode |= MPI_MODE_RDWR;
+		if (strstr(mode, "MPI_MODE_CREATE") != NULL)
+			amode |= MPI_MODE_CREATE;
+		if (strstr(mode, "MPI_MODE_EXCL") != NULL)
+			amode |= MPI_MODE_EXCL;
+		if (strstr(mode, "MPI_MODE_APPEND") != NULL)
+			amode |= MPI_MODE_APPEND;
+		if (strstr(mode, "MPI_MODE_UNIQUE_OPEN") != NULL)
+			amode |= MPI_MODE_UNIQUE_OPEN;
+		if (strstr(mode, "MPI_MODE_DELETE_ON_CLOSE") != NULL)
+			amode |= MPI_MODE_DELETE_ON_CLOSE;
+		if (strstr(mode, "MPI_MODE_SEQUENTIAL") != NULL)
+			amode |= MPI_MODE_SEQUENTIAL;
+		return amode;
+	}
+
+	for (c = mode; *c; ++c) {
+		switch (*c) {
+			case 'r': read = TRUE; break;
+			case 'w': write = TRUE; break;
+			case 'c': amode |= MPI_MODE_CREATE; break;
+			case 'a': amode |= MPI_MODE_APPEND; break;
+			case 'x': amode |= MPI_MODE_EXCL; break;
+			case 'u': amode |= MPI_MODE_UNIQUE_OPEN; break;
+			case 'd': amode |= MPI_MODE_DELETE_ON_CLOSE; break;
+			case 's': amode |= MPI_MODE_SEQUENTIAL; break;
+			default: return -1;
+		}
+	}
+
+	if (read && write)
+		amode |= MPI_MODE_RDWR;
+	else if (read)
+		amode |= MPI_MODE_RDONLY;
+	else if (write)
+		amode |= MPI_MODE_WRONLY;
+	else
+		amode |= MPI_MODE_RDWR | MPI_MODE_CREATE;
+
+	return amode;
+}
+
+IOStatus iio_pfopen(const gchar* filename, const gchar* mode, MPI_Comm comm, File** file)
 {
 	MPI_File fh;
-	gint smode = MPI_MODE_RDWR | MPI_MODE_CREATE;
+	gint amode = mpi_translate_mode(mode);
+	gint ret;
 
-	MPI_ASSERT(MPI_File_open(comm, (gchar*) filename, smode, info, &fh), "PFOpen", FALSE);
+	if (amode == -1) {
+		Warning("(PFOpen) Invalid mode \"%s\"", mode);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	CORETIME_START();
+	ret = MPI_File_open(comm, (gchar*) filename, amode, info, &fh);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFOpen", FALSE)
+	if (ret != MPI_SUCCESS)
+		return iostatus_new(FALSE, time, 0);
 
 	*file = file_new(FILE_MPI, &fh);
-	return TRUE;
+	(*file)->key = verify_key(filename);
+	return iostatus_new(TRUE, time, 0);
+}
+
+IOStatus iio_pfclose(File* file)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	gint ret;
+
+	CORETIME_START();
+	ret = MPI_File_close(& file->handle.mpifh);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFClose", FALSE)
+	return iostatus_new(ret == MPI_SUCCESS, time, 0);
 }
 
-gboolean iio_pfclose(File* file)
+/* Collective: reserves size bytes of storage for the file */
+IOStatus iio_pfpreallocate(const File* file, glong size)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_MPI);
 
-	MPI_ASSERT(MPI_File_close(& file->handle.mpifh), "PFClose", FALSE);
-	return TRUE;
+	gint ret;
+
+	CORETIME_START();
+	ret = MPI_File_preallocate(file->handle.mpifh, size);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFPreallocate", FALSE)
+	return iostatus_new(ret == MPI_SUCCESS, time, 0);
+}
+
+/* Collective: truncates or extends the file to size bytes */
+IOStatus iio_pfsetsize(const File* file, glong size)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	gint ret;
+
+	CORETIME_START();
+	ret = MPI_File_set_size(file->handle.mpifh, size);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFSetSize", FALSE)
+	return iostatus_new(ret == MPI_SUCCESS, time, 0);
+}
+
+/* Collective: switches the atomic mode of all following accesses */
+IOStatus iio_pfatomic(const File* file, gboolean atomic)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	gint ret;
+
+	CORETIME_START();
+	ret = MPI_File_set_atomicity(file->handle.mpifh, atomic);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFAtomic", FALSE)
+	return iostatus_new(ret == MPI_SUCCESS, time, 0);
+}
+
+/* Collective: transfers all previous writes to the storage device */
+IOStatus iio_pfsync(const File* file)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	gint ret;
+
+	CORETIME_START();
+	ret = MPI_File_sync(file->handle.mpifh);
+	CORETIME_STOP(time);
+
+	MPI_ASSERT(ret, "PFSync", FALSE)
+	return iostatus_new(ret == MPI_SUCCESS, time, 0);
 }
 
 /* Level 0: non-collective, contiguous */
@@ -50,6 +232,7 @@ IOStatus iio_pfwrite_level0(const File* file, Pattern* pattern)
 	MPI_File fh = file->handle.mpifh;
 	MPI_Status status;
 	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -61,11 +244,16 @@ IOStatus iio_pfwrite_level0(const File* file, Pattern* pattern)
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PFWrite Level0", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PFWrite Level0", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, file->key, buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_write(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_write(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
@@ -93,6 +281,7 @@ IOStatus iio_pfwrite_level1(const File* file, Pattern* pattern)
 	MPI_File fh = file->handle.mpifh;
 	MPI_Status status;
 	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -104,11 +293,16 @@ IOStatus iio_pfwrite_level1(const File* file, Pattern* pattern)
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PFWrite Level1", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PFWrite Level1", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, file->key, buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_write_all(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_write_all(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
@@ -147,6 +341,11 @@ IOStatus iio_pfwrite_level2(const File* file, Pattern* pattern)
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PFWrite Level2", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PFWrite Level2", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, file->key, buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	MPI_File_write(fh, buffer, pattern->iter * pattern->elem, MPI_BYTE, &status);
@@ -185,6 +384,11 @@ IOStatus iio_pfwrite_level3(const File* file, Pattern* pattern)
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PFWrite Level3", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PFWrite Level3", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, file->key, buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	MPI_File_write_all(fh, buffer, pattern->iter * pattern->elem, MPI_BYTE, &status);
@@ -212,6 +416,7 @@ IOStatus iio_pfread_level0(const File* file, Pattern* pattern)
 	MPI_File fh = file->handle.mpifh;
 	MPI_Status status;
 	gint i, count = 0;
+	gint step = (verifyEnabled? pattern->elem : 0);	// without --verify all iterations share one block
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -227,16 +432,18 @@ IOStatus iio_pfread_level0(const File* file, Pattern* pattern)
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_read(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_read(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
 	}
 	CORETIME_STOP(time);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, file->key, buffer, pattern, count);
+
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PFRead Level0) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -255,6 +462,7 @@ IOStatus iio_pfread_level1(const File* file, Pattern* pattern)
 	MPI_File fh = file->handle.mpifh;
 	MPI_Status status;
 	gint i, count = 0;
+	gint step = (verifyEnabled? pattern->elem : 0);	// without --verify all iterations share one block
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -270,16 +478,18 @@ IOStatus iio_pfread_level1(const File* file, Pattern* pattern)
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_read_all(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_read_all(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
 	}
 	CORETIME_STOP(time);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, file->key, buffer, pattern, count);
+
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PFRead Level1) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -315,9 +525,11 @@ IOStatus iio_pfread_level2(const File* file, Pattern* pattern)
 	CORETIME_STOP(time);
 
 	MPI_Get_count(&status, MPI_BYTE, &count);
+
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, file->key, buffer, pattern, count);
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PFRead Level2) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -353,9 +565,11 @@ IOStatus iio_pfread_level3(const File* file, Pattern* pattern)
 	CORETIME_STOP(time);
 
 	MPI_Get_count(&status, MPI_BYTE, &count);
+
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, file->key, buffer, pattern, count);
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PFRead Level3) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -372,6 +586,7 @@ IOStatus iio_pwrite_level0(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_Status status;
 	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
 	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -384,11 +599,16 @@ IOStatus iio_pwrite_level0(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PWrite Level0", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PWrite Level0", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, verify_key(path), buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_write(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_write(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
@@ -414,6 +634,7 @@ IOStatus iio_pwrite_level1(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_Status status;
 	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
 	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -426,11 +647,16 @@ IOStatus iio_pwrite_level1(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PWrite Level1", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PWrite Level1", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, verify_key(path), buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_write_all(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_write_all(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
@@ -468,6 +694,11 @@ IOStatus iio_pwrite_level2(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PWrite Level2", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PWrite Level2", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, verify_key(path), buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	MPI_File_write(fh, buffer, pattern->iter * pattern->elem, MPI_BYTE, &status);
@@ -506,6 +737,11 @@ IOStatus iio_pwrite_level3(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), "PWrite Level3", FALSE)
 	MPI_ASSERT(MPI_File_seek(fh, 0, MPI_SEEK_SET), "PWrite Level3", FALSE)
 
+	if (verifyEnabled)
+		mpi_verify_fill(fh, verify_key(path), buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
 	// write data to file
 	CORETIME_START();
 	MPI_File_write_all(fh, buffer, pattern->iter * pattern->elem, MPI_BYTE, &status);
@@ -532,6 +768,7 @@ IOStatus iio_pread_level0(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_Status status;
 	gint mode = MPI_MODE_RDONLY;
 	gint i, count = 0;
+	gint step = (verifyEnabled? pattern->elem : 0);	// without --verify all iterations share one block
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -548,17 +785,19 @@ IOStatus iio_pread_level0(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_read(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_read(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
 	}
 	CORETIME_STOP(time);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, verify_key(path), buffer, pattern, count);
+
 	MPI_ASSERT(MPI_File_close(&fh), "PRead Level0", FALSE)
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PRead Level0) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -574,6 +813,7 @@ IOStatus iio_pread_level1(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	MPI_Status status;
 	gint mode = MPI_MODE_RDONLY;
 	gint i, count = 0;
+	gint step = (verifyEnabled? pattern->elem : 0);	// without --verify all iterations share one block
 	gchar* buffer;
 
 	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
@@ -590,17 +830,19 @@ IOStatus iio_pread_level1(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	CORETIME_START();
 	for (i = 0; i < pattern->iter; ++i) {
 		gint iterCount;
-		MPI_File_read_all(fh, buffer, pattern->elem, MPI_BYTE, &status);
+		MPI_File_read_all(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
 
 		MPI_Get_count(&status, MPI_BYTE, &iterCount);
 		count += iterCount;
 	}
 	CORETIME_STOP(time);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, verify_key(path), buffer, pattern, count);
+
 	MPI_ASSERT(MPI_File_close(&fh), "PRead Level1", FALSE)
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PRead Level1) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -635,10 +877,12 @@ IOStatus iio_pread_level2(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 
 	MPI_Get_count(&status, MPI_BYTE, &count);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, verify_key(path), buffer, pattern, count);
+
 	MPI_ASSERT(MPI_File_close(&fh), "PRead Level2", FALSE)
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PRead Level2) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -673,10 +917,12 @@ IOStatus iio_pread_level3(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 
 	MPI_Get_count(&status, MPI_BYTE, &count);
 
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, verify_key(path), buffer, pattern, count);
+
 	MPI_ASSERT(MPI_File_close(&fh), "PRead Level3", FALSE)
 	g_free(buffer);
 
-	if (count == (pattern->iter * pattern->elem)) {
+	if (valid && count == (pattern->iter * pattern->elem)) {
 		Verbose("(PRead Level3) Read %d bytes", count);
 		return iostatus_new(TRUE, time, count);
 	}
@@ -686,6 +932,480 @@ IOStatus iio_pread_level3(const gchar* path, Pattern* pattern, MPI_Comm comm) {
 	}
 }
 
+/*
+ * Levels 4 and 5 go through the shared file pointer, which all processes
+ * of the communicator advance together. Level 4 issues independent
+ * write_shared/read_shared calls in the order the processes arrive,
+ * level 5 the collective write_ordered/read_ordered calls that place the
+ * blocks in rank order. The pattern only gives the number of calls and
+ * the block size: the shared pointer requires the same view everywhere,
+ * so it is plain bytes, and setting it resets the pointer to zero.
+ */
+
+/**
+ * Block offsets of the ordered calls are known in advance, so --verify
+ * can be used with level 5. Level 4 blocks land wherever the shared
+ * pointer happens to be and can't be checked.
+ */
+static MPI_Offset mpi_ordered_offset(MPI_File fh, const Pattern* pattern, gint i)
+{
+	MPI_Group group;
+	gint groupSize, groupRank;
+
+	MPI_File_get_group(fh, &group);
+	MPI_Group_size(group, &groupSize);
+	MPI_Group_rank(group, &groupRank);
+	MPI_Group_free(&group);
+
+	return ((MPI_Offset) i * groupSize + groupRank) * pattern->elem;
+}
+
+static gboolean mpi_shared_verifiable(gint level)
+{
+	static gboolean warned = FALSE;
+
+	if (verifyEnabled && level == 4 && !warned) {
+		if (rank == MASTER)
+			Warning("Level 4 blocks have no fixed offset, they aren't verified");
+		warned = TRUE;
+	}
+
+	return verifyEnabled && level == 5;
+}
+
+static IOStatus mpi_shared_write(MPI_File fh, guint64 key, const Pattern* pattern, gint level, const gchar* name)
+{
+	MPI_Status status;
+	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
+	gboolean verifiable = mpi_shared_verifiable(level);
+	gchar* buffer;
+
+	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
+		Warning("%s: Couldn't allocate %ld bytes of memory!\n", name,
+				(pattern->iter * pattern->elem * pattern->type_size));
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native", info), name, FALSE)
+
+	if (verifiable) {
+		for (i = 0; i < pattern->iter; ++i)
+			verify_fill(buffer + i * pattern->elem, pattern->elem, key, mpi_ordered_offset(fh, pattern, i));
+	}
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
+	// write data to file
+	CORETIME_START();
+	for (i = 0; i < pattern->iter; ++i) {
+		gint iterCount;
+		if (level == 5)
+			MPI_File_write_ordered(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+		else
+			MPI_File_write_shared(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+
+		MPI_Get_count(&status, MPI_BYTE, &iterCount);
+		count += iterCount;
+	}
+	CORETIME_STOP(time);
+
+	g_free(buffer);
+
+	if (count == (pattern->iter * pattern->elem)) {
+		Verbose("(%s) Wrote %d bytes", name, count);
+		return iostatus_new(TRUE, time, count);
+	}
+	else {
+		Warning("%s: Error during write! (%d of %d)\n", name, count, (pattern->iter * pattern->elem));
+		return iostatus_new(FALSE, time, count);
+	}
+}
+
+static IOStatus mpi_shared_read(MPI_File fh, guint64 key, const Pattern* pattern, gint level, const gchar* name)
+{
+	MPI_Status status;
+	gint i, count = 0;
+	gboolean verifiable = mpi_shared_verifiable(level);
+	gint step = (verifiable? pattern->elem : 0);	// without --verify all iterations share one block
+	gboolean valid = TRUE;
+	gchar* buffer;
+
+	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
+		Warning("%s: Couldn't allocate %ld bytes of memory!\n", name,
+				(pattern->iter * pattern->elem * pattern->type_size));
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native", info), name, FALSE)
+
+	// read data from file
+	CORETIME_START();
+	for (i = 0; i < pattern->iter; ++i) {
+		gint iterCount;
+		if (level == 5)
+			MPI_File_read_ordered(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+		else
+			MPI_File_read_shared(fh, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+
+		MPI_Get_count(&status, MPI_BYTE, &iterCount);
+		count += iterCount;
+	}
+	CORETIME_STOP(time);
+
+	for (i = 0; verifiable && i < pattern->iter && i * pattern->elem < count; ++i) {
+		if (!verify_check(buffer + i * pattern->elem, MIN(pattern->elem, count - i * pattern->elem),
+				key, mpi_ordered_offset(fh, pattern, i), rank))
+			valid = FALSE;
+	}
+
+	g_free(buffer);
+
+	if (valid && count == (pattern->iter * pattern->elem)) {
+		Verbose("(%s) Read %d bytes", name, count);
+		return iostatus_new(TRUE, time, count);
+	}
+	else {
+		Warning("%s: Error during read! (%d of %d)\n", name, count, (pattern->iter * pattern->elem));
+		return iostatus_new(FALSE, time, count);
+	}
+}
+
+/* Level 4: non-collective, shared file pointer */
+IOStatus iio_pfwrite_level4(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_shared_write(file->handle.mpifh, file->key, pattern, 4, "PFWrite Level4");
+}
+
+/* Level 5: collective, shared file pointer in rank order */
+IOStatus iio_pfwrite_level5(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_shared_write(file->handle.mpifh, file->key, pattern, 5, "PFWrite Level5");
+}
+
+/* Level 4: non-collective, shared file pointer */
+IOStatus iio_pfread_level4(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_shared_read(file->handle.mpifh, file->key, pattern, 4, "PFRead Level4");
+}
+
+/* Level 5: collective, shared file pointer in rank order */
+IOStatus iio_pfread_level5(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_shared_read(file->handle.mpifh, file->key, pattern, 5, "PFRead Level5");
+}
+
+/* Level 4: non-collective, shared file pointer */
+IOStatus iio_pwrite_level4(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PWrite Level4", FALSE)
+	IOStatus status = mpi_shared_write(fh, verify_key(path), pattern, 4, "PWrite Level4");
+	MPI_ASSERT(MPI_File_close(&fh), "PWrite Level4", FALSE)
+
+	return status;
+}
+
+/* Level 5: collective, shared file pointer in rank order */
+IOStatus iio_pwrite_level5(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PWrite Level5", FALSE)
+	IOStatus status = mpi_shared_write(fh, verify_key(path), pattern, 5, "PWrite Level5");
+	MPI_ASSERT(MPI_File_close(&fh), "PWrite Level5", FALSE)
+
+	return status;
+}
+
+/* Level 4: non-collective, shared file pointer */
+IOStatus iio_pread_level4(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_RDONLY;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PRead Level4", FALSE)
+	IOStatus status = mpi_shared_read(fh, verify_key(path), pattern, 4, "PRead Level4");
+	MPI_ASSERT(MPI_File_close(&fh), "PRead Level4", FALSE)
+
+	return status;
+}
+
+/* Level 5: collective, shared file pointer in rank order */
+IOStatus iio_pread_level5(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_RDONLY;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PRead Level5", FALSE)
+	IOStatus status = mpi_shared_read(fh, verify_key(path), pattern, 5, "PRead Level5");
+	MPI_ASSERT(MPI_File_close(&fh), "PRead Level5", FALSE)
+
+	return status;
+}
+
+/*
+ * Levels 6 to 8 use explicit offsets instead of seeking the individual
+ * file pointer, the views are the same as in levels 0 to 3. Level 6
+ * issues write_at/read_at per iteration, level 7 the collective _at_all
+ * calls and level 8 a single split collective (_at_all_begin/_end) of
+ * the whole pattern with compute microseconds of busy work in between.
+ * The computation isn't part of the core time, so a core time shrinking
+ * with growing computation shows how much of the I/O was overlapped.
+ */
+static IOStatus mpi_at_write(MPI_File fh, guint64 key, const Pattern* pattern, gint level, glong compute, const gchar* name)
+{
+	MPI_Status status;
+	gint i, count = 0;
+	gint step = (verifyEnabled || contentMode != CONTENT_ZEROS)? pattern->elem : 0;	// constant buffers are reused by all iterations
+	gdouble computed = 0;
+	gchar* buffer;
+
+	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
+		Warning("%s: Couldn't allocate %ld bytes of memory!\n", name,
+				(pattern->iter * pattern->elem * pattern->type_size));
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), name, FALSE)
+
+	if (verifyEnabled)
+		mpi_verify_fill(fh, key, buffer, pattern);
+	else
+		content_fill(buffer, pattern->iter * pattern->elem);
+
+	// write data to file
+	CORETIME_START();
+	if (level == 8) {
+		MPI_File_write_at_all_begin(fh, 0, buffer, pattern->iter * pattern->elem, MPI_BYTE);
+		computed = compute_busy(compute);
+		MPI_File_write_at_all_end(fh, buffer, &status);
+
+		MPI_Get_count(&status, MPI_BYTE, &count);
+	}
+	else {
+		for (i = 0; i < pattern->iter; ++i) {
+			gint iterCount;
+			MPI_Offset offset = (MPI_Offset) i * pattern->elem;
+
+			if (level == 7)
+				MPI_File_write_at_all(fh, offset, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+			else
+				MPI_File_write_at(fh, offset, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+
+			MPI_Get_count(&status, MPI_BYTE, &iterCount);
+			count += iterCount;
+		}
+	}
+	CORETIME_STOP(time);
+
+	time -= computed;
+	g_free(buffer);
+
+	if (count == (pattern->iter * pattern->elem)) {
+		Verbose("(%s) Wrote %d bytes", name, count);
+		return iostatus_new(TRUE, time, count);
+	}
+	else {
+		Warning("%s: Error during write! (%d of %d)\n", name, count, (pattern->iter * pattern->elem));
+		return iostatus_new(FALSE, time, count);
+	}
+}
+
+static IOStatus mpi_at_read(MPI_File fh, guint64 key, const Pattern* pattern, gint level, glong compute, const gchar* name)
+{
+	MPI_Status status;
+	gint i, count = 0;
+	gint step = (verifyEnabled? pattern->elem : 0);	// without --verify all iterations share one block
+	gdouble computed = 0;
+	gchar* buffer;
+
+	if ((buffer = g_malloc0(pattern->iter * pattern->elem * pattern->type_size)) == NULL) {
+		Warning("%s: Couldn't allocate %ld bytes of memory!\n", name,
+				(pattern->iter * pattern->elem * pattern->type_size));
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	MPI_ASSERT(MPI_File_set_view(fh, 0, MPI_BYTE, pattern->datatype, "native", info), name, FALSE)
+
+	// read data from file
+	CORETIME_START();
+	if (level == 8) {
+		MPI_File_read_at_all_begin(fh, 0, buffer, pattern->iter * pattern->elem, MPI_BYTE);
+		computed = compute_busy(compute);
+		MPI_File_read_at_all_end(fh, buffer, &status);
+
+		MPI_Get_count(&status, MPI_BYTE, &count);
+	}
+	else {
+		for (i = 0; i < pattern->iter; ++i) {
+			gint iterCount;
+			MPI_Offset offset = (MPI_Offset) i * pattern->elem;
+
+			if (level == 7)
+				MPI_File_read_at_all(fh, offset, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+			else
+				MPI_File_read_at(fh, offset, buffer + i * step, pattern->elem, MPI_BYTE, &status);
+
+			MPI_Get_count(&status, MPI_BYTE, &iterCount);
+			count += iterCount;
+		}
+	}
+	CORETIME_STOP(time);
+
+	time -= computed;
+
+	gboolean valid = !verifyEnabled || mpi_verify_check(fh, key, buffer, pattern, count);
+
+	g_free(buffer);
+
+	if (valid && count == (pattern->iter * pattern->elem)) {
+		Verbose("(%s) Read %d bytes", name, count);
+		return iostatus_new(TRUE, time, count);
+	}
+	else {
+		Warning("%s: Error during read! (%d of %d)\n", name, count, (pattern->iter * pattern->elem));
+		return iostatus_new(FALSE, time, count);
+	}
+}
+
+/* Level 6: non-collective, explicit offsets */
+IOStatus iio_pfwrite_level6(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_write(file->handle.mpifh, file->key, pattern, 6, 0, "PFWrite Level6");
+}
+
+/* Level 6: non-collective, explicit offsets */
+IOStatus iio_pfread_level6(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_read(file->handle.mpifh, file->key, pattern, 6, 0, "PFRead Level6");
+}
+
+/* Level 7: collective, explicit offsets */
+IOStatus iio_pfwrite_level7(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_write(file->handle.mpifh, file->key, pattern, 7, 0, "PFWrite Level7");
+}
+
+/* Level 7: collective, explicit offsets */
+IOStatus iio_pfread_level7(const File* file, Pattern* pattern)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_read(file->handle.mpifh, file->key, pattern, 7, 0, "PFRead Level7");
+}
+
+/* Level 8: split collective, explicit offsets */
+IOStatus iio_pfwrite_level8(const File* file, Pattern* pattern, glong compute)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_write(file->handle.mpifh, file->key, pattern, 8, compute, "PFWrite Level8");
+}
+
+/* Level 8: split collective, explicit offsets */
+IOStatus iio_pfread_level8(const File* file, Pattern* pattern, glong compute)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_MPI);
+
+	return mpi_at_read(file->handle.mpifh, file->key, pattern, 8, compute, "PFRead Level8");
+}
+
+/* Level 6: non-collective, explicit offsets */
+IOStatus iio_pwrite_level6(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PWrite Level6", FALSE)
+	IOStatus status = mpi_at_write(fh, verify_key(path), pattern, 6, 0, "PWrite Level6");
+	MPI_ASSERT(MPI_File_close(&fh), "PWrite Level6", FALSE)
+
+	return status;
+}
+
+/* Level 6: non-collective, explicit offsets */
+IOStatus iio_pread_level6(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_RDONLY;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PRead Level6", FALSE)
+	IOStatus status = mpi_at_read(fh, verify_key(path), pattern, 6, 0, "PRead Level6");
+	MPI_ASSERT(MPI_File_close(&fh), "PRead Level6", FALSE)
+
+	return status;
+}
+
+/* Level 7: collective, explicit offsets */
+IOStatus iio_pwrite_level7(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PWrite Level7", FALSE)
+	IOStatus status = mpi_at_write(fh, verify_key(path), pattern, 7, 0, "PWrite Level7");
+	MPI_ASSERT(MPI_File_close(&fh), "PWrite Level7", FALSE)
+
+	return status;
+}
+
+/* Level 7: collective, explicit offsets */
+IOStatus iio_pread_level7(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_RDONLY;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PRead Level7", FALSE)
+	IOStatus status = mpi_at_read(fh, verify_key(path), pattern, 7, 0, "PRead Level7");
+	MPI_ASSERT(MPI_File_close(&fh), "PRead Level7", FALSE)
+
+	return status;
+}
+
+/* Level 8: split collective, explicit offsets */
+IOStatus iio_pwrite_level8(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_WRONLY | MPI_MODE_CREATE;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PWrite Level8", FALSE)
+	IOStatus status = mpi_at_write(fh, verify_key(path), pattern, 8, 0, "PWrite Level8");
+	MPI_ASSERT(MPI_File_close(&fh), "PWrite Level8", FALSE)
+
+	return status;
+}
+
+/* Level 8: split collective, explicit offsets */
+IOStatus iio_pread_level8(const gchar* path, Pattern* pattern, MPI_Comm comm) {
+	MPI_File fh;
+	gint mode = MPI_MODE_RDONLY;
+
+	MPI_ASSERT(MPI_File_open(comm, (gchar*)  path, mode, info, &fh), "PRead Level8", FALSE)
+	IOStatus status = mpi_at_read(fh, verify_key(path), pattern, 8, 0, "PRead Level8");
+	MPI_ASSERT(MPI_File_close(&fh), "PRead Level8", FALSE)
+
+	return status;
+}
+
 gboolean iio_pdelete(const gchar* path)
 {
 	gint rc = -1;
@@ -22,25 +22,49 @@
 #include "iio.h"
 
 #ifdef HAVE_MPI
-gboolean iio_pfopen(const gchar* filename, const gchar* mode, MPI_Comm comm, File** file);
-gboolean iio_pfclose(File* file);
+IOStatus iio_pfopen(const gchar* filename, const gchar* mode, MPI_Comm comm, File** file);
+IOStatus iio_pfclose(File* file);
+IOStatus iio_pfpreallocate(const File* file, glong size);
+IOStatus iio_pfsetsize(const File* file, glong size);
+IOStatus iio_pfatomic(const File* file, gboolean atomic);
+IOStatus iio_pfsync(const File* file);
 IOStatus iio_pfwrite_level0(const File* file, Pattern* pattern);
 IOStatus iio_pfwrite_level1(const File* file, Pattern* pattern);
 IOStatus iio_pfwrite_level2(const File* file, Pattern* pattern);
 IOStatus iio_pfwrite_level3(const File* file, Pattern* pattern);
+IOStatus iio_pfwrite_level4(const File* file, Pattern* pattern);
+IOStatus iio_pfwrite_level5(const File* file, Pattern* pattern);
+IOStatus iio_pfwrite_level6(const File* file, Pattern* pattern);
+IOStatus iio_pfwrite_level7(const File* file, Pattern* pattern);
+IOStatus iio_pfwrite_level8(const File* file, Pattern* pattern, glong compute);
 IOStatus iio_pfread_level0(const File* file, Pattern* pattern);
 IOStatus iio_pfread_level1(const File* file, Pattern* pattern);
 IOStatus iio_pfread_level2(const File* file, Pattern* pattern);
 IOStatus iio_pfread_level3(const File* file, Pattern* pattern);
+IOStatus iio_pfread_level4(const File* file, Pattern* pattern);
+IOStatus iio_pfread_level5(const File* file, Pattern* pattern);
+IOStatus iio_pfread_level6(const File* file, Pattern* pattern);
+IOStatus iio_pfread_level7(const File* file, Pattern* pattern);
+IOStatus iio_pfread_level8(const File* file, Pattern* pattern, glong compute);
 
 IOStatus iio_pwrite_level0(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pwrite_level1(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pwrite_level2(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pwrite_level3(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pwrite_level4(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pwrite_level5(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pwrite_level6(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pwrite_level7(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pwrite_level8(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pread_level0(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pread_level1(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pread_level2(const gchar* path, Pattern* pattern, MPI_Comm comm);
 IOStatus iio_pread_level3(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pread_level4(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pread_level5(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pread_level6(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pread_level7(const gchar* path, Pattern* pattern, MPI_Comm comm);
+IOStatus iio_pread_level8(const gchar* path, Pattern* pattern, MPI_Comm comm);
 
 gboolean iio_pdelete(const gchar* path);
 #endif
@@ -0,0 +1,276 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Null I/O engine (--backend=null). Every call succeeds without touching
+ * the file system, but still runs through parameter evaluation and core
+ * time accounting. The measured times are the per statement overhead of
+ * the harness itself.
+ */
+
+#include "iio.h"
+#include "iio_posix.h"
+
+static const int nullfd = -1;
+
+
+static IOStatus null_status(glong data)
+{
+	CORETIME_START();
+	CORETIME_STOP(time);
+
+	return iostatus_new(TRUE, time, data);
+}
+
+static IOStatus null_open(FileType type, File** file)
+{
+	IOStatus status = null_status(0);
+	*file = file_new(type, &nullfd);
+	return status;
+}
+
+static IOStatus null_fcreat(const gchar* filename, File** file)
+{
+	return null_open(FILE_POSIX, file);
+}
+
+static IOStatus null_fopen(const gchar* filename, const gint flags, File** file)
+{
+	return null_open(FILE_POSIX, file);
+}
+
+static IOStatus null_fclose(File* file)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fwrite(File* file, glong amount, off_t offset)
+{
+	return null_status(amount);
+}
+
+static IOStatus null_fread(const File* file, glong amount, off_t offset)
+{
+	return null_status(amount == READALL? 0 : amount);
+}
+
+static IOStatus null_fseek(const File* file, off_t offset, gint whence)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fsync(const File* file)
+{
+	IOStatus status = null_status(0);
+	status.coreTime.sync = status.coreTime.time;
+	return status;
+}
+
+static IOStatus null_fdatasync(const File* file)
+{
+	IOStatus status = null_status(0);
+	status.coreTime.sync = status.coreTime.time;
+	return status;
+}
+
+static IOStatus null_fstat(const File* file)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fcntl(const File* file, int cmd, glong arg)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fallocate(const File* file, off_t offset, off_t length, gint mode)
+{
+	return null_status(0);
+}
+
+static IOStatus null_ftruncate(const File* file, off_t length)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fadvise(const File* file, off_t offset, off_t length, gint advice)
+{
+	return null_status(0);
+}
+
+static IOStatus null_fsyncrange(const File* file, off_t offset, off_t length, guint flags)
+{
+	return null_status(0);
+}
+
+static IOStatus null_write(const gchar* filename, glong amount, glong offset)
+{
+	return null_status(amount);
+}
+
+static IOStatus null_append(const gchar* filename, glong amount)
+{
+	return null_status(amount);
+}
+
+static IOStatus null_read(const gchar* filename, glong amount, glong offset)
+{
+	return null_status(amount == READALL? 0 : amount);
+}
+
+static IOStatus null_copy(const gchar* source, const gchar* dest, glong amount, CopyMethod method)
+{
+	return null_status(amount == READALL? 0 : amount);
+}
+
+static IOStatus null_lookup(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_delete(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_mkdir(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_mkdir_all(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_rmdir(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_create(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_stat(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_rename(const gchar* oldname, const gchar* newname)
+{
+	return null_status(0);
+}
+
+static IOStatus null_link(const gchar* oldpath, const gchar* newpath)
+{
+	return null_status(0);
+}
+
+static IOStatus null_unlink(const gchar* path)
+{
+	return null_status(0);
+}
+
+static IOStatus null_symlink(const gchar* oldpath, const gchar* newpath)
+{
+	return null_status(0);
+}
+
+static IOStatus null_chmod(const gchar* path, mode_t mode)
+{
+	return null_status(0);
+}
+
+static IOStatus null_chown(const gchar* path, uid_t owner, gid_t group)
+{
+	return null_status(0);
+}
+
+static IOStatus null_opendir(const gchar* path, File** dir)
+{
+	return null_open(FILE_DIR, dir);
+}
+
+static IOStatus null_closedir(File* dir)
+{
+	return null_status(0);
+}
+
+static IOStatus null_readdir(const File* dir, glong bufferSize)
+{
+	return null_status(0);
+}
+
+static IOStatus null_statat(const File* dir, const gchar* name)
+{
+	return null_status(0);
+}
+
+static IOStatus null_createat(const File* dir, const gchar* name)
+{
+	return null_status(0);
+}
+
+static IOStatus null_unlinkat(const File* dir, const gchar* name, gint flags)
+{
+	return null_status(0);
+}
+
+
+const IOEngine nullEngine = {
+	"null",
+	null_fcreat,
+	null_fopen,
+	null_fclose,
+	null_fwrite,
+	null_fread,
+	null_fseek,
+	null_fsync,
+	null_fdatasync,
+	null_fstat,
+	null_fcntl,
+	null_fallocate,
+	null_ftruncate,
+	null_fadvise,
+	null_fsyncrange,
+	null_write,
+	null_append,
+	null_read,
+	null_copy,
+	null_lookup,
+	null_delete,
+	null_mkdir,
+	null_mkdir_all,
+	null_rmdir,
+	null_create,
+	null_stat,
+	null_rename,
+	null_link,
+	null_unlink,
+	null_symlink,
+	null_chmod,
+	null_chown,
+	null_opendir,
+	null_closedir,
+	null_readdir,
+	null_statat,
+	null_createat,
+	null_unlinkat
+};
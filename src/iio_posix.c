@@ -18,15 +18,21 @@
 
 #include "iio.h"
 #include "iio_posix.h"
+#include "verify.h"
+#include "content.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sendfile.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <string.h>
 
 /**
  * Opens a file and creates it if doesn't exist.
  */
-IOStatus iio_fcreat(const gchar* filename, File** file)
+static IOStatus posixio_fcreat(const gchar* filename, File** file)
 {
 	int fd;
 	CORETIME_START();
@@ -43,7 +49,7 @@ IOStatus iio_fcreat(const gchar* filename, File** file)
 	}
 }
 
-IOStatus iio_fopen(const gchar* filename, const gint flags, File** file)
+static IOStatus posixio_fopen(const gchar* filename, const gint flags, File** file)
 {
 	int fd;
 	CORETIME_START();
@@ -60,25 +66,79 @@ IOStatus iio_fopen(const gchar* filename, const gint flags, File** file)
 	}
 }
 
-IOStatus iio_fclose(File* file)
+static IOStatus posixio_fclose(File* file)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
 
 	gint ret;
+	gdouble sync = 0;
+	gboolean synced = TRUE;
+
+	if (file->sync.type == SYNC_CLOSE) {
+		CORETIME_START();
+		if (fsync(file->handle.posixfh) != 0) {
+			Warning("(FClose) Sync of handle %d failed", file->handle.posixfh);
+			synced = FALSE;
+		}
+		CORETIME_STOP(syncTime);
+		sync = syncTime;
+	}
+
 	CORETIME_START();
 	ret = close(file->handle.posixfh);
 	CORETIME_STOP(time);
 
-	if (ret == 0)
-		return iostatus_new(TRUE, time, 0);
-	else {
+	// the data isn't durable if the sync failed, even if close succeeded
+	IOStatus status = iostatus_new(ret == 0 && synced, time + sync, 0);
+	status.coreTime.sync = sync;
+
+	if (ret != 0)
 		Warning("(FClose) Couldn't close handle %d", file->handle.posixfh);
-		return iostatus_new(FALSE, time, 0);
+	return status;
+}
+
+/**
+ * Applies the sync policy of the handle after a write of amount bytes.
+ * Stores the time spent in the sync call in syncTime (0 if none was due)
+ * and returns FALSE if the sync failed.
+ */
+static gboolean iio_apply_sync_policy(File* file, glong amount, gdouble* syncTime)
+{
+	SyncPolicy* policy = &file->sync;
+	int ret;
+
+	*syncTime = 0;
+
+	switch (policy->type) {
+		case SYNC_FDATASYNC: policy->pending += amount; break;
+		case SYNC_FSYNC:     policy->pending++; break;
+		default:             return TRUE;
 	}
+
+	if (policy->pending < policy->interval)
+		return TRUE;
+
+	policy->pending = 0;
+
+	CORETIME_START();
+	if (policy->type == SYNC_FDATASYNC)
+		ret = fdatasync(file->handle.posixfh);
+	else
+		ret = fsync(file->handle.posixfh);
+	CORETIME_STOP(time);
+
+	*syncTime = time;
+
+	if (ret != 0) {
+		Warning("(SyncPolicy) Sync of handle %d failed", file->handle.posixfh);
+		return FALSE;
+	}
+
+	return TRUE;
 }
 
-IOStatus iio_fwrite(const File* file, glong amount, off_t offset)
+static IOStatus posixio_fwrite(File* file, glong amount, off_t offset)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
@@ -98,9 +158,15 @@ IOStatus iio_fwrite(const File* file, glong amount, off_t offset)
 
 	// allocate memory for data to write
 	if ((buffer = g_malloc0(sizeof(gchar)*amount))) {
-		glong i;
-		for (i=0; i<amount; i++)
-			buffer[i] = '0';
+		if (verifyEnabled)
+			verify_fill(buffer, amount, file->key, lseek(fd, 0, SEEK_CUR));
+		else if (contentMode != CONTENT_ZEROS)
+			content_fill(buffer, amount);
+		else {
+			glong i;
+			for (i=0; i<amount; i++)
+				buffer[i] = '0';
+		}
 
 		Verbose("(FWrite) Memory allocated for %ld bytes", amount);
 	}
@@ -120,13 +186,16 @@ IOStatus iio_fwrite(const File* file, glong amount, off_t offset)
 
 	g_free(buffer);
 
-	if (rSize == amount)
-		return iostatus_new(TRUE, time, rSize);
-	else
-		return iostatus_new(FALSE, time, rSize);
+	IOStatus status = iostatus_new(rSize == amount, time, rSize);
+	if (rSize > 0) {
+		if (!iio_apply_sync_policy(file, rSize, &status.coreTime.sync))
+			status.success = FALSE;
+		status.coreTime.time += status.coreTime.sync;
+	}
+	return status;
 }
 
-IOStatus iio_fread(const File* file, glong amount, off_t offset)
+static IOStatus posixio_fread(const File* file, glong amount, off_t offset)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
@@ -161,6 +230,7 @@ IOStatus iio_fread(const File* file, glong amount, off_t offset)
 	}
 
 	// copy the data into memory
+	off_t position = (verifyEnabled? lseek(fd, 0, SEEK_CUR) : 0);
 	CORETIME_START();
 	if ((rSize = read(fd, buffer, sizeof(gchar)*lSize)) < lSize) {
 		Warning("(FRead) Error during read! (%ld of %ld)", rSize, lSize);
@@ -169,15 +239,16 @@ IOStatus iio_fread(const File* file, glong amount, off_t offset)
 
 	Verbose("(FRead) File pointer @ %ld", lseek(fd, 0, SEEK_CUR));
 
+	gboolean valid = !verifyEnabled || rSize <= 0 || verify_check(buffer, rSize, file->key, position, VERIFY_ANY_WRITER);
 	g_free(buffer);
 
-	if (rSize == lSize)
+	if (rSize == lSize && valid)
 		return iostatus_new(TRUE, time, rSize);
 	else
 		return iostatus_new(FALSE, time, rSize);
 }
 
-IOStatus iio_fseek(const File* file, off_t offset, gint whence)
+static IOStatus posixio_fseek(const File* file, off_t offset, gint whence)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
@@ -201,7 +272,7 @@ IOStatus iio_fseek(const File* file, off_t offset, gint whence)
 	return iostatus_new(TRUE, time, 0);
 }
 
-IOStatus iio_fsync(const File* file)
+static IOStatus posixio_fsync(const File* file)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
@@ -211,13 +282,62 @@ IOStatus iio_fsync(const File* file)
 	int ret = fsync(fd);
 	CORETIME_STOP(time);
 
-	if (ret == 0)
-		return iostatus_new(TRUE, time, 0);
+	IOStatus status = iostatus_new(ret == 0, time, 0);
+	status.coreTime.sync = time;
+	return status;
+}
+
+static IOStatus posixio_fdatasync(const File* file)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+	int fd = file->handle.posixfh;
+
+	CORETIME_START();
+	int ret = fdatasync(fd);
+	CORETIME_STOP(time);
+
+	IOStatus status = iostatus_new(ret == 0, time, 0);
+	status.coreTime.sync = time;
+	return status;
+}
+
+/**
+ * Sets the durability policy of a handle. The interval is given in bytes
+ * for SYNC_FDATASYNC and in write calls for SYNC_FSYNC, it is ignored
+ * otherwise.
+ */
+void iio_set_sync_policy(File* file, SyncPolicyType type, glong interval)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+
+	file->sync.type = type;
+	file->sync.interval = interval;
+	file->sync.pending = 0;
+}
+
+/**
+ * Looks up a sync policy by its name in the scripts (none, fdatasync,
+ * fsync, close).
+ */
+gboolean iio_sync_policy_parse(const gchar* name, SyncPolicyType* type)
+{
+	if (strcmp(name, "none") == 0)
+		*type = SYNC_NONE;
+	else if (strcmp(name, "fdatasync") == 0)
+		*type = SYNC_FDATASYNC;
+	else if (strcmp(name, "fsync") == 0)
+		*type = SYNC_FSYNC;
+	else if (strcmp(name, "close") == 0)
+		*type = SYNC_CLOSE;
 	else
-		return iostatus_new(FALSE, time, 0);
+		return FALSE;
+
+	return TRUE;
 }
 
-IOStatus iio_fstat(const File* file)
+static IOStatus posixio_fstat(const File* file)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
@@ -234,14 +354,18 @@ IOStatus iio_fstat(const File* file)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_fcntl(const File* file, int cmd)
+/**
+ * Calls fcntl on the handle. The argument is passed for every command,
+ * commands without argument ignore it.
+ */
+static IOStatus posixio_fcntl(const File* file, int cmd, glong arg)
 {
 	g_assert(file);
 	g_assert(file->type == FILE_POSIX);
 	int fd = file->handle.posixfh;
 
 	CORETIME_START();
-	int ret = fcntl(fd, cmd);
+	int ret = fcntl(fd, cmd, arg);
 	CORETIME_STOP(time);
 
 	if (ret != -1)
@@ -250,7 +374,79 @@ IOStatus iio_fcntl(const File* file, int cmd)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_write(const gchar* filename, glong amount, glong offset) {
+/**
+ * Allocates (mode 0 or FALLOC_FL_KEEP_SIZE), punches (FALLOC_FL_PUNCH_HOLE)
+ * or zeroes (FALLOC_FL_ZERO_RANGE) the given range of the file.
+ */
+static IOStatus posixio_fallocate(const File* file, off_t offset, off_t length, gint mode)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+	int fd = file->handle.posixfh;
+
+	CORETIME_START();
+	int ret = fallocate(fd, mode, offset, length);
+	CORETIME_STOP(time);
+
+	if (ret == 0)
+		return iostatus_new(TRUE, time, 0);
+	else {
+		Warning("(FAllocate) Couldn't allocate %ld bytes at offset %ld with mode %d",
+				(glong) length, (glong) offset, mode);
+		return iostatus_new(FALSE, time, 0);
+	}
+}
+
+static IOStatus posixio_ftruncate(const File* file, off_t length)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+	int fd = file->handle.posixfh;
+
+	CORETIME_START();
+	int ret = ftruncate(fd, length);
+	CORETIME_STOP(time);
+
+	if (ret == 0)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+static IOStatus posixio_fadvise(const File* file, off_t offset, off_t length, gint advice)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+	int fd = file->handle.posixfh;
+
+	CORETIME_START();
+	int ret = posix_fadvise(fd, offset, length, advice);
+	CORETIME_STOP(time);
+
+	// posix_fadvise returns the error number instead of setting errno
+	if (ret == 0)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+static IOStatus posixio_fsyncrange(const File* file, off_t offset, off_t length, guint flags)
+{
+	g_assert(file);
+	g_assert(file->type == FILE_POSIX);
+	int fd = file->handle.posixfh;
+
+	CORETIME_START();
+	int ret = sync_file_range(fd, offset, length, flags);
+	CORETIME_STOP(time);
+
+	if (ret == 0)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+static IOStatus posixio_write(const gchar* filename, glong amount, glong offset) {
 	int fd;
 	gchar* buffer;
 	glong rSize;
@@ -272,9 +468,15 @@ IOStatus iio_write(const gchar* filename, glong amount, glong offset) {
 
 	// allocate memory for data to write
 	if ((buffer = g_malloc0(sizeof(gchar)*amount))) {
-		glong i;
-		for (i=0; i<amount; i++)
-			buffer[i] = '0';
+		if (verifyEnabled)
+			verify_fill(buffer, amount, verify_key(filename), lseek(fd, 0, SEEK_CUR));
+		else if (contentMode != CONTENT_ZEROS)
+			content_fill(buffer, amount);
+		else {
+			glong i;
+			for (i=0; i<amount; i++)
+				buffer[i] = '0';
+		}
 
 		Verbose("(Write) Memory allocated for %ld bytes", amount);
 	}
@@ -302,7 +504,7 @@ IOStatus iio_write(const gchar* filename, glong amount, glong offset) {
 		return iostatus_new(FALSE, time, rSize);
 }
 
-IOStatus iio_append(const gchar* filename, glong amount) {
+static IOStatus posixio_append(const gchar* filename, glong amount) {
 	int fd;
 	gchar* buffer;
 	glong rSize;
@@ -315,9 +517,16 @@ IOStatus iio_append(const gchar* filename, glong amount) {
 
 	// allocate memory for data to write
 	if ((buffer = g_malloc0(sizeof(gchar)*amount))) {
-		glong i;
-		for (i=0; i<amount; i++)
-			buffer[i] = '0';
+		// O_APPEND writes go to the end of the file
+		if (verifyEnabled)
+			verify_fill(buffer, amount, verify_key(filename), lseek(fd, 0, SEEK_END));
+		else if (contentMode != CONTENT_ZEROS)
+			content_fill(buffer, amount);
+		else {
+			glong i;
+			for (i=0; i<amount; i++)
+				buffer[i] = '0';
+		}
 
 		Verbose("(Write) Memory allocated for %ld bytes", amount);
 	}
@@ -345,7 +554,7 @@ IOStatus iio_append(const gchar* filename, glong amount) {
 		return iostatus_new(FALSE, time, rSize);
 }
 
-IOStatus iio_read(const gchar* filename, glong amount, glong offset) {
+static IOStatus posixio_read(const gchar* filename, glong amount, glong offset) {
 	int fd;
 	glong  lSize, rSize;
 	gchar* buffer;
@@ -384,6 +593,7 @@ IOStatus iio_read(const gchar* filename, glong amount, glong offset) {
 		return iostatus_new(FALSE, 0, 0);
 	}
 
+	off_t position = (verifyEnabled? lseek(fd, 0, SEEK_CUR) : 0);
 	CORETIME_START();
 	// copy the data into the memory
 	if ((rSize = read(fd, buffer, sizeof(gchar)*lSize)) < lSize) {
@@ -393,16 +603,121 @@ IOStatus iio_read(const gchar* filename, glong amount, glong offset) {
 
 	Verbose("(Read) File pointer @ %ld", lseek(fd, 0, SEEK_CUR));
 
+	gboolean valid = !verifyEnabled || rSize <= 0 || verify_check(buffer, rSize, verify_key(filename), position, VERIFY_ANY_WRITER);
 	close(fd);
 	g_free(buffer);
 
-	if (rSize == lSize)
+	if (rSize == lSize && valid)
 		return iostatus_new(TRUE, time, rSize);
 	else
 		return iostatus_new(FALSE, time, rSize);
 }
 
-IOStatus iio_lookup(const gchar* path) {
+/**
+ * Moves one chunk from in to out with the given method and returns the
+ * number of bytes copied, 0 at the end of the source or -1 on errors.
+ * The read/write loop and the pipe stage of splice may complete partially,
+ * those are finished here so a chunk is never lost.
+ */
+static ssize_t posixio_copy_chunk(int in, int out, CopyMethod method, size_t chunk, gchar* buffer, const int* pipefd)
+{
+	ssize_t rSize, done = 0, rc;
+
+	switch (method) {
+		case COPY_RANGE:
+#ifdef SYS_copy_file_range
+			return syscall(SYS_copy_file_range, in, NULL, out, NULL, chunk, 0);
+#else
+			errno = ENOSYS;
+			return -1;
+#endif
+		case COPY_SENDFILE:
+			return sendfile(out, in, NULL, chunk);
+		case COPY_SPLICE:
+			rSize = splice(in, NULL, pipefd[1], NULL, chunk, SPLICE_F_MOVE);
+			break;
+		default:
+			rSize = read(in, buffer, chunk);
+			break;
+	}
+
+	while (done < rSize) {
+		if (method == COPY_SPLICE)
+			rc = splice(pipefd[0], NULL, out, NULL, rSize - done, SPLICE_F_MOVE);
+		else
+			rc = write(out, buffer + done, rSize - done);
+
+		if (rc <= 0)
+			return -1;
+		done += rc;
+	}
+
+	return rSize;
+}
+
+/**
+ * Copies amount bytes (READALL for the whole file) from the beginning of
+ * source into dest, which is created or truncated. Only the data path
+ * differs between the methods, opening the files isn't part of the core
+ * time.
+ */
+static IOStatus posixio_copy(const gchar* source, const gchar* dest, glong amount, CopyMethod method)
+{
+	int in, out;
+	int pipefd[2] = { -1, -1 };
+	gchar* buffer = NULL;
+	glong copied = 0;
+	ssize_t rc = 0;
+
+	if ((in = open(source, O_RDONLY)) == -1) {
+		Warning("(Copy) Couldn't open \"%s\" for reading", source);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if ((out = open(dest, O_WRONLY|O_CREAT|O_TRUNC, DEFAULT_OPEN_MODE)) == -1) {
+		Warning("(Copy) Couldn't open \"%s\" for writing", dest);
+		close(in);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (amount == READALL)
+		amount = (glong) lseek(in, 0, SEEK_END);
+	lseek(in, 0, SEEK_SET);
+
+	if (method == COPY_SPLICE) {
+		if (pipe(pipefd) == -1) {
+			Warning("(Copy) Couldn't create a pipe for splice");
+			close(in);
+			close(out);
+			return iostatus_new(FALSE, 0, 0);
+		}
+		// a larger pipe saves round trips, the default size is kept on failure
+		fcntl(pipefd[1], F_SETPIPE_SZ, COPY_CHUNK_SIZE);
+	}
+	else if (method == COPY_READWRITE)
+		buffer = g_malloc(COPY_CHUNK_SIZE);
+
+	CORETIME_START();
+	while (copied < amount
+			&& (rc = posixio_copy_chunk(in, out, method, MIN(amount - copied, COPY_CHUNK_SIZE), buffer, pipefd)) > 0)
+		copied += rc;
+	CORETIME_STOP(time);
+
+	if (rc < 0)
+		Warning("(Copy) Copying \"%s\" to \"%s\" failed: %s", source, dest, g_strerror(errno));
+
+	if (pipefd[0] != -1) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+	}
+	g_free(buffer);
+	close(in);
+	close(out);
+
+	return iostatus_new(copied == amount, time, copied);
+}
+
+static IOStatus posixio_lookup(const gchar* path) {
 	CORETIME_START();
 	gint rc = g_access(path, F_OK);
 	CORETIME_STOP(time);
@@ -413,7 +728,7 @@ IOStatus iio_lookup(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_delete(const gchar* path) {
+static IOStatus posixio_delete(const gchar* path) {
 	CORETIME_START();
 	int rc = g_remove(path);
 	CORETIME_STOP(time);
@@ -424,7 +739,7 @@ IOStatus iio_delete(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_mkdir(const gchar* path) {
+static IOStatus posixio_mkdir(const gchar* path) {
 	CORETIME_START();
 	int rc = g_mkdir(path, 0700);
 	CORETIME_STOP(time);
@@ -435,7 +750,7 @@ IOStatus iio_mkdir(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_mkdir_all(const gchar* path) {
+static IOStatus posixio_mkdir_all(const gchar* path) {
 	CORETIME_START();
 	int rc = g_mkdir_with_parents(path, 0700);
 	CORETIME_STOP(time);
@@ -446,7 +761,7 @@ IOStatus iio_mkdir_all(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_rmdir(const gchar* path) {
+static IOStatus posixio_rmdir(const gchar* path) {
 	CORETIME_START();
 	int rc = g_rmdir(path);
 	CORETIME_STOP(time);
@@ -457,7 +772,7 @@ IOStatus iio_rmdir(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_create(const gchar* path) {
+static IOStatus posixio_create(const gchar* path) {
 	int fd;
 	CORETIME_START();
 	if ((fd = creat(path, 0777))) {
@@ -471,7 +786,7 @@ IOStatus iio_create(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_stat(const gchar* path) {
+static IOStatus posixio_stat(const gchar* path) {
 	struct stat finfo;
 
 	CORETIME_START();
@@ -484,7 +799,7 @@ IOStatus iio_stat(const gchar* path) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_rename(const gchar* oldname, const gchar* newname) {
+static IOStatus posixio_rename(const gchar* oldname, const gchar* newname) {
 	CORETIME_START();
 	int rc = g_rename(oldname, newname);
 	CORETIME_STOP(time);
@@ -495,7 +810,7 @@ IOStatus iio_rename(const gchar* oldname, const gchar* newname) {
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_link(const gchar* oldpath, const gchar* newpath)
+static IOStatus posixio_link(const gchar* oldpath, const gchar* newpath)
 {
 	CORETIME_START();
 	int rc = link(oldpath, newpath);
@@ -507,7 +822,7 @@ IOStatus iio_link(const gchar* oldpath, const gchar* newpath)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_unlink(const gchar* path)
+static IOStatus posixio_unlink(const gchar* path)
 {
 	CORETIME_START();
 	int rc = unlink(path);
@@ -519,7 +834,7 @@ IOStatus iio_unlink(const gchar* path)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_symlink(const gchar* oldpath, const gchar* newpath)
+static IOStatus posixio_symlink(const gchar* oldpath, const gchar* newpath)
 {
 	CORETIME_START();
 	int rc = symlink(oldpath, newpath);
@@ -531,7 +846,7 @@ IOStatus iio_symlink(const gchar* oldpath, const gchar* newpath)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_chmod(const gchar* path, mode_t mode)
+static IOStatus posixio_chmod(const gchar* path, mode_t mode)
 {
 	CORETIME_START();
 	int rc = chmod(path, mode);
@@ -543,7 +858,7 @@ IOStatus iio_chmod(const gchar* path, mode_t mode)
 		return iostatus_new(FALSE, time, 0);
 }
 
-IOStatus iio_chown(const gchar* path, uid_t owner, gid_t group)
+static IOStatus posixio_chown(const gchar* path, uid_t owner, gid_t group)
 {
 	CORETIME_START();
 	int rc = chown(path, owner, group);
@@ -554,3 +869,183 @@ IOStatus iio_chown(const gchar* path, uid_t owner, gid_t group)
 	else
 		return iostatus_new(FALSE, time, 0);
 }
+
+/**
+ * Opens a directory handle for the *at() statements. Path resolution
+ * happens only once here, so the following calls on the handle measure
+ * the per-entry cost only.
+ */
+static IOStatus posixio_opendir(const gchar* path, File** dir)
+{
+	int fd;
+	CORETIME_START();
+	fd = open(path, O_RDONLY|O_DIRECTORY);
+	CORETIME_STOP(time);
+
+	if (fd != -1) {
+		*dir = file_new(FILE_DIR, &fd);
+		return iostatus_new(TRUE, time, 0);
+	}
+	else {
+		Warning("(OpenDir) Couldn't open directory \"%s\"", path);
+		return iostatus_new(FALSE, time, 0);
+	}
+}
+
+static IOStatus posixio_closedir(File* dir)
+{
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	gint ret;
+	CORETIME_START();
+	ret = close(dir->handle.posixfh);
+	CORETIME_STOP(time);
+
+	if (ret == 0)
+		return iostatus_new(TRUE, time, 0);
+	else {
+		Warning("(CloseDir) Couldn't close handle %d", dir->handle.posixfh);
+		return iostatus_new(FALSE, time, 0);
+	}
+}
+
+/**
+ * Reads all entries of a directory with getdents64 using a buffer of
+ * bufferSize bytes. The handle is rewound first so the statement can be
+ * repeated. Data processed is the number of dirent bytes returned.
+ */
+static IOStatus posixio_readdir(const File* dir, glong bufferSize)
+{
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	int fd = dir->handle.posixfh;
+	gchar* buffer;
+	glong rSize, total = 0;
+
+	if (bufferSize <= 0) {
+		Warning("(ReadDir) Invalid buffer size %ld!", bufferSize);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (lseek(fd, 0, SEEK_SET) != 0) {
+		Warning("(ReadDir) Couldn't rewind handle %d", fd);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if (!(buffer = g_malloc(bufferSize))) {
+		Warning("(ReadDir) Couldn't allocate %ld bytes of memory!", bufferSize);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	CORETIME_START();
+	while ((rSize = syscall(SYS_getdents64, fd, buffer, bufferSize)) > 0)
+		total += rSize;
+	CORETIME_STOP(time);
+
+	g_free(buffer);
+
+	if (rSize == 0)
+		return iostatus_new(TRUE, time, total);
+	else {
+		Warning("(ReadDir) Error during getdents64 on handle %d", fd);
+		return iostatus_new(FALSE, time, total);
+	}
+}
+
+static IOStatus posixio_statat(const File* dir, const gchar* name)
+{
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	struct stat finfo;
+
+	CORETIME_START();
+	int rc = fstatat(dir->handle.posixfh, name, &finfo, 0);
+	CORETIME_STOP(time);
+
+	if (rc == 0)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+static IOStatus posixio_createat(const File* dir, const gchar* name)
+{
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	int fd;
+	CORETIME_START();
+	if ((fd = openat(dir->handle.posixfh, name, O_WRONLY|O_CREAT|O_TRUNC, DEFAULT_OPEN_MODE)) != -1) {
+		close(fd);
+	}
+	CORETIME_STOP(time);
+
+	if (fd != -1)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+/**
+ * Removes an entry relative to a directory handle. Pass AT_REMOVEDIR as
+ * flags to remove a directory.
+ */
+static IOStatus posixio_unlinkat(const File* dir, const gchar* name, gint flags)
+{
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	CORETIME_START();
+	int rc = unlinkat(dir->handle.posixfh, name, flags);
+	CORETIME_STOP(time);
+
+	if (rc == 0)
+		return iostatus_new(TRUE, time, 0);
+	else
+		return iostatus_new(FALSE, time, 0);
+}
+
+
+const IOEngine posixEngine = {
+	"posix",
+	posixio_fcreat,
+	posixio_fopen,
+	posixio_fclose,
+	posixio_fwrite,
+	posixio_fread,
+	posixio_fseek,
+	posixio_fsync,
+	posixio_fdatasync,
+	posixio_fstat,
+	posixio_fcntl,
+	posixio_fallocate,
+	posixio_ftruncate,
+	posixio_fadvise,
+	posixio_fsyncrange,
+	posixio_write,
+	posixio_append,
+	posixio_read,
+	posixio_copy,
+	posixio_lookup,
+	posixio_delete,
+	posixio_mkdir,
+	posixio_mkdir_all,
+	posixio_rmdir,
+	posixio_create,
+	posixio_stat,
+	posixio_rename,
+	posixio_link,
+	posixio_unlink,
+	posixio_symlink,
+	posixio_chmod,
+	posixio_chown,
+	posixio_opendir,
+	posixio_closedir,
+	posixio_readdir,
+	posixio_statat,
+	posixio_createat,
+	posixio_unlinkat
+};
@@ -26,22 +26,96 @@
 #include <unistd.h>
 
 #define DEFAULT_OPEN_MODE S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH
+#define COPY_CHUNK_SIZE (1024*1024)		// transfer size of the copy statements
 
+/*
+ * Data paths of the copy statements, each one is reported as its own
+ * statement.
+ */
+typedef enum {
+	COPY_READWRITE,		// read(2) and write(2) through a user buffer
+	COPY_RANGE,			// copy_file_range(2), may be reflinked or offloaded to the server
+	COPY_SENDFILE,		// sendfile(2) inside the kernel
+	COPY_SPLICE			// splice(2) through a pipe
+} CopyMethod;
+
+/*
+ * The POSIX statements are dispatched through an I/O engine, so the same
+ * kernel can run against the real file system or one of the overhead
+ * backends (--backend). The iio_* functions below call the selected one.
+ */
+typedef struct {
+	const gchar* name;
+	IOStatus (*fcreat)(const gchar* filename, File** file);
+	IOStatus (*fopen)(const gchar* filename, const gint flags, File** file);
+	IOStatus (*fclose)(File* file);
+	IOStatus (*fwrite)(File* file, glong amount, off_t offset);
+	IOStatus (*fread)(const File* file, glong amount, off_t offset);
+	IOStatus (*fseek)(const File* file, off_t offset, gint whence);
+	IOStatus (*fsync)(const File* file);
+	IOStatus (*fdatasync)(const File* file);
+	IOStatus (*fstat)(const File* file);
+	IOStatus (*fcntl)(const File* file, int cmd, glong arg);
+	IOStatus (*fallocate)(const File* file, off_t offset, off_t length, gint mode);
+	IOStatus (*ftruncate)(const File* file, off_t length);
+	IOStatus (*fadvise)(const File* file, off_t offset, off_t length, gint advice);
+	IOStatus (*fsyncrange)(const File* file, off_t offset, off_t length, guint flags);
+	IOStatus (*write)(const gchar* filename, glong amount, glong offset);
+	IOStatus (*append)(const gchar* filename, glong amount);
+	IOStatus (*read)(const gchar* filename, glong amount, glong offset);
+	IOStatus (*copy)(const gchar* source, const gchar* dest, glong amount, CopyMethod method);
+	IOStatus (*lookup)(const gchar* path);
+	IOStatus (*delete)(const gchar* path);
+	IOStatus (*mkdir)(const gchar* path);
+	IOStatus (*mkdir_all)(const gchar* path);
+	IOStatus (*rmdir)(const gchar* path);
+	IOStatus (*create)(const gchar* path);
+	IOStatus (*stat)(const gchar* path);
+	IOStatus (*rename)(const gchar* oldname, const gchar* newname);
+	IOStatus (*link)(const gchar* oldpath, const gchar* newpath);
+	IOStatus (*unlink)(const gchar* path);
+	IOStatus (*symlink)(const gchar* oldpath, const gchar* newpath);
+	IOStatus (*chmod)(const gchar* path, mode_t mode);
+	IOStatus (*chown)(const gchar* path, uid_t owner, gid_t group);
+	IOStatus (*opendir)(const gchar* path, File** dir);
+	IOStatus (*closedir)(File* dir);
+	IOStatus (*readdir)(const File* dir, glong bufferSize);
+	IOStatus (*statat)(const File* dir, const gchar* name);
+	IOStatus (*createat)(const File* dir, const gchar* name);
+	IOStatus (*unlinkat)(const File* dir, const gchar* name, gint flags);
+} IOEngine;
+
+extern const IOEngine posixEngine;		// real POSIX calls (default)
+extern const IOEngine nullEngine;		// no-ops, measures the harness overhead
+extern const IOEngine memfsEngine;		// files and directories in process memory
+extern const IOEngine emulEngine;		// posix or memfs with injected latencies
+
+extern const IOEngine* ioEngine;		// engine used by the iio_* functions
+
+gboolean iio_engine_select(const gchar* name);
+gboolean iio_emul_configure(const gchar* path);
 
 IOStatus iio_fcreat(const gchar* filename, File** file);
 IOStatus iio_fopen(const gchar* filename, const gint flags, File** file);
 IOStatus iio_fclose(File* file);
-IOStatus iio_fwrite(const File* file, glong amount, off_t offset);
+IOStatus iio_fwrite(File* file, glong amount, off_t offset);
 IOStatus iio_fread(const File* file, glong amount, off_t offset);
 IOStatus iio_fseek(const File* file, off_t offset, gint whence);
 IOStatus iio_fsync(const File* file);
-// TODO:
+IOStatus iio_fdatasync(const File* file);
+void     iio_set_sync_policy(File* file, SyncPolicyType type, glong interval);
+gboolean iio_sync_policy_parse(const gchar* name, SyncPolicyType* type);
 IOStatus iio_fstat(const File* file);
-IOStatus iio_fcntl(const File* file, int cmd);
+IOStatus iio_fcntl(const File* file, int cmd, glong arg);
+IOStatus iio_fallocate(const File* file, off_t offset, off_t length, gint mode);
+IOStatus iio_ftruncate(const File* file, off_t length);
+IOStatus iio_fadvise(const File* file, off_t offset, off_t length, gint advice);
+IOStatus iio_fsyncrange(const File* file, off_t offset, off_t length, guint flags);
 
 IOStatus iio_write(const gchar* filename, glong amount, glong offset);
 IOStatus iio_append(const gchar* filename, glong amount);
 IOStatus iio_read(const gchar* filename, glong amount, glong offset);
+IOStatus iio_copy(const gchar* source, const gchar* dest, glong amount, CopyMethod method);
 IOStatus iio_lookup(const gchar* path);
 IOStatus iio_delete(const gchar* path);
 IOStatus iio_mkdir(const gchar* path);
@@ -50,12 +124,18 @@ IOStatus iio_rmdir(const gchar* path);
 IOStatus iio_create(const gchar* path);
 IOStatus iio_stat(const gchar* path);
 IOStatus iio_rename(const gchar* oldname, const gchar* newname);
-// TODO:
 IOStatus iio_link(const gchar* oldpath, const gchar* newpath);
 IOStatus iio_unlink(const gchar* path);
 IOStatus iio_symlink(const gchar* oldpath, const gchar* newpath);
 IOStatus iio_chmod(const gchar* path, mode_t mode);
 IOStatus iio_chown(const gchar* path, uid_t owner, gid_t group);
 
+IOStatus iio_opendir(const gchar* path, File** dir);
+IOStatus iio_closedir(File* dir);
+IOStatus iio_readdir(const File* dir, glong bufferSize);
+IOStatus iio_statat(const File* dir, const gchar* name);
+IOStatus iio_createat(const File* dir, const gchar* name);
+IOStatus iio_unlinkat(const File* dir, const gchar* name, gint flags);
+
 
 #endif /* IIO_POSIX_H_ */
@@ -0,0 +1,290 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "imbalance.h"
+
+#include <string.h>
+
+
+void imbalance_init()
+{
+	outlierThreshold = 20;
+	imbalanceEvents = g_ptr_array_new();
+	outliers = g_array_new(FALSE, FALSE, sizeof(Outlier));
+	stragglerMap = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+}
+
+void imbalance_free()
+{
+	g_ptr_array_foreach(imbalanceEvents, (GFunc) g_free, NULL);
+	g_ptr_array_free(imbalanceEvents, TRUE);
+	g_array_free(outliers, TRUE);
+	g_hash_table_destroy(stragglerMap);
+}
+
+#ifdef HAVE_MPI
+
+#define MEDIAN_STEPS 40			// bisection steps, resolution (max-min)/2^40
+
+typedef struct {
+	gdouble value;
+	gint proc;
+} ValueLoc;
+
+/**
+ * Collects the local time events into arrays indexed by event id.
+ * Has to be called before the events are gathered on the master.
+ */
+static gint local_events(TimeEvent*** events)
+{
+	gint localCount = 0, count;
+	GSList* iter;
+
+	for (iter=timeList; iter; iter=g_slist_next(iter))
+		localCount = MAX(localCount, ((TimeEvent*) iter->data)->id + 1);
+
+	MPI_Allreduce(&localCount, &count, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+	*events = g_malloc0(MAX(count, 1) * sizeof(TimeEvent*));
+	for (iter=timeList; iter; iter=g_slist_next(iter)) {
+		TimeEvent* event = iter->data;
+		(*events)[event->id] = event;
+	}
+
+	return count;
+}
+
+/**
+ * Lower median of every event by bisection over [min, max]. Each step
+ * counts the processes at or below the midpoint with one reduction.
+ */
+static void reduce_medians(TimeEvent** events, gint count, const gint* procs, gdouble* lo, gdouble* hi)
+{
+	gint* below = g_malloc(count * sizeof(gint));
+	gint* total = g_malloc(count * sizeof(gint));
+	gint step, i;
+
+	for (step=0; step<MEDIAN_STEPS; step++) {
+		for (i=0; i<count; i++)
+			below[i] = (events[i] && events[i]->value <= (lo[i] + hi[i]) / 2);
+
+		MPI_Allreduce(below, total, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+		for (i=0; i<count; i++) {
+			if (total[i] >= (procs[i] + 1) / 2)
+				hi[i] = (lo[i] + hi[i]) / 2;
+			else
+				lo[i] = (lo[i] + hi[i]) / 2;
+		}
+	}
+
+	g_free(below);
+	g_free(total);
+}
+
+/**
+ * Sends the label of every event the master didn't record itself from the
+ * lowest process that recorded it.
+ */
+static void collect_labels(TimeEvent** events, gint count)
+{
+	gint* owner = g_malloc(count * sizeof(gint));
+	gint* lowest = g_malloc(count * sizeof(gint));
+	MPI_Status stat;
+	gint i;
+
+	for (i=0; i<count; i++)
+		owner[i] = events[i]? rank : size;
+
+	MPI_Allreduce(owner, lowest, count, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+	for (i=0; i<count; i++) {
+		if (lowest[i] == MASTER || lowest[i] == size)
+			continue;
+
+		if (rank == lowest[i])
+			MPI_Send(events[i]->name, NAME_SIZE, MPI_CHAR, MASTER, 8, MPI_COMM_WORLD);
+		else if (rank == MASTER) {
+			ImbalanceEvent* event = g_ptr_array_index(imbalanceEvents, i);
+			MPI_Recv(event->name, NAME_SIZE, MPI_CHAR, lowest[i], 8, MPI_COMM_WORLD, &stat);
+		}
+	}
+
+	g_free(owner);
+	g_free(lowest);
+}
+
+/**
+ * Sends the outlier events and the hostname of every straggler to the
+ * master. Processes without outliers only take part in the count gather.
+ */
+static void collect_outliers(GArray* local)
+{
+	gint localCount = local->len;
+	gint* counts = NULL;
+	gint* displs = NULL;
+	Straggler straggler;
+	Straggler* stragglers = NULL;
+	gint total = 0, i;
+
+	memset(&straggler, 0, sizeof(Straggler));
+	straggler.proc = rank;
+	straggler.count = localCount;
+	if (localCount > 0) {
+		gchar host[MPI_MAX_PROCESSOR_NAME];
+		gint length;
+		MPI_Get_processor_name(host, &length);
+		g_strlcpy(straggler.host, host, HOST_SIZE);
+	}
+
+	if (rank == MASTER) {
+		counts = g_malloc(size * sizeof(gint));
+		displs = g_malloc(size * sizeof(gint));
+		stragglers = g_malloc(size * sizeof(Straggler));
+	}
+
+	MPI_Gather(&straggler, sizeof(Straggler), MPI_BYTE, stragglers, sizeof(Straggler), MPI_BYTE, MASTER, MPI_COMM_WORLD);
+
+	if (rank == MASTER) {
+		for (i=0; i<size; i++) {
+			counts[i] = stragglers[i].count * sizeof(Outlier);
+			displs[i] = total;
+			total += counts[i];
+
+			if (stragglers[i].count > 0)
+				g_hash_table_insert(stragglerMap, GINT_TO_POINTER(i), g_memdup(&stragglers[i], sizeof(Straggler)));
+		}
+		g_array_set_size(outliers, total / sizeof(Outlier));
+	}
+
+	MPI_Gatherv(local->data, localCount * sizeof(Outlier), MPI_BYTE,
+			(rank == MASTER)? outliers->data : NULL, counts, displs, MPI_BYTE, MASTER, MPI_COMM_WORLD);
+
+	g_free(counts);
+	g_free(displs);
+	g_free(stragglers);
+}
+
+/**
+ * Analyzes the time events of all processes. Collective over
+ * MPI_COMM_WORLD, has to be called before gather_timeevents().
+ */
+void imbalance_analyze()
+{
+	TimeEvent** events;
+	gint count = local_events(&events);
+	gint i;
+
+	if (count == 0 || size < 2) {
+		g_free(events);
+		return;
+	}
+
+	ValueLoc* local = g_malloc(count * sizeof(ValueLoc));
+	ValueLoc* min = g_malloc(count * sizeof(ValueLoc));
+	ValueLoc* max = g_malloc(count * sizeof(ValueLoc));
+	gint* present = g_malloc(count * sizeof(gint));
+	gint* procs = g_malloc(count * sizeof(gint));
+	guint* hash = g_malloc(count * sizeof(guint));
+	guint* minHash = g_malloc(count * sizeof(guint));
+	guint* maxHash = g_malloc(count * sizeof(guint));
+	gdouble* lo = g_malloc(count * sizeof(gdouble));
+	gdouble* hi = g_malloc(count * sizeof(gdouble));
+
+	// min, max, number of processes and label check
+	for (i=0; i<count; i++) {
+		local[i].value = events[i]? events[i]->value : G_MAXDOUBLE;
+		local[i].proc = rank;
+		present[i] = (events[i] != NULL);
+		hash[i] = events[i]? g_str_hash(events[i]->name) : G_MAXUINT;
+	}
+	MPI_Allreduce(local, min, count, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+	MPI_Allreduce(hash, minHash, count, MPI_UNSIGNED, MPI_MIN, MPI_COMM_WORLD);
+
+	for (i=0; i<count; i++) {
+		local[i].value = events[i]? events[i]->value : -G_MAXDOUBLE;
+		hash[i] = events[i]? hash[i] : 0;
+	}
+	MPI_Allreduce(local, max, count, MPI_DOUBLE_INT, MPI_MAXLOC, MPI_COMM_WORLD);
+	MPI_Allreduce(hash, maxHash, count, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD);
+	MPI_Allreduce(present, procs, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+	for (i=0; i<count; i++) {
+		lo[i] = min[i].value;
+		hi[i] = max[i].value;
+	}
+	reduce_medians(events, count, procs, lo, hi);
+
+	// stragglers: slower than the median by more than the threshold
+	GArray* localOutliers = g_array_new(FALSE, FALSE, sizeof(Outlier));
+	for (i=0; i<count; i++) {
+		present[i] = (events[i] && minHash[i] == maxHash[i] && events[i]->value > hi[i] * (1 + outlierThreshold / 100));
+
+		if (present[i]) {
+			Outlier outlier = { rank, i, events[i]->value };
+			g_array_append_val(localOutliers, outlier);
+		}
+	}
+	gint* numOutliers = g_malloc0(count * sizeof(gint));
+	MPI_Reduce(present, numOutliers, count, MPI_INT, MPI_SUM, MASTER, MPI_COMM_WORLD);
+
+	if (rank == MASTER) {
+		for (i=0; i<count; i++) {
+			ImbalanceEvent* event = g_malloc0(sizeof(ImbalanceEvent));
+			event->id = i;
+			if (events[i])
+				strncpy(event->name, events[i]->name, NAME_SIZE-1);
+			event->mixed = (minHash[i] != maxHash[i]);
+			event->procs = procs[i];
+			event->min = min[i].value;
+			event->minProc = min[i].proc;
+			event->max = max[i].value;
+			event->maxProc = max[i].proc;
+			event->median = hi[i];
+			event->outliers = numOutliers[i];
+			g_ptr_array_add(imbalanceEvents, event);
+		}
+	}
+
+	collect_labels(events, count);
+	collect_outliers(localOutliers);
+
+	g_array_free(localOutliers, TRUE);
+	g_free(events);
+	g_free(local);
+	g_free(min);
+	g_free(max);
+	g_free(present);
+	g_free(procs);
+	g_free(numOutliers);
+	g_free(hash);
+	g_free(minHash);
+	g_free(maxHash);
+	g_free(lo);
+	g_free(hi);
+}
+
+#else
+
+void imbalance_analyze()
+{
+}
+
+#endif /* HAVE_MPI */
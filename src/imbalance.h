@@ -0,0 +1,75 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMBALANCE_H_
+#define IMBALANCE_H_
+
+#include "common.h"
+#include "timing.h"
+
+#include <glib.h>
+
+/**
+ * Load imbalance of time events. The n-th time event of every process is
+ * compared across all processes that recorded it: min, median and max are
+ * found with vector reductions (the median by bisection), so no process
+ * has to collect all event times. Processes slower than the median by more
+ * than the outlier threshold are stragglers, only those are sent to the
+ * master together with their hostname.
+ */
+
+#define HOST_SIZE 64			// max length of hostnames in the report
+
+typedef struct {
+	gint id;				// execution order of the time event
+	gchar name[NAME_SIZE];	// label of the time event
+	gboolean mixed;			// processes recorded different labels at this position
+	gint procs;				// processes that recorded the event
+	gdouble min;
+	gdouble median;			// lower median
+	gdouble max;
+	gint minProc;
+	gint maxProc;
+	gint outliers;			// processes beyond the outlier threshold
+} ImbalanceEvent;
+
+typedef struct {
+	gint proc;
+	gint id;				// time event the process was an outlier in
+	gdouble value;
+} Outlier;
+
+typedef struct {
+	gint proc;
+	gint count;				// number of time events the process was an outlier in
+	gchar host[HOST_SIZE];
+} Straggler;
+
+
+gdouble outlierThreshold;	// percent above the median
+GPtrArray* imbalanceEvents;	// ImbalanceEvent by id (master only)
+GArray* outliers;			// Outlier (master only)
+GHashTable* stragglerMap;	// rank -> Straggler (master only)
+
+
+void imbalance_init();
+void imbalance_free();
+
+void imbalance_analyze();
+
+#endif /* IMBALANCE_H_ */
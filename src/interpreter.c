@@ -21,6 +21,18 @@
 #include "iio.h"
 #include "iio_posix.h"
 #include "iio_mpi.h"
+#include "mdtest.h"
+#include "checkpoint.h"
+#include "cache.h"
+#include "stage.h"
+#include "aggregate.h"
+#include "phases.h"
+#include "sampler.h"
+#include "trace.h"
+#include "clocksync.h"
+#include "imbalance.h"
+#include "verify.h"
+#include "modules.h"
 #include "errtrace.h"
 
 /* Third party modules */
@@ -48,6 +60,11 @@ void iiInit(FILE* file)
 	dirList = NULL;
 	
 	timing_init();
+	phases_init();
+	sampler_init();
+	clock_init();
+	imbalance_init();
+	modules_init();
 	ast_init();
 	var_init();
 	//groups_init();
@@ -71,11 +88,176 @@ void iiFree()
 	}
 
 	timing_free();
+	phases_free();
+	sampler_free();
+	imbalance_free();
+	modules_free();
 	ast_free();
 	var_free();
 	//groups_free();
 }
 
+static void ExecuteStatement(GNode* node, gpointer data);
+
+static gint timeId = 0;
+static gint coreTimeId = 0;
+static gint statId = 0;
+#ifdef HAVE_MPI
+static gint masterDepth = 0;		// number of enclosing master blocks
+#endif
+
+/**
+ * Executes the children of a time or ctime statement once. The event is
+ * recorded under label, without label or during warm-up it is discarded.
+ * Returns the wall time or the accumulated core time of the execution.
+ */
+static gdouble ExecuteTimed(GNode* node, Statement* stmt, const gchar* label)
+{
+	gdouble time;
+	gdouble start = clock_elapsed();
+
+	if (warmingUp)
+		label = NULL;
+
+	if (stmt->type == STMT_TIME) {
+		GTimer* timer = g_timer_new();
+
+		g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
+
+		g_timer_stop(timer);
+		time = g_timer_elapsed(timer, NULL);
+		g_timer_destroy(timer);
+
+		if (label) {
+			TimeEvent* timeEvent = timeevent_new(timeId++, label, time);
+			timeEvent->start = start;
+			timeEvent->end = clock_elapsed();
+			timeList = g_slist_prepend(timeList, timeEvent);
+		}
+	}
+	else {
+		CoreTimeEvent* coreTimeEvent = coretime_event_new(label? coreTimeId++ : -1, label? label : "", coretime_new(0, 0));
+		coreTimeStack = g_list_prepend(coreTimeStack, coreTimeEvent);
+		if (label)
+			sampler_attach(coreTimeEvent);
+
+		g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
+
+		if (label)
+			sampler_detach(coreTimeEvent);
+		coreTimeStack = g_list_remove_link(coreTimeStack, g_list_first(coreTimeStack));
+		time = coreTimeEvent->avgCoreTime.time;
+		coreTimeEvent->start = start;
+		coreTimeEvent->end = clock_elapsed();
+
+		if (label)
+			coreTimeList = g_slist_prepend(coreTimeList, coreTimeEvent);
+		else
+			g_free(coreTimeEvent);
+	}
+
+	return time;
+}
+
+/**
+ * Decides if the confidence interval is narrow enough to stop a repeated
+ * time statement. Collective over the active group: all processes have to
+ * agree, since the block may contain collective calls. Inside a master
+ * block only one process executes, so it decides alone.
+ */
+static gboolean SamplingConverged(const gdouble* samples, glong numSamples, glong ciTarget)
+{
+	gdouble mean, stddev;
+	gint converged = FALSE;
+
+	if (ciTarget > 0 && numSamples >= 3) {
+		stat_summary(samples, numSamples, &mean, &stddev);
+		converged = (mean > 0 && 2 * stat_ci95(stddev, numSamples) / mean * 100 <= ciTarget);
+	}
+
+#ifdef HAVE_MPI
+	if (masterDepth == 0) {
+		gint local = converged;
+		MPI_Allreduce(&local, &converged, 1, MPI_INT, MPI_LAND, groupblock_get(NULL)->mpicomm);
+	}
+#endif
+
+	return converged;
+}
+
+/**
+ * time["x"] repeat N [warmup W] [confidence P] { ... }
+ * Runs W discarded warm-up executions and up to N measured executions,
+ * which are reported like single time events and summarized per label.
+ * With a confidence target the repetition stops as soon as the 95% confidence
+ * interval is narrower than P percent of the mean.
+ */
+static void ExecuteSampled(GNode* node, Statement* stmt)
+{
+	ExpressionStatus status[3];
+	ParameterList* paramList = stmt->parameters;
+	glong repeat = param_int_get(paramList, 0, &status[0]);
+	glong warmup = param_int_get(paramList, 1, &status[1]);
+	glong ciTarget = param_int_get(paramList, 2, &status[2]);
+	glong i, n;
+
+	Verbose("~ Executing sampled time statement: repeat = %ld, warmup = %ld, confidence = %ld%%", repeat, warmup, ciTarget);
+
+	// evaluator error check
+	if (!expr_status_assert(status, 3) || repeat < 1 || warmup < 0 || ciTarget < 0) {
+		backtrace(stmt);
+		Error("Malicious repeat parameters! (%s:%d)", __FILE__, __LINE__);
+	}
+
+	gchar* label = var_replace_substrings(stmt->label);
+	gdouble* samples = g_malloc(repeat * sizeof(gdouble));
+
+	// warm-up runs must not show up in enclosing core time statements, nested
+	// statements record no events and the counters are reset afterwards
+	if (warmup > 0) {
+		GList* outerStack = coreTimeStack;
+		gboolean outerWarmingUp = warmingUp;
+		gint succeed[NUM_TRAC_STATEMENTS], fail[NUM_TRAC_STATEMENTS];
+		StageStats outerStageStats = stageStats;
+		AggregateStats outerAggregateStats = aggregateStats;
+
+		memcpy(succeed, statementsSucceed, sizeof(succeed));
+		memcpy(fail, statementsFail, sizeof(fail));
+		coreTimeStack = NULL;
+		warmingUp = TRUE;
+
+		for (i=0; i<warmup; i++)
+			ExecuteTimed(node, stmt, NULL);
+
+		warmingUp = outerWarmingUp;
+		coreTimeStack = outerStack;
+		memcpy(statementsSucceed, succeed, sizeof(succeed));
+		memcpy(statementsFail, fail, sizeof(fail));
+		stageStats = outerStageStats;
+		aggregateStats = outerAggregateStats;
+	}
+
+	gdouble start = clock_elapsed();
+
+	for (n=0; n<repeat; ) {
+		samples[n] = ExecuteTimed(node, stmt, label);
+		n++;
+
+		if (ciTarget > 0 && n < repeat && SamplingConverged(samples, n, ciTarget))
+			break;
+	}
+
+	if (!warmingUp) {
+		StatEvent* statEvent = statevent_new(statId++, label, stmt->type == STMT_CTIME, samples, n, warmup);
+		statEvent->start = start;
+		statEvent->end = clock_elapsed();
+		statList = g_slist_prepend(statList, statEvent);
+	}
+
+	g_free(samples);
+	g_free(label);
+}
+
 static void ExecuteStatement(GNode* node, gpointer data)
 {
 	Statement* stmt = (Statement*) node->data;
@@ -83,6 +265,8 @@ static void ExecuteStatement(GNode* node, gpointer data)
 
 	if (parseOnly && (stmt->type < STMT_REPEAT)) return;
 
+	traceLine = stmt->line;
+
 	switch (stmt->type) {
 		case STMT_ASSIGN: {
 			ExpressionStatus status[2];
@@ -164,18 +348,13 @@ static void ExecuteStatement(GNode* node, gpointer data)
 		case STMT_TIME: {
 			Verbose("~ Executing STMT_TIME: label = %s", stmt->label);
 
-			static gint timeId = 0;
-			gdouble time;
-			GTimer* timer = g_timer_new();
-
-			g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
-
-			g_timer_stop(timer);
-			time = g_timer_elapsed(timer, NULL);
-			g_timer_destroy(timer);
+			if (stmt->parameters) {
+				ExecuteSampled(node, stmt);
+				break;
+			}
 
 			gchar* label = var_replace_substrings(stmt->label);
-			timeList = g_slist_prepend(timeList, timeevent_new(timeId++, label, time));
+			ExecuteTimed(node, stmt, label);
 			g_free(label);
 			break;
 		}
@@ -183,15 +362,13 @@ static void ExecuteStatement(GNode* node, gpointer data)
 		case STMT_CTIME: {
 			Verbose("~ Executing STMT_CTIME: label = %s", stmt->label);
 
-			static gint coreTimeId = 0;
-			gchar* label = var_replace_substrings(stmt->label);
-			CoreTimeEvent* coreTimeEvent = coretime_event_new(coreTimeId++, label, coretime_new(0, 0));
-			coreTimeStack = g_list_prepend(coreTimeStack, coreTimeEvent);
-
-			g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
+			if (stmt->parameters) {
+				ExecuteSampled(node, stmt);
+				break;
+			}
 
-			coreTimeList = g_slist_prepend(coreTimeList, coreTimeEvent);
-			coreTimeStack = g_list_remove_link(coreTimeStack, g_list_first(coreTimeStack));
+			gchar* label = var_replace_substrings(stmt->label);
+			ExecuteTimed(node, stmt, label);
 			g_free(label);
 			break;
 		}
@@ -229,7 +406,9 @@ static void ExecuteStatement(GNode* node, gpointer data)
 			else           Verbose("~ Executing STMT_MASTER: rank = %d, type = world", groupRank);
 
 			if(groupRank == MASTER) {
+				masterDepth++;
 				g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
+				masterDepth--;
 			}
 			else Verbose("Im not the master here... groupRank = %d", groupRank);
 			break;
@@ -277,6 +456,24 @@ static void ExecuteStatement(GNode* node, gpointer data)
 			break;
 		}
 
+		case STMT_COMPUTE: {
+			if (agileMode) return;
+			Verbose("~ Executing STMT_COMPUTE");
+
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			glong time = param_int_get(paramList, 0, &status[0]);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			compute_busy(time);
+			break;
+		}
+
 		case STMT_BLOCK: {
 			Verbose("~ Executing STMT_BLOCK");
 			g_node_children_foreach(node, G_TRAVERSE_ALL, &ExecuteStatement, NULL);
@@ -507,6 +704,178 @@ static void ExecuteStatement(GNode* node, gpointer data)
 			break;
 		}
 
+		case STMT_FDATASYNC: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_FDATASYNC: file = %p", file);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_fdatasync(file);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_FDATASYNC]++;
+			else
+				statementsFail[STMT_FDATASYNC]++;
+			break;
+		}
+
+		case STMT_SYNCPOLICY: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			gchar* policy = param_string_get(paramList, 1, &status[1]);
+			glong interval = param_int_get_optional(paramList, 2, &status[2], 1);
+
+			Verbose("~ Executing STMT_SYNCPOLICY: file = %p, policy = %s, interval = %ld", file, policy, interval);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			SyncPolicyType type;
+			if (!iio_sync_policy_parse(policy, &type)) {
+				backtrace(stmt);
+				Error("Unknown sync policy \"%s\" (none, fdatasync, fsync, close)!", policy);
+			}
+
+			if (interval < 1) {
+				backtrace(stmt);
+				Error("Sync policy interval must be positive (%ld)!", interval);
+			}
+
+			iio_set_sync_policy(file, type, interval);
+			statementsSucceed[STMT_SYNCPOLICY]++;
+
+			g_free(policy);
+			break;
+		}
+
+		case STMT_FSTAT: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_FSTAT: file = %p", file);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_fstat(file);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_FSTAT]++;
+			else
+				statementsFail[STMT_FSTAT]++;
+			break;
+		}
+
+		case STMT_FCNTL: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			gint cmd = param_int_get(paramList, 1, &status[1]);
+			glong arg = param_int_get_optional(paramList, 2, &status[2], 0);
+
+			Verbose("~ Executing STMT_FCNTL: file = %p, cmd = %d, arg = %ld", file, cmd, arg);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_fcntl(file, cmd, arg);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_FCNTL]++;
+			else
+				statementsFail[STMT_FCNTL]++;
+			break;
+		}
+
+		case STMT_FALLOCATE:
+		case STMT_FADVISE:
+		case STMT_FSYNCRANGE: {
+			ExpressionStatus status[4];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			glong offset = param_int_get(paramList, 1, &status[1]);
+			glong length = param_int_get(paramList, 2, &status[2]);
+			glong mode;
+
+			// fallocate defaults to plain allocation, sync_file_range to a
+			// blocking write-out, the fadvise advice is mandatory
+			if (stmt->type == STMT_FALLOCATE)
+				mode = param_int_get_optional(paramList, 3, &status[3], 0);
+			else if (stmt->type == STMT_FSYNCRANGE)
+				mode = param_int_get_optional(paramList, 3, &status[3],
+						SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER);
+			else
+				mode = param_int_get(paramList, 3, &status[3]);
+
+			Verbose("~ Executing STMT_%s: file = %p, offset = %ld, length = %ld, mode = %ld",
+					stmt_get_string(stmt->type), file, offset, length, mode);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 4)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus;
+			switch (stmt->type) {
+				case STMT_FALLOCATE: ioStatus = iio_fallocate(file, offset, length, mode); break;
+				case STMT_FADVISE:   ioStatus = iio_fadvise(file, offset, length, mode); break;
+				default:             ioStatus = iio_fsyncrange(file, offset, length, mode); break;
+			}
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[stmt->type]++;
+			else
+				statementsFail[stmt->type]++;
+			break;
+		}
+
+		case STMT_FTRUNCATE: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			glong length = param_int_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_FTRUNCATE: file = %p, length = %ld", file, length);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_ftruncate(file, length);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_FTRUNCATE]++;
+			else
+				statementsFail[STMT_FTRUNCATE]++;
+			break;
+		}
+
 		case STMT_WRITE: {
 			ExpressionStatus status[3];
 			ParameterList* paramList = stmt->parameters;
@@ -797,15 +1166,19 @@ static void ExecuteStatement(GNode* node, gpointer data)
 			break;
 		}
 
-#ifdef HAVE_MPI
-		case STMT_PFOPEN: {
+		case STMT_COPY:
+		case STMT_COPYRANGE:
+		case STMT_SENDFILE:
+		case STMT_SPLICE: {
 			ExpressionStatus status[3];
 			ParameterList* paramList = stmt->parameters;
-			gchar* fhname = param_string_get(paramList, 0, &status[0]);
-			gchar* fname_raw = param_string_get(paramList, 1, &status[1]);
-			gchar* mode = param_string_get(paramList, 2, &status[2]);
+			gchar* source_raw = param_string_get(paramList, 0, &status[0]);
+			gchar* dest_raw = param_string_get(paramList, 1, &status[1]);
+			glong dataSize = param_int_get_optional(paramList, 2, &status[2], READALL);
+			CopyMethod method;
 
-			Verbose("~ Executing STMT_FOPEN: fhname = %s, fname = %s mode = %s", fhname, fname_raw, mode);
+			Verbose("~ Executing STMT_%s: source = %s, dest = %s, dataSize = %ld",
+					stmt_get_string(stmt->type), source_raw, dest_raw, dataSize);
 
 			// evaluator error check
 			if (!expr_status_assert(status, 3)) {
@@ -813,57 +1186,80 @@ static void ExecuteStatement(GNode* node, gpointer data)
 				Error("Malicious statement parameters!");
 			}
 
-			gchar* fname = var_replace_substrings(fname_raw);
-			MPI_Comm comm = MPI_COMM_WORLD;
-			if(groupStack)
-				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
-
-			File* file;
-			if (iio_pfopen(fname, mode, comm, &file)) {
-				Verbose("  > file = %p", file);
-				var_set_value(fhname, VAR_FILE, &file);
-				statementsSucceed[STMT_PFOPEN]++;
+			switch (stmt->type) {
+				case STMT_COPYRANGE: method = COPY_RANGE; break;
+				case STMT_SENDFILE:  method = COPY_SENDFILE; break;
+				case STMT_SPLICE:    method = COPY_SPLICE; break;
+				default:             method = COPY_READWRITE; break;
 			}
+
+			gchar* source = var_replace_substrings(source_raw);
+			gchar* dest = var_replace_substrings(dest_raw);
+
+			IOStatus ioStatus = iio_copy(source, dest, dataSize, method);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[stmt->type]++;
 			else
-				statementsFail[STMT_PFOPEN]++;
+				statementsFail[stmt->type]++;
 
-			g_free(fhname);
-			g_free(fname_raw);
-			g_free(fname);
-			g_free(mode);
+			g_free(source_raw);
+			g_free(dest_raw);
+			g_free(source);
+			g_free(dest);
 			break;
 		}
 
-		case STMT_PFCLOSE: {
-			ExpressionStatus status[1];
+		case STMT_STAGE: {
+			ExpressionStatus status[4];
 			ParameterList* paramList = stmt->parameters;
-			File* file = param_file_get(paramList, 0, &status[0]);
+			gchar* source_raw = param_string_get(paramList, 0, &status[0]);
+			gchar* dest_raw = param_string_get(paramList, 1, &status[1]);
+			glong blockSize = param_int_get_optional(paramList, 2, &status[2], STAGE_BLOCK_SIZE);
+			gint depth = param_int_get_optional(paramList, 3, &status[3], STAGE_DEPTH);
 
-			Verbose("~ Executing STMT_FCLOSE: file = %p", file);
+			Verbose("~ Executing STMT_STAGE: source = %s, dest = %s, blockSize = %ld, depth = %d",
+					source_raw, dest_raw, blockSize, depth);
 
 			// evaluator error check
-			if (!expr_status_assert(status, 1)) {
+			if (!expr_status_assert(status, 4)) {
 				backtrace(stmt);
 				Error("Malicious statement parameters!");
 			}
 
-			if (file && iio_pfclose(file)) {
-				gchar* fhname = (gchar*) param_value_get(paramList, 0);
-				var_destroy(fhname);
-				statementsSucceed[STMT_PFCLOSE]++;
+			if (blockSize < 1 || depth < 1) {
+				backtrace(stmt);
+				Error("Invalid staging pipeline (blockSize = %ld, depth = %d)!", blockSize, depth);
 			}
+
+			gchar* source = var_replace_substrings(source_raw);
+			gchar* dest = var_replace_substrings(dest_raw);
+
+			IOStatus ioStatus = stage_run(source, dest, blockSize, depth);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("stage", NULL, source, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_STAGE]++;
 			else
-				statementsFail[STMT_PFCLOSE]++;
+				statementsFail[STMT_STAGE]++;
+
+			g_free(source_raw);
+			g_free(dest_raw);
+			g_free(source);
+			g_free(dest);
 			break;
 		}
 
-		case STMT_PFWRITE: {
+		case STMT_LINK:
+		case STMT_SYMLINK: {
 			ExpressionStatus status[2];
 			ParameterList* paramList = stmt->parameters;
-			File*  file = param_file_get(paramList, 0, &status[0]);
-			gchar* pname = param_string_get(paramList, 1, &status[1]);
+			gchar* oldpath_raw = param_string_get(paramList, 0, &status[0]);
+			gchar* newpath_raw = param_string_get(paramList, 1, &status[1]);
 
-			Verbose("~ Executing STMT_PFWRITE: file = %p, pattern = %s", file, pname);
+			Verbose("~ Executing STMT_%s: oldpath = %s, newpath = %s", stmt_get_string(stmt->type), oldpath_raw, newpath_raw);
 
 			// evaluator error check
 			if (!expr_status_assert(status, 2)) {
@@ -871,28 +1267,230 @@ static void ExecuteStatement(GNode* node, gpointer data)
 				Error("Malicious statement parameters!");
 			}
 
-			Pattern* pattern = g_hash_table_lookup(patternMap, pname);
-			if (!pattern) {
-				g_printf("Invalid pattern parameter in statement pfwrite.\n");
-				Error("Malicious statement parameters!");
-				break;
-			}
+			gchar* oldpath = var_replace_substrings(oldpath_raw);
+			gchar* newpath = var_replace_substrings(newpath_raw);
 
-			MPI_Comm comm = MPI_COMM_WORLD;
-			if(groupStack)
-				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+			IOStatus ioStatus = (stmt->type == STMT_LINK)?
+					iio_link(oldpath, newpath) : iio_symlink(oldpath, newpath);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
 
-			IOStatus ioStatus;
-			switch(pattern->level) {
-				/* Level 0: non-collective, contiguous */
-				case 0:
-					Verbose("  > level = 0");
-					ioStatus = iio_pfwrite_level0(file, pattern);
-					break;
+			if (ioStatus.success)
+				statementsSucceed[stmt->type]++;
+			else
+				statementsFail[stmt->type]++;
 
-				/* Level 1: collective, contiguous */
-				case 1:
-					Verbose("  > level = 1");
+			g_free(oldpath_raw);
+			g_free(newpath_raw);
+			g_free(oldpath);
+			g_free(newpath);
+			break;
+		}
+
+		case STMT_UNLINK: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_UNLINK: file = %s", fname_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+
+			IOStatus ioStatus = iio_unlink(fname);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_UNLINK]++;
+			else
+				statementsFail[STMT_UNLINK]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			break;
+		}
+
+		case STMT_CHMOD: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+			// the mode is given in octal notation, either as string ("0644")
+			// or as number (0644) which the scanner reads as decimal digits
+			gchar* mode_raw = param_string_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_CHMOD: file = %s, mode = %s", fname_raw, mode_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* end;
+			mode_t mode = (mode_t) strtol(mode_raw, &end, 8);
+			if (*mode_raw == '\0' || *end != '\0') {
+				backtrace(stmt);
+				Error("Invalid octal mode \"%s\"!", mode_raw);
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+
+			IOStatus ioStatus = iio_chmod(fname, mode);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_CHMOD]++;
+			else
+				statementsFail[STMT_CHMOD]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			g_free(mode_raw);
+			break;
+		}
+
+		case STMT_CHOWN: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+			// -1 leaves the owner or group unchanged
+			glong owner = param_int_get(paramList, 1, &status[1]);
+			glong group = param_int_get_optional(paramList, 2, &status[2], -1);
+
+			Verbose("~ Executing STMT_CHOWN: file = %s, owner = %ld, group = %ld", fname_raw, owner, group);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+
+			IOStatus ioStatus = iio_chown(fname, (uid_t) owner, (gid_t) group);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_CHOWN]++;
+			else
+				statementsFail[STMT_CHOWN]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			break;
+		}
+
+#ifdef HAVE_MPI
+		case STMT_PFOPEN: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fhname = param_string_get(paramList, 0, &status[0]);
+			gchar* fname_raw = param_string_get(paramList, 1, &status[1]);
+			gchar* mode = param_string_get(paramList, 2, &status[2]);
+
+			Verbose("~ Executing STMT_FOPEN: fhname = %s, fname = %s mode = %s", fhname, fname_raw, mode);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+			MPI_Comm comm = MPI_COMM_WORLD;
+			if(groupStack)
+				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+
+			File* file;
+			IOStatus ioStatus = iio_pfopen(fname, mode, comm, &file);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success) {
+				Verbose("  > file = %p", file);
+				var_set_value(fhname, VAR_FILE, &file);
+				trace_file_open(file, fname);
+				statementsSucceed[STMT_PFOPEN]++;
+			}
+			else
+				statementsFail[STMT_PFOPEN]++;
+
+			g_free(fhname);
+			g_free(fname_raw);
+			g_free(fname);
+			g_free(mode);
+			break;
+		}
+
+		case STMT_PFCLOSE: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_FCLOSE: file = %p", file);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iostatus_new(FALSE, 0, 0);
+			if (file)
+				ioStatus = iio_pfclose(file);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success) {
+				gchar* fhname = (gchar*) param_value_get(paramList, 0);
+				trace_file_close(file);
+				var_destroy(fhname);
+				statementsSucceed[STMT_PFCLOSE]++;
+			}
+			else
+				statementsFail[STMT_PFCLOSE]++;
+			break;
+		}
+
+		case STMT_PFWRITE: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			File*  file = param_file_get(paramList, 0, &status[0]);
+			gchar* pname = param_string_get(paramList, 1, &status[1]);
+			glong  compute = param_int_get_optional(paramList, 2, &status[2], 0);	// usec between split collective begin and end
+
+			Verbose("~ Executing STMT_PFWRITE: file = %p, pattern = %s", file, pname);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			Pattern* pattern = g_hash_table_lookup(patternMap, pname);
+			if (!pattern) {
+				g_printf("Invalid pattern parameter in statement pfwrite.\n");
+				Error("Malicious statement parameters!");
+				break;
+			}
+
+			MPI_Comm comm = MPI_COMM_WORLD;
+			if(groupStack)
+				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+
+			IOStatus ioStatus;
+			switch(pattern->level) {
+				/* Level 0: non-collective, contiguous */
+				case 0:
+					Verbose("  > level = 0");
+					ioStatus = iio_pfwrite_level0(file, pattern);
+					break;
+
+				/* Level 1: collective, contiguous */
+				case 1:
+					Verbose("  > level = 1");
 					ioStatus = iio_pfwrite_level1(file, pattern);
 					break;
 
@@ -908,10 +1506,41 @@ static void ExecuteStatement(GNode* node, gpointer data)
 					ioStatus = iio_pfwrite_level3(file, pattern);
 					break;
 
+				/* Level 4: non-collective, shared file pointer */
+				case 4:
+					Verbose("  > level = 4");
+					ioStatus = iio_pfwrite_level4(file, pattern);
+					break;
+
+				/* Level 5: collective, shared file pointer in rank order */
+				case 5:
+					Verbose("  > level = 5");
+					ioStatus = iio_pfwrite_level5(file, pattern);
+					break;
+
+				/* Level 6: non-collective, explicit offsets */
+				case 6:
+					Verbose("  > level = 6");
+					ioStatus = iio_pfwrite_level6(file, pattern);
+					break;
+
+				/* Level 7: collective, explicit offsets */
+				case 7:
+					Verbose("  > level = 7");
+					ioStatus = iio_pfwrite_level7(file, pattern);
+					break;
+
+				/* Level 8: split collective, explicit offsets */
+				case 8:
+					Verbose("  > level = 8");
+					ioStatus = iio_pfwrite_level8(file, pattern, compute);
+					break;
+
 				default: Error("Invalid level (%d) for statement pfwrite!", pattern->level);
 			}
 
 			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfwrite", file, NULL, -1, ioStatus);
 
 			if (ioStatus.success)
 				statementsSucceed[STMT_PFWRITE]++;
@@ -923,15 +1552,16 @@ static void ExecuteStatement(GNode* node, gpointer data)
 		}
 
 		case STMT_PFREAD: {
-			ExpressionStatus status[2];
+			ExpressionStatus status[3];
 			ParameterList* paramList = stmt->parameters;
 			File*  file = param_file_get(paramList, 0, &status[0]);
 			gchar* pname = param_string_get(paramList, 1, &status[1]);
+			glong  compute = param_int_get_optional(paramList, 2, &status[2], 0);	// usec between split collective begin and end
 
 			Verbose("~ Executing STMT_PFREAD: file = %p, pattern = %s", file, pname);
 
 			// evaluator error check
-			if (!expr_status_assert(status, 2)) {
+			if (!expr_status_assert(status, 3)) {
 				backtrace(stmt);
 				Error("Malicious statement parameters!");
 			}
@@ -973,10 +1603,41 @@ static void ExecuteStatement(GNode* node, gpointer data)
 					ioStatus = iio_pfread_level3(file, pattern);
 					break;
 
+				/* Level 4: non-collective, shared file pointer */
+				case 4:
+					Verbose("  > level = 4");
+					ioStatus = iio_pfread_level4(file, pattern);
+					break;
+
+				/* Level 5: collective, shared file pointer in rank order */
+				case 5:
+					Verbose("  > level = 5");
+					ioStatus = iio_pfread_level5(file, pattern);
+					break;
+
+				/* Level 6: non-collective, explicit offsets */
+				case 6:
+					Verbose("  > level = 6");
+					ioStatus = iio_pfread_level6(file, pattern);
+					break;
+
+				/* Level 7: collective, explicit offsets */
+				case 7:
+					Verbose("  > level = 7");
+					ioStatus = iio_pfread_level7(file, pattern);
+					break;
+
+				/* Level 8: split collective, explicit offsets */
+				case 8:
+					Verbose("  > level = 8");
+					ioStatus = iio_pfread_level8(file, pattern, compute);
+					break;
+
 				default: Error("Invalid level (%d) for statement pfread!", pattern->level);
 			}
 
 			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfread", file, NULL, -1, ioStatus);
 
 			if (ioStatus.success)
 				statementsSucceed[STMT_PFREAD]++;
@@ -1040,29 +1701,502 @@ static void ExecuteStatement(GNode* node, gpointer data)
 					ioStatus = iio_pwrite_level3(fname, pattern, comm);
 					break;
 
-				default: Error("Invalid level (%d) for statement pwrite!", pattern->level);
+				/* Level 4: non-collective, shared file pointer */
+				case 4:
+					Verbose("  > level = 4");
+					ioStatus = iio_pwrite_level4(fname, pattern, comm);
+					break;
+
+				/* Level 5: collective, shared file pointer in rank order */
+				case 5:
+					Verbose("  > level = 5");
+					ioStatus = iio_pwrite_level5(fname, pattern, comm);
+					break;
+
+				/* Level 6: non-collective, explicit offsets */
+				case 6:
+					Verbose("  > level = 6");
+					ioStatus = iio_pwrite_level6(fname, pattern, comm);
+					break;
+
+				/* Level 7: collective, explicit offsets */
+				case 7:
+					Verbose("  > level = 7");
+					ioStatus = iio_pwrite_level7(fname, pattern, comm);
+					break;
+
+				/* Level 8: split collective, explicit offsets */
+				case 8:
+					Verbose("  > level = 8");
+					ioStatus = iio_pwrite_level8(fname, pattern, comm);
+					break;
+
+				default: Error("Invalid level (%d) for statement pwrite!", pattern->level);
+			}
+
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pwrite", NULL, fname, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PWRITE]++;
+			else
+				statementsFail[STMT_PWRITE]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			g_free(pname);
+			break;
+		}
+
+		case STMT_PREAD: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+			gchar* pname = param_string_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_PREAD: file = %s, pattern = %s", fname_raw, pname);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+
+			Pattern* pattern = g_hash_table_lookup(patternMap, pname);
+			if (!pattern) {
+				g_printf("Invalid pattern parameter in statement pread.\n");
+				g_free(fname);
+				Error("Malicious statement parameters!");
+				break;
+			}
+
+			MPI_Comm comm = MPI_COMM_WORLD;
+			if(groupStack)
+				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+
+			IOStatus ioStatus;
+			switch(pattern->level) {
+				/* Level 0: non-collective, contiguous */
+				case 0:
+					Verbose("  > level = 0");
+					ioStatus = iio_pread_level0(fname, pattern, comm);
+					break;
+
+				/* Level 1: collective, contiguous */
+				case 1:
+					Verbose("  > level = 1");
+					ioStatus = iio_pread_level1(fname, pattern, comm);
+					break;
+
+				/* Level 2: non-collective, non-contiguous */
+				case 2:
+					Verbose("  > level = 2");
+					ioStatus = iio_pread_level2(fname, pattern, comm);
+					break;
+
+				/* Level 3: collective, non-contiguous */
+				case 3:
+					Verbose("  > level = 3");
+					ioStatus = iio_pread_level3(fname, pattern, comm);
+					break;
+
+				/* Level 4: non-collective, shared file pointer */
+				case 4:
+					Verbose("  > level = 4");
+					ioStatus = iio_pread_level4(fname, pattern, comm);
+					break;
+
+				/* Level 5: collective, shared file pointer in rank order */
+				case 5:
+					Verbose("  > level = 5");
+					ioStatus = iio_pread_level5(fname, pattern, comm);
+					break;
+
+				/* Level 6: non-collective, explicit offsets */
+				case 6:
+					Verbose("  > level = 6");
+					ioStatus = iio_pread_level6(fname, pattern, comm);
+					break;
+
+				/* Level 7: collective, explicit offsets */
+				case 7:
+					Verbose("  > level = 7");
+					ioStatus = iio_pread_level7(fname, pattern, comm);
+					break;
+
+				/* Level 8: split collective, explicit offsets */
+				case 8:
+					Verbose("  > level = 8");
+					ioStatus = iio_pread_level8(fname, pattern, comm);
+					break;
+
+				default: Error("Invalid level (%d) for statement pread!", pattern->level);
+			}
+
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pread", NULL, fname, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PREAD]++;
+			else
+				statementsFail[STMT_PREAD]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			g_free(pname);
+			break;
+		}
+
+		case STMT_PFPREALLOCATE: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			glong size = param_int_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_PFPREALLOCATE: file = %p, size = %ld", file, size);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_pfpreallocate(file, size);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfpreallocate", file, NULL, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PFPREALLOCATE]++;
+			else
+				statementsFail[STMT_PFPREALLOCATE]++;
+			break;
+		}
+
+		case STMT_PFSETSIZE: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			glong size = param_int_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_PFSETSIZE: file = %p, size = %ld", file, size);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_pfsetsize(file, size);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfsetsize", file, NULL, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PFSETSIZE]++;
+			else
+				statementsFail[STMT_PFSETSIZE]++;
+			break;
+		}
+
+		case STMT_PFATOMIC: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+			glong atomic = param_int_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_PFATOMIC: file = %p, atomic = %ld", file, atomic);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_pfatomic(file, atomic != 0);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfatomic", file, NULL, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PFATOMIC]++;
+			else
+				statementsFail[STMT_PFATOMIC]++;
+			break;
+		}
+
+		case STMT_PFSYNC: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			File* file = param_file_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_PFSYNC: file = %p", file);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_pfsync(file);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("pfsync", file, NULL, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_PFSYNC]++;
+			else
+				statementsFail[STMT_PFSYNC]++;
+			break;
+		}
+
+		case STMT_AGGWRITE: {
+			ExpressionStatus status[5];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+			glong blockSize = param_int_get(paramList, 1, &status[1]);
+			glong count = param_int_get(paramList, 2, &status[2]);
+			gint aggregators = param_int_get_optional(paramList, 3, &status[3], 0);	// 0: one per node over shared memory
+			glong stripeSize = param_int_get_optional(paramList, 4, &status[4], AGGREGATE_STRIPE_SIZE);
+
+			Verbose("~ Executing STMT_AGGWRITE: file = %s, blockSize = %ld, count = %ld, aggregators = %d, stripeSize = %ld",
+					fname_raw, blockSize, count, aggregators, stripeSize);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 5)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			if (blockSize < 1 || count < 1 || aggregators < 0 || stripeSize < 1
+					|| stripeSize > G_MAXINT / MAX(aggregators, 1)) {
+				backtrace(stmt);
+				Error("Invalid aggregation (blockSize = %ld, count = %ld, aggregators = %d, stripeSize = %ld)!",
+						blockSize, count, aggregators, stripeSize);
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+			MPI_Comm comm = MPI_COMM_WORLD;
+			if(groupStack)
+				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+
+			IOStatus ioStatus = aggregate_write(fname, blockSize, count, aggregators, stripeSize, comm);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("aggwrite", NULL, fname, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_AGGWRITE]++;
+			else
+				statementsFail[STMT_AGGWRITE]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			break;
+		}
+
+		case STMT_PDELETE: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_PDELETE: file = %s", fname_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* fname = var_replace_substrings(fname_raw);
+
+			if (iio_pdelete(fname))
+				statementsSucceed[STMT_PDELETE]++;
+			else
+				statementsFail[STMT_PDELETE]++;
+
+			g_free(fname_raw);
+			g_free(fname);
+			break;
+		}
+#endif
+
+		case STMT_OPENDIR: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			gchar* dhname = param_string_get(paramList, 0, &status[0]);
+			gchar* dname_raw = param_string_get(paramList, 1, &status[1]);
+
+			Verbose("~ Executing STMT_OPENDIR: dhname = %s, dname = %s", dhname, dname_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			gchar* dname = var_replace_substrings(dname_raw);
+
+			File* dir;
+			IOStatus ioStatus = iio_opendir(dname, &dir);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success) {
+				Verbose("  > dir = %p", dir);
+				var_set_value(dhname, VAR_FILE, &dir);
+				statementsSucceed[STMT_OPENDIR]++;
+			}
+			else
+				statementsFail[STMT_OPENDIR]++;
+
+			g_free(dhname);
+			g_free(dname_raw);
+			g_free(dname);
+			break;
+		}
+
+		case STMT_CLOSEDIR: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			File* dir = param_file_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_CLOSEDIR: dir = %p", dir);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			g_assert(dir);
+
+			IOStatus ioStatus = iio_closedir(dir);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success) {
+				gchar* dhname = (gchar*) param_value_get(paramList, 0);
+				var_destroy(dhname);
+				statementsSucceed[STMT_CLOSEDIR]++;
+			}
+			else
+				statementsFail[STMT_CLOSEDIR]++;
+			break;
+		}
+
+		case STMT_READDIR: {
+			ExpressionStatus status[2];
+			ParameterList* paramList = stmt->parameters;
+			File* dir = param_file_get(paramList, 0, &status[0]);
+			glong bufferSize = param_int_get_optional(paramList, 1, &status[1], 32*1024);
+
+			Verbose("~ Executing STMT_READDIR: dir = %p, bufferSize = %ld", dir, bufferSize);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 2)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			IOStatus ioStatus = iio_readdir(dir, bufferSize);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_READDIR]++;
+			else
+				statementsFail[STMT_READDIR]++;
+			break;
+		}
+
+		case STMT_STATAT:
+		case STMT_CREATEAT:
+		case STMT_UNLINKAT: {
+			ExpressionStatus status[3];
+			ParameterList* paramList = stmt->parameters;
+			File* dir = param_file_get(paramList, 0, &status[0]);
+			gchar* name_raw = param_string_get(paramList, 1, &status[1]);
+			gint flags = param_int_get_optional(paramList, 2, &status[2], 0);
+
+			Verbose("~ Executing STMT_%s: dir = %p, name = %s", stmt_get_string(stmt->type), dir, name_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 3)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
+			}
+
+			// only unlinkat takes flags (AT_REMOVEDIR)
+			if (stmt->type != STMT_UNLINKAT && param_list_size(paramList) > 2) {
+				backtrace(stmt);
+				Error("%s doesn't take flags!", stmt_get_string(stmt->type));
+			}
+
+			gchar* name = var_replace_substrings(name_raw);
+
+			IOStatus ioStatus;
+			switch (stmt->type) {
+				case STMT_STATAT:   ioStatus = iio_statat(dir, name); break;
+				case STMT_CREATEAT: ioStatus = iio_createat(dir, name); break;
+				default:            ioStatus = iio_unlinkat(dir, name, flags); break;
+			}
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+			if (ioStatus.success)
+				statementsSucceed[stmt->type]++;
+			else
+				statementsFail[stmt->type]++;
+
+			g_free(name_raw);
+			g_free(name);
+			break;
+		}
+
+		case STMT_EVICT: {
+			ExpressionStatus status[1];
+			ParameterList* paramList = stmt->parameters;
+			gchar* path_raw = param_string_get(paramList, 0, &status[0]);
+
+			Verbose("~ Executing STMT_EVICT: path = %s", path_raw);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 1)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
 			}
 
+			gchar* path = var_replace_substrings(path_raw);
+
+			IOStatus ioStatus = cache_evict(path);
 			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("evict", NULL, path, -1, ioStatus);
 
 			if (ioStatus.success)
-				statementsSucceed[STMT_PWRITE]++;
+				statementsSucceed[STMT_EVICT]++;
 			else
-				statementsFail[STMT_PWRITE]++;
+				statementsFail[STMT_EVICT]++;
 
-			g_free(fname_raw);
-			g_free(fname);
-			g_free(pname);
+			g_free(path_raw);
+			g_free(path);
 			break;
 		}
 
-		case STMT_PREAD: {
+		case STMT_DROPCACHES: {
+			Verbose("~ Executing STMT_DROPCACHES");
+
+			IOStatus ioStatus = cache_drop();
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("dropcaches", NULL, NULL, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_DROPCACHES]++;
+			else
+				statementsFail[STMT_DROPCACHES]++;
+			break;
+		}
+
+		case STMT_EVICTSCRATCH: {
 			ExpressionStatus status[2];
 			ParameterList* paramList = stmt->parameters;
-			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
-			gchar* pname = param_string_get(paramList, 1, &status[1]);
+			gchar* path_raw = param_string_get(paramList, 0, &status[0]);
+			glong scratchSize = param_int_get_optional(paramList, 1, &status[1], 0);
 
-			Verbose("~ Executing STMT_PREAD: file = %s, pattern = %s", fname_raw, pname);
+			Verbose("~ Executing STMT_EVICTSCRATCH: path = %s, size = %ld", path_raw, scratchSize);
 
 			// evaluator error check
 			if (!expr_status_assert(status, 2)) {
@@ -1070,87 +2204,194 @@ static void ExecuteStatement(GNode* node, gpointer data)
 				Error("Malicious statement parameters!");
 			}
 
-			gchar* fname = var_replace_substrings(fname_raw);
+			gchar* path = var_replace_substrings(path_raw);
 
-			Pattern* pattern = g_hash_table_lookup(patternMap, pname);
-			if (!pattern) {
-				g_printf("Invalid pattern parameter in statement pread.\n");
-				g_free(fname);
+			IOStatus ioStatus = cache_scratch(path, scratchSize);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO("evictscratch", NULL, path, -1, ioStatus);
+
+			if (ioStatus.success)
+				statementsSucceed[STMT_EVICTSCRATCH]++;
+			else
+				statementsFail[STMT_EVICTSCRATCH]++;
+
+			g_free(path_raw);
+			g_free(path);
+			break;
+		}
+
+		case STMT_MDTEST: {
+			ExpressionStatus status[6];
+			ParameterList* paramList = stmt->parameters;
+			gchar* path_raw = param_string_get(paramList, 0, &status[0]);
+			MdtestParams params;
+			params.depth  = param_int_get(paramList, 1, &status[1]);
+			params.branch = param_int_get(paramList, 2, &status[2]);
+			params.items  = param_int_get(paramList, 3, &status[3]);
+			params.unique = param_int_get_optional(paramList, 4, &status[4], 1);
+			params.size   = param_int_get_optional(paramList, 5, &status[5], 0);
+
+			Verbose("~ Executing STMT_MDTEST: path = %s, depth = %d, branch = %d, items = %d",
+					path_raw, params.depth, params.branch, params.items);
+
+			// evaluator error check
+			if (!expr_status_assert(status, 6)) {
+				backtrace(stmt);
 				Error("Malicious statement parameters!");
-				break;
 			}
 
-			MPI_Comm comm = MPI_COMM_WORLD;
-			if(groupStack)
-				comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+			if (params.depth < 0 || params.branch < 1 || params.items < 0 || params.size < 0) {
+				backtrace(stmt);
+				Error("Invalid mdtest tree (depth = %d, branch = %d, items = %d, size = %ld)!",
+						params.depth, params.branch, params.items, params.size);
+			}
 
-			IOStatus ioStatus;
-			switch(pattern->level) {
-				/* Level 0: non-collective, contiguous */
-				case 0:
-					Verbose("  > level = 0");
-					ioStatus = iio_pread_level0(fname, pattern, comm);
-					break;
+			gchar* path = var_replace_substrings(path_raw);
 
-				/* Level 1: collective, contiguous */
-				case 1:
-					Verbose("  > level = 1");
-					ioStatus = iio_pread_level1(fname, pattern, comm);
-					break;
+			if (mdtest_run(path, &params))
+				statementsSucceed[STMT_MDTEST]++;
+			else
+				statementsFail[STMT_MDTEST]++;
 
-				/* Level 2: non-collective, non-contiguous */
-				case 2:
-					Verbose("  > level = 2");
-					ioStatus = iio_pread_level2(fname, pattern, comm);
-					break;
+			g_free(path_raw);
+			g_free(path);
+			break;
+		}
 
-				/* Level 3: collective, non-contiguous */
-				case 3:
-					Verbose("  > level = 3");
-					ioStatus = iio_pread_level3(fname, pattern, comm);
-					break;
+		case STMT_CHECKPOINT: {
+			ExpressionStatus status[6];
+			ParameterList* paramList = stmt->parameters;
+			gchar* path_raw = param_string_get(paramList, 0, &status[0]);
+			gchar* layout = param_string_get(paramList, 1, &status[1]);
+			CheckpointParams params;
+			params.size    = param_int_get(paramList, 2, &status[2]);
+			gchar* policy  = param_string_get_optional(paramList, 3, &status[3], NULL);	// default: fsync on close
+			params.restart = param_int_get_optional(paramList, 4, &status[4], 1);
+			params.shift   = param_int_get_optional(paramList, 5, &status[5], 1);
 
-				default: Error("Invalid level (%d) for statement pread!", pattern->level);
+			Verbose("~ Executing STMT_CHECKPOINT: path = %s, layout = %s, size = %ld, sync = %s",
+					path_raw, layout, params.size, (policy? policy : "close"));
+
+			// evaluator error check
+			if (!expr_status_assert(status, 6)) {
+				backtrace(stmt);
+				Error("Malicious statement parameters!");
 			}
 
-			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			if (!checkpoint_layout_parse(layout, &params)) {
+				backtrace(stmt);
+				Error("Unknown checkpoint layout \"%s\" (nn[:shards], n1[:align], nm[:files])!", layout);
+			}
 
-			if (ioStatus.success)
-				statementsSucceed[STMT_PREAD]++;
+			if (!iio_sync_policy_parse(policy? policy : "close", &params.sync)) {
+				backtrace(stmt);
+				Error("Unknown sync policy \"%s\" (none, fdatasync, fsync, close)!", policy);
+			}
+
+			if (params.size < 1) {
+				backtrace(stmt);
+				Error("Invalid checkpoint size (%ld)!", params.size);
+			}
+
+			gchar* path = var_replace_substrings(path_raw);
+
+			if (checkpoint_run(path, &params))
+				statementsSucceed[STMT_CHECKPOINT]++;
 			else
-				statementsFail[STMT_PREAD]++;
+				statementsFail[STMT_CHECKPOINT]++;
 
-			g_free(fname_raw);
-			g_free(fname);
-			g_free(pname);
+			g_free(path_raw);
+			g_free(path);
+			g_free(layout);
+			g_free(policy);
 			break;
 		}
 
-		case STMT_PDELETE: {
-			ExpressionStatus status[1];
+		case STMT_MODULE: {
+			ModuleStatementDesc* desc = module_statement_lookup(stmt->label);
 			ParameterList* paramList = stmt->parameters;
-			gchar* fname_raw = param_string_get(paramList, 0, &status[0]);
 
-			Verbose("~ Executing STMT_PDELETE: file = %s", fname_raw);
+			Verbose("~ Executing STMT_MODULE: statement = %s", stmt->label);
+
+			g_assert(desc);
+			const ModuleStatement* statement = desc->statement;
+
+			// opening statements get the name of the assigned variable first
+			gint first = (statement->kind == MODULE_STMT_OPEN)? 1 : 0;
+
+			if (param_list_size(paramList) != statement->numParams + first) {
+				backtrace(stmt);
+				Error("Statement %s expects %d parameters!", statement->name, statement->numParams);
+			}
+
+			ExpressionStatus status[statement->numParams+1];
+			ModuleParam params[statement->numParams+1];
+			File* files[statement->numParams+1];
+			gchar* hname = NULL;
+			gint i;
+
+			if (first)
+				hname = param_string_get(paramList, 0, &status[statement->numParams]);
+			else
+				status[statement->numParams] = STATUS_EVAL_OK;
+
+			for (i=0; i<statement->numParams; i++) {
+				files[i] = NULL;
+
+				if (statement->paramTypes[i] == MODULE_PARAM_INT)
+					params[i].num = param_int_get(paramList, i+first, &status[i]);
+				else if (statement->paramTypes[i] == MODULE_PARAM_HANDLE) {
+					files[i] = param_file_get(paramList, i+first, &status[i]);
+					params[i].handle = module_handle_get(files[i], desc->module);
+
+					if (status[i] == STATUS_EVAL_OK && !params[i].handle) {
+						backtrace(stmt);
+						Error("Parameter %d of %s is no %s handle!", i+1, statement->name, desc->module->info->name);
+					}
+				}
+				else {
+					gchar* raw = param_string_get(paramList, i+first, &status[i]);
+					params[i].str = (status[i] == STATUS_EVAL_OK)? var_replace_substrings(raw) : NULL;
+					g_free(raw);
+				}
+			}
 
 			// evaluator error check
-			if (!expr_status_assert(status, 1)) {
+			if (!expr_status_assert(status, statement->numParams+1)) {
 				backtrace(stmt);
 				Error("Malicious statement parameters!");
 			}
 
-			gchar* fname = var_replace_substrings(fname_raw);
+			gpointer result = NULL;
+			IOStatus ioStatus = statement->handler(desc->module->context, params, &result);
+			dump_coretime(coreTimeStack, ioStatus.coreTime);
+			TRACE_IO(statement->name, NULL, NULL, -1, ioStatus);
 
-			if (iio_pdelete(fname))
-				statementsSucceed[STMT_PDELETE]++;
-			else
-				statementsFail[STMT_PDELETE]++;
+			if (ioStatus.success) {
+				if (statement->kind == MODULE_STMT_OPEN) {
+					File* file = module_handle_new(desc->module, result);
+					Verbose("  > handle = %p", result);
+					var_set_value(hname, VAR_FILE, &file);
+				}
+				else if (statement->kind == MODULE_STMT_CLOSE) {
+					module_handle_close(files[0]);
+					var_destroy((gchar*) param_value_get(paramList, 0));
+				}
 
-			g_free(fname_raw);
-			g_free(fname);
+				desc->succeed++;
+				statementsSucceed[STMT_MODULE]++;
+			}
+			else {
+				desc->fail++;
+				statementsFail[STMT_MODULE]++;
+			}
+
+			for (i=0; i<statement->numParams; i++)
+				if (statement->paramTypes[i] == MODULE_PARAM_STRING)
+					g_free((gchar*) params[i].str);
+			g_free(hname);
 			break;
 		}
-#endif
 
 		/* ![ModuleHook] statement_exec */
 
@@ -1312,6 +2553,11 @@ void iiCoreTimeReport()
 			g_printf("\n");
 			g_printf(" %36s  %10ld IOops/s\n", "", ioops);
 			g_printf("\n");
+			if (event->numSyncs > 0) {
+				g_printf(" %36s  sync %10.6f s / %ld calls\n", "", event->syncTime, event->numSyncs);
+				g_printf(" %36s   max %11.6f s\n", "", event->maxSyncTime);
+				g_printf("\n");
+			}
 			g_printf(" %24s Total: %10s / %.6f s\n", "", total, event->avgCoreTime.time);
 			g_printf("\n");
 
@@ -1325,12 +2571,412 @@ void iiCoreTimeReport()
 		g_printf("- Core time I/O throughput (average, min, max)\n");
 		g_printf("- Calltime (average, min, max) for all statements\n  during this CoreTime Event\n");
 		g_printf("- Total data processed per time in seconds\n  during this CoreTime event\n");
+		g_printf("- Sync time (total, max) included in the core time\n");
 	}
 	else {
 		g_printf("No coretime events.\n");
 	}
 }
 
+void iiStatReport()
+{
+	if (!statList)
+		return;
+
+	g_printf("\n****************** Repetition Report ********************\n");
+
+	// sort events by global occurence
+	statList = g_slist_sort(statList, compare_stat_events);
+	GSList* iter = statList;
+	gint lastprocid = 0;
+
+	g_printf(" [P]   [#]                    [event]          [seconds]\n");
+
+	for(;iter;iter=g_slist_next(iter)) {
+		StatEvent* event = (StatEvent*) iter->data;
+
+		if(event->proc != lastprocid) {
+			g_printf("---------------------------------------------------------\n");
+		}
+
+		g_printf(" %2d   %3d   %25s   mean %11.6f\n", event->proc, event->id, event->name, event->mean);
+		g_printf(" %36s    +- %11.6f (95%% CI)\n", "", event->ci);
+		g_printf(" %36s stddev %11.6f\n", "", event->stddev);
+		g_printf(" %36s median %11.6f\n", "", event->median);
+		g_printf(" %36s    min %11.6f\n", "", event->min);
+		g_printf(" %36s    max %11.6f\n", "", event->max);
+		g_printf(" %28s %s %4ld runs, %ld warm-up\n", "", (event->core? "core" : "wall"), event->samples, event->warmup);
+		g_printf("\n");
+
+		lastprocid = event->proc;
+	}
+
+	g_printf("[seconds]    - Wall time (time) or core time (ctime) per repetition\n");
+	g_printf("[95%% CI]     - Half width of the confidence interval of the mean\n");
+}
+
+typedef struct {
+	gboolean core;			// ctime instead of time event
+	gint id;
+	const gchar* name;
+	gint procs;				// number of processes that recorded the event
+	gdouble firstStart, lastStart;
+	gdouble firstEnd, lastEnd;
+	gint firstStartProc, lastStartProc;
+	gint firstEndProc, lastEndProc;
+} SkewEntry;
+
+static void skew_add(GHashTable* map, GPtrArray* entries, gboolean core, gint id, const gchar* name,
+		gint proc, gdouble start, gdouble end)
+{
+	gchar* key = g_strdup_printf("%d:%d:%s", core, id, name);
+	SkewEntry* entry = g_hash_table_lookup(map, key);
+
+	if (!entry) {
+		entry = g_malloc0(sizeof(SkewEntry));
+		entry->core = core;
+		entry->id = id;
+		entry->name = name;
+		entry->firstStart = entry->firstEnd = G_MAXDOUBLE;
+		entry->lastStart = entry->lastEnd = -G_MAXDOUBLE;
+		g_hash_table_insert(map, key, entry);
+		g_ptr_array_add(entries, entry);
+	}
+	else
+		g_free(key);
+
+	entry->procs++;
+	if (start < entry->firstStart) { entry->firstStart = start; entry->firstStartProc = proc; }
+	if (start > entry->lastStart)  { entry->lastStart = start;  entry->lastStartProc = proc; }
+	if (end < entry->firstEnd)     { entry->firstEnd = end;     entry->firstEndProc = proc; }
+	if (end > entry->lastEnd)      { entry->lastEnd = end;      entry->lastEndProc = proc; }
+}
+
+static gint compare_skew_entries(gconstpointer a, gconstpointer b)
+{
+	const SkewEntry* e0 = *((SkewEntry**) a);
+	const SkewEntry* e1 = *((SkewEntry**) b);
+
+	if (e0->core != e1->core)
+		return e0->core - e1->core;
+	return e0->id - e1->id;
+}
+
+/**
+ * Compares the start and end times of the same time and ctime events on
+ * the global timeline. Events are matched by type, execution order and
+ * label, only events recorded by more than one process are listed.
+ */
+void iiSkewReport()
+{
+	GHashTable* map = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	GPtrArray* entries = g_ptr_array_new();
+	GSList* iter;
+	guint i;
+
+	for (iter=timeList; iter; iter=g_slist_next(iter)) {
+		TimeEvent* event = iter->data;
+		skew_add(map, entries, FALSE, event->id, event->name, event->proc, event->start, event->end);
+	}
+
+	for (iter=coreTimeList; iter; iter=g_slist_next(iter)) {
+		CoreTimeEvent* event = iter->data;
+		skew_add(map, entries, TRUE, event->id, event->name, event->proc, event->start, event->end);
+	}
+
+	g_ptr_array_sort(entries, compare_skew_entries);
+
+	if (size > 1 && entries->len > 0) {
+		g_printf("\n********************* Skew Report ***********************\n");
+		g_printf("      [#]                 [event]  [P]     [skew]  [first/last]\n");
+
+		for (i=0; i<entries->len; i++) {
+			SkewEntry* entry = g_ptr_array_index(entries, i);
+
+			if (entry->procs < 2)
+				continue;
+
+			g_printf("---------------------------------------------------------\n");
+			g_printf(" %5s %3d %23s %4d  start %10.6fs  %3d/%-3d\n", (entry->core? "ctime" : "time"),
+					entry->id, entry->name, entry->procs, entry->lastStart - entry->firstStart,
+					entry->firstStartProc, entry->lastStartProc);
+			g_printf(" %37s  end   %10.6fs  %3d/%-3d\n", "",
+					entry->lastEnd - entry->firstEnd, entry->firstEndProc, entry->lastEndProc);
+			g_printf(" %37s  span  %10.6fs - %.6fs\n", "", entry->firstStart, entry->lastEnd);
+		}
+
+		g_printf("\n");
+		g_printf("[P]          - Processes that recorded the event\n");
+		g_printf("[skew]       - Difference between the first and the last process\n");
+		g_printf("               to start and to finish the event\n");
+		g_printf("[first/last] - Ranks of the first and the last process\n");
+		g_printf("span         - Global start and end, seconds since kernel start\n");
+	}
+
+	g_ptr_array_foreach(entries, (GFunc) g_free, NULL);
+	g_ptr_array_free(entries, TRUE);
+	g_hash_table_destroy(map);
+}
+
+typedef struct {
+	gint proc;
+	gint count;
+} OffenderCount;
+
+static gint compare_offenders(gconstpointer a, gconstpointer b)
+{
+	const OffenderCount* o0 = a;
+	const OffenderCount* o1 = b;
+
+	if (o0->count != o1->count)
+		return o1->count - o0->count;
+	return o0->proc - o1->proc;
+}
+
+static const gchar* straggler_host(gint proc)
+{
+	Straggler* straggler = g_hash_table_lookup(stragglerMap, GINT_TO_POINTER(proc));
+	return straggler? straggler->host : "";
+}
+
+/**
+ * Prints the offenders of one label, most frequent first.
+ */
+static void print_offenders(const gchar* name, GHashTable* counts, gint iterations)
+{
+	GArray* offenders = g_array_new(FALSE, FALSE, sizeof(OffenderCount));
+	GHashTableIter iter;
+	gpointer key, value;
+	guint i;
+
+	g_hash_table_iter_init(&iter, counts);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		OffenderCount offender = { GPOINTER_TO_INT(key), GPOINTER_TO_INT(value) };
+		g_array_append_val(offenders, offender);
+	}
+	g_array_sort(offenders, compare_offenders);
+
+	for (i=0; i<offenders->len && i<10; i++) {
+		OffenderCount* offender = &g_array_index(offenders, OffenderCount, i);
+		g_printf(" %-24s  %5d  %-16s %5d/%d\n", (i == 0? name : ""), offender->proc,
+				straggler_host(offender->proc), offender->count, iterations);
+	}
+	if (offenders->len > 10)
+		g_printf(" %24s  ... %d more\n", "", offenders->len - 10);
+
+	g_array_free(offenders, TRUE);
+}
+
+void iiImbalanceReport()
+{
+	if (imbalanceEvents->len == 0)
+		return;
+
+	GHashTable* labelOffenders = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_hash_table_destroy);
+	GHashTable* labelIterations = g_hash_table_new(g_str_hash, g_str_equal);
+	GSList* labels = NULL;
+	GSList* cur;
+	guint i, j;
+
+	g_printf("\n******************* Imbalance Report ********************\n");
+	g_printf(" [#]                    [event]   [P]         [seconds]  [rank]\n");
+
+	for (i=0; i<imbalanceEvents->len; i++) {
+		ImbalanceEvent* event = g_ptr_array_index(imbalanceEvents, i);
+
+		g_printf("---------------------------------------------------------\n");
+
+		if (event->mixed) {
+			g_printf(" %3d %26s %5d   (different labels, not compared)\n", event->id, event->name, event->procs);
+			continue;
+		}
+
+		g_printf(" %3d %26s %5d   min %10.6fs  %5d\n", event->id, event->name, event->procs, event->min, event->minProc);
+		g_printf(" %36s median %10.6fs\n", "", event->median);
+		g_printf(" %36s    max %10.6fs  %5d\n", "", event->max, event->maxProc);
+
+		if (event->outliers > 0) {
+			gint listed = 0;
+
+			g_printf(" %36s %3d beyond +%.0f%%:", "", event->outliers, outlierThreshold);
+			for (j=0; j<outliers->len; j++) {
+				Outlier* outlier = &g_array_index(outliers, Outlier, j);
+				if (outlier->id != event->id)
+					continue;
+				if (listed++ == 4) {
+					g_printf(" ...");
+					break;
+				}
+				g_printf(" %d (%s)", outlier->proc, straggler_host(outlier->proc));
+			}
+			g_printf("\n");
+		}
+
+		// repeated offenders are counted per label
+		if (!g_hash_table_lookup(labelOffenders, event->name)) {
+			g_hash_table_insert(labelOffenders, event->name, g_hash_table_new(g_direct_hash, g_direct_equal));
+			labels = g_slist_append(labels, event->name);
+		}
+		g_hash_table_insert(labelIterations, event->name,
+				GINT_TO_POINTER(GPOINTER_TO_INT(g_hash_table_lookup(labelIterations, event->name)) + 1));
+	}
+
+	for (j=0; j<outliers->len; j++) {
+		Outlier* outlier = &g_array_index(outliers, Outlier, j);
+		ImbalanceEvent* event = g_ptr_array_index(imbalanceEvents, outlier->id);
+		GHashTable* counts = g_hash_table_lookup(labelOffenders, event->name);
+		gpointer key = GINT_TO_POINTER(outlier->proc);
+
+		g_hash_table_insert(counts, key, GINT_TO_POINTER(GPOINTER_TO_INT(g_hash_table_lookup(counts, key)) + 1));
+	}
+
+	g_printf("\n");
+	g_printf("[P]          - Processes that recorded the event\n");
+	g_printf("[rank]       - Fastest and slowest process\n");
+	g_printf("beyond       - Stragglers slower than the median by more than\n");
+	g_printf("               the outlier threshold (rank and host)\n");
+
+	if (outliers->len > 0) {
+		g_printf("\nRepeated offenders:\n");
+		g_printf(" [event]                   [rank]  [host]          [count]\n");
+
+		for (cur=labels; cur; cur=g_slist_next(cur)) {
+			GHashTable* counts = g_hash_table_lookup(labelOffenders, cur->data);
+			if (g_hash_table_size(counts) > 0)
+				print_offenders(cur->data, counts, GPOINTER_TO_INT(g_hash_table_lookup(labelIterations, cur->data)));
+		}
+	}
+
+	g_slist_free(labels);
+	g_hash_table_destroy(labelIterations);
+	g_hash_table_destroy(labelOffenders);
+}
+
+void iiPhaseReport()
+{
+	if (!phaseList)
+		return;
+
+	g_printf("\n********************* Phase Report **********************\n");
+
+	// sort events by global occurence
+	phaseList = g_slist_sort(phaseList, compare_phase_events);
+	GSList* iter = phaseList;
+	gint lastid = -1, lastproc = -1;
+
+	g_printf(" [#]  [phase]           [procs]        [ops/s]   [seconds]\n");
+
+	for(;iter;iter=g_slist_next(iter)) {
+		PhaseEvent* event = (PhaseEvent*) iter->data;
+
+		if(event->id != lastid || event->proc != lastproc) {
+			g_printf("---------------------------------------------------------\n");
+			g_printf(" %3d  %s (master %d)\n", event->id, event->name, event->proc);
+		}
+
+		gdouble rate = (event->maxTime > 0? event->ops / event->maxTime : 0);
+		g_printf("      %-16s  %7d  %13.1f   %9.6fs\n", event->phase, event->procs, rate, event->maxTime);
+
+		if (event->data > 0) {
+			gchar* total = format_data_size(event->data);
+			gdouble throughput = (event->maxTime > 0? event->data / event->maxTime : 0);
+			g_printf(" %24s %10s / %.2f MiB/s\n", "", total, throughput / (1024*1024));
+			g_free(total);
+		}
+
+		lastid = event->id;
+		lastproc = event->proc;
+	}
+
+	g_printf("\n");
+	g_printf("[#]          - Execution order of the phased statement in its group\n");
+	g_printf("[procs]      - Processes taking part in the phase\n");
+	g_printf("[ops/s]      - Aggregated operations per second\n");
+	g_printf("[seconds]    - Duration of the slowest process\n");
+}
+
+void iiVerifyReport()
+{
+	if (!verifyEnabled)
+		return;
+
+	gchar* filled = format_data_size(verifyStats.bytesFilled);
+	gchar* checked = format_data_size(verifyStats.bytesChecked);
+
+	g_printf("\n****************** Verification Report ******************\n");
+	g_printf("            [data]   [seconds]        [MiB/s]\n");
+	g_printf("---------------------------------------------------------\n");
+	g_printf(" written %10s  %9.6fs  %13.2f\n", filled, verifyStats.fillTime,
+			(verifyStats.fillTime > 0? verifyStats.bytesFilled / verifyStats.fillTime / (1024*1024) : 0));
+	g_printf(" read    %10s  %9.6fs  %13.2f\n", checked, verifyStats.checkTime,
+			(verifyStats.checkTime > 0? verifyStats.bytesChecked / verifyStats.checkTime / (1024*1024) : 0));
+	g_printf(" corrupted words: %ld\n", verifyStats.errors);
+
+	g_printf("\n");
+	g_printf("[data]       - Data generated for writes and checked after reads\n");
+	g_printf("[seconds]    - Time of the slowest process, not part of the core time\n");
+	g_printf("[MiB/s]      - Data of all processes per second of the slowest one\n");
+
+	g_free(filled);
+	g_free(checked);
+}
+
+void iiStageReport()
+{
+	if (stageStats.runs == 0)
+		return;
+
+	gchar* staged = format_data_size(stageStats.bytes);
+	gdouble pipeline = (stageStats.time > 0? stageStats.bytes / stageStats.time / (1024*1024) : 0);
+	gdouble reads = (stageStats.readTime > 0? stageStats.bytes / stageStats.readTime / (1024*1024) : 0);
+	gdouble writes = (stageStats.writeTime > 0? stageStats.bytes / stageStats.writeTime / (1024*1024) : 0);
+	gdouble bound = MIN(reads, writes);
+
+	g_printf("\n******************** Staging Report *********************\n");
+	g_printf("            [data]   [seconds]        [MiB/s]    [waits]\n");
+	g_printf("---------------------------------------------------------\n");
+	g_printf(" pipeline %9s  %9.6fs  %13.2f\n", staged, stageStats.time, pipeline);
+	g_printf(" read     %9s  %9.6fs  %13.2f  %9ld\n", staged, stageStats.readTime, reads, stageStats.readerWaits);
+	g_printf(" write    %9s  %9.6fs  %13.2f  %9ld\n", staged, stageStats.writeTime, writes, stageStats.writerWaits);
+	g_printf(" efficiency: %.1f%% of min(read, write) in %ld runs\n",
+			(bound > 0? 100 * pipeline / bound : 0), stageStats.runs);
+
+	g_printf("\n");
+	g_printf("[seconds]    - Pipeline time or time spent in read/write, slowest process\n");
+	g_printf("[MiB/s]      - Data of all processes per second of the slowest one\n");
+	g_printf("[waits]      - Times the reader found no free buffer or the writer no data\n");
+
+	g_free(staged);
+}
+
+void iiAggregateReport()
+{
+	if (aggregateStats.runs == 0)
+		return;
+
+	gchar* written = format_data_size(aggregateStats.bytes);
+	gdouble total = (aggregateStats.time > 0? aggregateStats.bytes / aggregateStats.time / (1024*1024) : 0);
+	gdouble shuffle = (aggregateStats.shuffleTime > 0? aggregateStats.bytes / aggregateStats.shuffleTime / (1024*1024) : 0);
+	gdouble writes = (aggregateStats.writeTime > 0? aggregateStats.bytes / aggregateStats.writeTime / (1024*1024) : 0);
+
+	g_printf("\n****************** Aggregation Report *******************\n");
+	g_printf("            [data]   [seconds]        [MiB/s]   [writes]\n");
+	g_printf("---------------------------------------------------------\n");
+	g_printf(" total    %9s  %9.6fs  %13.2f\n", written, aggregateStats.time, total);
+	g_printf(" shuffle  %9s  %9.6fs  %13.2f\n", written, aggregateStats.shuffleTime, shuffle);
+	g_printf(" write    %9s  %9.6fs  %13.2f  %9ld\n", written, aggregateStats.writeTime, writes, aggregateStats.writes);
+	g_printf(" %.1f aggregators per run, %.1f%% of the time in the shuffle, %ld runs\n",
+			(gdouble) aggregateStats.aggregators / aggregateStats.runs,
+			(aggregateStats.time > 0? 100 * aggregateStats.shuffleTime / aggregateStats.time : 0), aggregateStats.runs);
+
+	g_printf("\n");
+	g_printf("[seconds]    - Time of shuffle and write or of either phase, slowest process\n");
+	g_printf("[MiB/s]      - Data of all processes per second of the slowest one\n");
+	g_printf("[writes]     - pwrite calls of all aggregators\n");
+
+	g_free(written);
+}
+
 void iiCommandReport()
 {
 	g_printf("\n******************** Command Report *********************\n");
@@ -1351,6 +2997,14 @@ void iiCommandReport()
 		if(statementsSucceed[i]!=0 || statementsFail[i]!=0)
 			g_printf(" %-7s  %13d successful / %13d failed\n", stmt_get_string(i), statementsSucceed[i],  statementsFail[i]);
 	}
+
+	// break down module statements
+	for (i=0; i<moduleStatements->len; i++) {
+		ModuleStatementDesc* desc = g_ptr_array_index(moduleStatements, i);
+		if(desc->succeed!=0 || desc->fail!=0)
+			g_printf("   %-7s%13d successful / %13d failed  (%s)\n", desc->statement->name,
+					desc->succeed, desc->fail, desc->module->info->name);
+	}
 }
 
 void clean_created_data()
@@ -76,7 +76,14 @@ void iiSetParameters(gint argc, gchar** argv);
 void iiStart();
 void iiTimeReport();
 void iiCoreTimeReport();
+void iiStatReport();
+void iiSkewReport();
+void iiImbalanceReport();
 void iiCommandReport();
+void iiPhaseReport();
+void iiVerifyReport();
+void iiStageReport();
+void iiAggregateReport();
 
 
 //
@@ -18,10 +18,20 @@
 
 #include "common.h"
 #include "timing.h"
+#include "phases.h"
+#include "sampler.h"
+#include "trace.h"
+#include "clocksync.h"
+#include "imbalance.h"
+#include "verify.h"
+#include "content.h"
+#include "stage.h"
+#include "aggregate.h"
+#include "modules.h"
 #include "interpreter.h"
 #include "iio_posix.h"
 #include "groups.h"
-#include "xml.h"
+#include "export.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -37,6 +47,24 @@ gboolean version = FALSE;
 gboolean agileMode = FALSE;
 gboolean waitForStartSignal = FALSE;
 
+gchar** modulePaths = NULL;
+gchar* backendName = NULL;
+gchar* emulConfig = NULL;
+gint sampleIntervalMs = 0;
+gint sampleBufferSize = 4096;
+gchar* traceDirectory = NULL;
+gint traceBufferSize = 65536;
+gdouble outlierPercent = 20;
+gchar* exportFormatName = NULL;
+gchar* exportPath = NULL;
+gboolean verify = FALSE;
+gint verifySeedOption = 1;
+gchar* contentSpec = NULL;
+
+// jsonl and csv events are written by the master while they are gathered
+static gboolean exporting = FALSE;
+static gboolean streaming = FALSE;
+
 gchar* sourceFileName;
 
 static gboolean group_cb(const gchar* option_name, const gchar* value, gpointer data, GError** error)
@@ -68,11 +96,24 @@ static GOptionEntry entries[] =
 {
 	{ "version", 'v', 0, G_OPTION_ARG_NONE, &version, "Shows the version of this program", NULL },
 	{ "export", 'e', 0, G_OPTION_ARG_NONE, &export, "Export timing results to XML", NULL },
+	{ "export-format", 0, 0, G_OPTION_ARG_STRING, &exportFormatName, "Export timing results as FORMAT: xml (default), jsonl or csv", "FORMAT" },
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &exportPath, "Write exported results to PATH instead of results.<format>", "PATH" },
 	{ "silent", 's', 0, G_OPTION_ARG_NONE, &silent, "Same as '-f' but will suppress printing reports to stdout", NULL },
 	{ "clean", 'c', 0, G_OPTION_ARG_NONE, &clean, "Remove all data created during benchmark", NULL },
 	{ "dry-run", 'd', 0, G_OPTION_ARG_NONE, &parseOnly, "Don't do any I/O calls", NULL },
 	{ "agile", 'a', 0, G_OPTION_ARG_NONE, &agileMode, "Toggles agile mode where sleeps will be skipped", NULL },
 	{ "wait", 'w', 0, G_OPTION_ARG_NONE, &waitForStartSignal, "Wait for signal SIGUSR1 after parsing is done", NULL },
+	{ "backend", 'b', 0, G_OPTION_ARG_STRING, &backendName, "Run the POSIX statements against backend NAME: posix (default), null (no-ops) or memfs (in-memory files) to measure the harness overhead, emul (injected latencies, see --emul-config)", "NAME" },
+	{ "emul-config", 0, 0, G_OPTION_ARG_FILENAME, &emulConfig, "Latency and bandwidth emulation settings for --backend=emul", "FILE" },
+	{ "sample-interval", 0, 0, G_OPTION_ARG_INT, &sampleIntervalMs, "Record the throughput of ctime blocks every MS milliseconds to results_ts/samples_<rank>.csv", "MS" },
+	{ "sample-buffer", 0, 0, G_OPTION_ARG_INT, &sampleBufferSize, "Number of intervals kept per ctime block by --sample-interval (default 4096)", "N" },
+	{ "trace", 't', 0, G_OPTION_ARG_FILENAME, &traceDirectory, "Record every I/O call to DIR/trace_<rank>.pbt (convert with pbtrace)", "DIR" },
+	{ "trace-buffer", 0, 0, G_OPTION_ARG_INT, &traceBufferSize, "Number of records buffered in memory by --trace (default 65536)", "N" },
+	{ "outlier", 0, 0, G_OPTION_ARG_DOUBLE, &outlierPercent, "Report processes slower than the median time by more than PCT percent as stragglers (default 20)", "PCT" },
+	{ "verify", 0, 0, G_OPTION_ARG_NONE, &verify, "Write a pattern instead of zeros and check all data that is read back", NULL },
+	{ "verify-seed", 0, 0, G_OPTION_ARG_INT, &verifySeedOption, "Seed of the --verify pattern, has to match between writing and reading runs (default 1)", "N" },
+	{ "content", 0, 0, G_OPTION_ARG_STRING, &contentSpec, "Data written by the write statements: zeros (default), random, compress:RATIO or dedup:RATIO[:BLOCKSIZE]", "MODE" },
+	{ "module", 'm', 0, G_OPTION_ARG_FILENAME_ARRAY, &modulePaths, "Load statements from the plugin PATH (may be given multiple times)", "PATH" },
 	{ "group", 'g', 0, G_OPTION_ARG_CALLBACK, group_cb, "Set number of processes to SIZE from group NAME. Default value of SIZE is 0 if group size is not set on command line. Read the manual for mapping tags.", "NAME[:SIZE]" },
 	{ NULL }
 };
@@ -97,7 +138,7 @@ void parse_parameters(int* argc, char*** argv) {
 #ifdef HAVE_MPI
 void create_mpitype_timeevent() { 
 	MPI_Datatype type[3] = {MPI_INT, MPI_DOUBLE, MPI_CHAR};
-	int          blocklen[3] = {2, 1, NAME_SIZE};
+	int          blocklen[3] = {2, 3, NAME_SIZE};
 	MPI_Aint	 disp[3];
 	MPI_Aint	 extent;
 	
@@ -108,34 +149,12 @@ void create_mpitype_timeevent() {
 	disp[1] = 2 * extent;
 	/* Setup description of char */
 	MPI_Type_extent(MPI_DOUBLE, &extent);
-	disp[2] = disp[1] + 1 * extent;
+	disp[2] = disp[1] + 3 * extent;
 	
 	MPI_Type_struct(3, blocklen, disp, type, &timeevent_type); 
 	MPI_Type_commit(&timeevent_type);
 }
 
-void create_mpitype_coretimeevent() {
-	MPI_Datatype type[4] = {MPI_INT, MPI_DOUBLE, MPI_LONG, MPI_CHAR};
-	int          blocklen[4] = {2, 1, 1, NAME_SIZE};
-	MPI_Aint	 disp[4];
-	MPI_Aint	 extent;
-
-	/* Setup description of int */
-	disp[0] = 0;
-	/* Setup description of double */
-	MPI_Type_extent(MPI_INT, &extent);
-	disp[1] = 2 * extent;
-	/* Setup description of long */
-	MPI_Type_extent(MPI_DOUBLE, &extent);
-	disp[2] = disp[1] + 1 * extent;
-	/* Setup description of char */
-	MPI_Type_extent(MPI_LONG, &extent);
-	disp[3] = disp[2] + 1 * extent;
-
-	MPI_Type_struct(4, blocklen, disp, type, &coretimeevent_type);
-	MPI_Type_commit(&coretimeevent_type);
-}
-
 void gather_timeevents() {
 	// TODO: MPI_Gatherv
 	int i, j;
@@ -145,6 +164,9 @@ void gather_timeevents() {
 	GSList *iter;
 	
 	if(rank == MASTER) {
+		if(streaming)
+			g_slist_foreach(timeList, (GFunc) export_time_event, NULL);
+
 		for(i=1; i<size; i++) {
 			MPI_Recv(&num, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &stat);
 			//printf("received num = %d from rank %d\n", num, i);
@@ -155,6 +177,9 @@ void gather_timeevents() {
 				MPI_Recv(buf, 1, timeevent_type, i, 2, MPI_COMM_WORLD, &stat);
 				//printf("TimeEvent(%d, %d, %s, %f)\n", bufr->proc, bufr->id, bufr->name, bufr->value);
 				timeList = g_slist_prepend(timeList, buf);
+
+				if(streaming)
+					export_time_event(buf);
 			}
 		}
 	}
@@ -172,6 +197,7 @@ void gather_timeevents() {
 
 void gather_coretimeevents() {
 	// TODO: MPI_Gatherv
+	// CoreTimeEvents are sent as raw bytes, all ranks share the same layout
 	int i, j;
 	MPI_Status stat;
 	CoreTimeEvent* buf;
@@ -179,6 +205,9 @@ void gather_coretimeevents() {
 	GSList *iter;
 
 	if(rank == MASTER) {
+		if(streaming)
+			g_slist_foreach(coreTimeList, (GFunc) export_coretime_event, NULL);
+
 		for(i=1; i<size; i++) {
 			MPI_Recv(&num, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &stat);
 			//printf("received num = %d from rank %d\n", num, i);
@@ -186,10 +215,13 @@ void gather_coretimeevents() {
 			for(j=0; j<num; j++) {
 				buf = (CoreTimeEvent*) malloc(sizeof(CoreTimeEvent));
 
-				MPI_Recv(buf, 1, timeevent_type, i, 2, MPI_COMM_WORLD, &stat);
+				MPI_Recv(buf, sizeof(CoreTimeEvent), MPI_BYTE, i, 2, MPI_COMM_WORLD, &stat);
 				//printf("CoreTimeEvent(%d, %d, %s, %f, %ld)\n", buf->proc, buf->id,
 				//		buf->name, buf->coreTime.time, buf->coreTime.data);
 				coreTimeList = g_slist_prepend(coreTimeList, buf);
+
+				if(streaming)
+					export_coretime_event(buf);
 			}
 		}
 	}
@@ -200,7 +232,83 @@ void gather_coretimeevents() {
 		iter = coreTimeList;
 		for(;iter;iter=g_slist_next(iter)) {
 			buf = (CoreTimeEvent*) iter->data;
-			MPI_Send(buf, 1, timeevent_type, MASTER, 2, MPI_COMM_WORLD);
+			MPI_Send(buf, sizeof(CoreTimeEvent), MPI_BYTE, MASTER, 2, MPI_COMM_WORLD);
+		}
+	}
+}
+
+void gather_phaseevents() {
+	// phase events only exist on group masters, most ranks send nothing
+	int i, j;
+	MPI_Status stat;
+	PhaseEvent* buf;
+	int num;
+	GSList *iter;
+
+	if(rank == MASTER) {
+		if(streaming)
+			g_slist_foreach(phaseList, (GFunc) export_phase_event, NULL);
+
+		for(i=1; i<size; i++) {
+			MPI_Recv(&num, 1, MPI_INT, i, 4, MPI_COMM_WORLD, &stat);
+
+			for(j=0; j<num; j++) {
+				buf = (PhaseEvent*) g_malloc(sizeof(PhaseEvent));
+
+				MPI_Recv(buf, sizeof(PhaseEvent), MPI_BYTE, i, 5, MPI_COMM_WORLD, &stat);
+				phaseList = g_slist_append(phaseList, buf);
+
+				if(streaming)
+					export_phase_event(buf);
+			}
+		}
+	}
+	else {
+		num = g_slist_length(phaseList);
+		MPI_Send(&num, 1, MPI_INT, MASTER, 4, MPI_COMM_WORLD);
+
+		iter = phaseList;
+		for(;iter;iter=g_slist_next(iter)) {
+			buf = (PhaseEvent*) iter->data;
+			MPI_Send(buf, sizeof(PhaseEvent), MPI_BYTE, MASTER, 5, MPI_COMM_WORLD);
+		}
+	}
+}
+
+void gather_statevents() {
+	// StatEvents are sent as raw bytes like core time events
+	int i, j;
+	MPI_Status stat;
+	StatEvent* buf;
+	int num;
+	GSList *iter;
+
+	if(rank == MASTER) {
+		if(streaming)
+			g_slist_foreach(statList, (GFunc) export_stat_event, NULL);
+
+		for(i=1; i<size; i++) {
+			MPI_Recv(&num, 1, MPI_INT, i, 6, MPI_COMM_WORLD, &stat);
+
+			for(j=0; j<num; j++) {
+				buf = (StatEvent*) g_malloc(sizeof(StatEvent));
+
+				MPI_Recv(buf, sizeof(StatEvent), MPI_BYTE, i, 7, MPI_COMM_WORLD, &stat);
+				statList = g_slist_prepend(statList, buf);
+
+				if(streaming)
+					export_stat_event(buf);
+			}
+		}
+	}
+	else {
+		num = g_slist_length(statList);
+		MPI_Send(&num, 1, MPI_INT, MASTER, 6, MPI_COMM_WORLD);
+
+		iter = statList;
+		for(;iter;iter=g_slist_next(iter)) {
+			buf = (StatEvent*) iter->data;
+			MPI_Send(buf, sizeof(StatEvent), MPI_BYTE, MASTER, 7, MPI_COMM_WORLD);
 		}
 	}
 }
@@ -227,6 +335,19 @@ void gather_commandstats() {
 		MPI_Send(statementsSucceed, NUM_TRAC_STATEMENTS, MPI_INT, MASTER, 3, MPI_COMM_WORLD);
 		MPI_Send(statementsFail, NUM_TRAC_STATEMENTS, MPI_INT, MASTER, 3, MPI_COMM_WORLD);
 	}
+
+	// module statements are registered in the same order on all ranks
+	for(j=0; j<moduleStatements->len; j++) {
+		ModuleStatementDesc* desc = g_ptr_array_index(moduleStatements, j);
+		int local[2] = { desc->succeed, desc->fail };
+		int global[2];
+
+		MPI_Reduce(local, global, 2, MPI_INT, MPI_SUM, MASTER, MPI_COMM_WORLD);
+		if(rank == MASTER) {
+			desc->succeed = global[0];
+			desc->fail = global[1];
+		}
+	}
 }
 #endif
 
@@ -320,106 +441,6 @@ void export_coretime_csv() {
 	}
 }
 
-void export_xml(const gchar* kernelName) {
-	gchar* date = date_str();
-	gchar* time = time_str();
-
-	XmlDocument* doc = xml_document_new();
-	xml_start_element(doc, "Report");
-	xml_add_attribute_string(doc, "date", date);
-	xml_add_attribute_string(doc, "time", time);
-	xml_add_attribute_int(doc, "size", size);
-	xml_add_attribute_string(doc, "kernel", kernelName);
-
-	g_free(date);
-	g_free(time);
-
-
-	/* write core time events */
-	GSList* list = g_slist_copy(coreTimeList);
-	list = g_slist_sort(list, compare_coretime_events_full);
-	GSList *iter = list;
-
-	xml_start_element(doc, "EventList");
-	xml_add_attribute_string(doc, "type", "CoreTime");
-
-	for (;iter;iter=g_slist_next(iter)) {
-		CoreTimeEvent* event = iter->data;
-
-		CoreTime avgCoreTime = event->avgCoreTime;
-		CoreTime minCoreTime = event->minCoreTime;
-		CoreTime maxCoreTime = event->maxCoreTime;
-		gdouble avgTP = (avgCoreTime.time? avgCoreTime.data/avgCoreTime.time : 0);
-		gdouble minTP = (minCoreTime.time? minCoreTime.data/minCoreTime.time : 0);
-		gdouble maxTP = (maxCoreTime.time? maxCoreTime.data/maxCoreTime.time : 0);
-		gdouble avgTime = (event->numCalls? event->avgCoreTime.time/event->numCalls : 0);
-		gdouble minTime = event->minCallTime;
-		gdouble maxTime = event->maxCallTime;
-		glong ioops = (event->numCalls>0? event->numCalls/event->avgCoreTime.time : 0);
-
-		/* write xml */
-		xml_start_element(doc, "Event");
-		xml_add_attribute_int(doc, "rank", event->proc);
-		xml_add_attribute_int(doc, "id", event->id);
-		xml_add_attribute_string(doc, "name", event->name);
-
-		xml_start_element(doc, "Throughput");
-		xml_add_attribute_double(doc, "avg", avgTP);
-		xml_add_attribute_double(doc, "min", minTP);
-		xml_add_attribute_double(doc, "max", maxTP);
-		xml_end_element(doc);
-
-		xml_start_element(doc, "Calltime");
-		xml_add_attribute_double(doc, "avg", avgTime);
-		xml_add_attribute_double(doc, "min", minTime);
-		xml_add_attribute_double(doc, "max", maxTime);
-		xml_end_element(doc);
-
-		xml_start_element(doc, "Requests");
-		xml_add_attribute_long(doc, "num", event->numCalls);
-		xml_add_attribute_double(doc, "time", avgCoreTime.time);
-		xml_add_attribute_long(doc, "ioops", ioops);
-		xml_end_element(doc);
-
-		xml_end_element(doc); // <Event>
-	}
-	xml_end_element(doc); // <EventList>
-	g_slist_free(list);
-
-
-	/* write time events */
-	list = g_slist_copy(timeList);
-	list = g_slist_sort(list, compare_time_events_full);
-	iter = list;
-
-	xml_start_element(doc, "EventList");
-	xml_add_attribute_string(doc, "type", "Time");
-
-	for (;iter;iter=g_slist_next(iter)) {
-		TimeEvent* event = iter->data;
-
-		/* write xml */
-		xml_start_element(doc, "Event");
-		xml_add_attribute_int(doc, "rank", event->proc);
-		xml_add_attribute_int(doc, "id", event->id);
-		xml_add_attribute_string(doc, "name", event->name);
-
-		xml_start_element(doc, "Walltime");
-		xml_add_attribute_double(doc, "value", event->value);
-		xml_end_element(doc);
-
-		xml_end_element(doc); // <Event>
-	}
-	xml_end_element(doc); // <EventList>
-	g_slist_free(list);
-
-
-	xml_end_element(doc); // <Report>
-
-	xml_document_save(doc, "results.xml");
-	xml_document_free(doc);
-}
-
 static void quit()
 {
 #ifdef HAVE_MPI
@@ -452,6 +473,7 @@ void delayStart()
 int main(int argc, char **argv) {
 	GTimer* timer = g_timer_new();
 	gdouble setupTime, parserTime, interpreterTime, finalizeTime;
+	ExportFormat exportFormat = EXPORT_XML;
 	
 #ifdef HAVE_MPI
 	// init mpi
@@ -481,6 +503,67 @@ int main(int argc, char **argv) {
 	if (waitForStartSignal && (rank != MASTER))
 		signal(SIGUSR1, SIG_IGN);
 	
+	// an emulation config implies the emulation backend
+	if (emulConfig && !backendName)
+		backendName = g_strdup("emul");
+
+	if (backendName) {
+		if (!iio_engine_select(backendName)) {
+			if (rank == MASTER)
+				printf("Unknown backend %s, use posix, null, memfs or emul!\n", backendName);
+			quit();
+		}
+		g_free(backendName);
+	}
+
+	if (ioEngine == &emulEngine) {
+		if (!iio_emul_configure(emulConfig)) {
+			if (rank == MASTER)
+				printf("Invalid emulation config %s!\n", emulConfig);
+			quit();
+		}
+		g_free(emulConfig);
+	}
+
+	if (sampleIntervalMs < 0 || (sampleIntervalMs > 0 && sampleBufferSize < 1)) {
+		if (rank == MASTER)
+			printf("Invalid sampling parameters, interval and buffer size need to be positive!\n");
+		quit();
+	}
+
+	if (outlierPercent < 0) {
+		if (rank == MASTER)
+			printf("Invalid outlier threshold, it must not be negative!\n");
+		quit();
+	}
+
+	if (traceDirectory && traceBufferSize < 1) {
+		if (rank == MASTER)
+			printf("Invalid trace buffer size, it needs to be positive!\n");
+		quit();
+	}
+
+	if (exportFormatName && !export_format_parse(exportFormatName, &exportFormat)) {
+		if (rank == MASTER)
+			printf("Unknown export format %s, use xml, jsonl or csv!\n", exportFormatName);
+		quit();
+	}
+
+	if (contentSpec && verify) {
+		if (rank == MASTER)
+			printf("--content can't be combined with --verify, which writes its own pattern!\n");
+		quit();
+	}
+
+	if (contentSpec) {
+		if (!content_configure(contentSpec)) {
+			if (rank == MASTER)
+				printf("Invalid content %s, use zeros, random, compress:RATIO or dedup:RATIO[:BLOCKSIZE]!\n", contentSpec);
+			quit();
+		}
+		g_free(contentSpec);
+	}
+
 	if (version) {
 		if(rank == MASTER) {
 			printf("ParaBench v%s\n\n", VERSION);
@@ -499,6 +582,15 @@ int main(int argc, char **argv) {
 	sourceFileName = argv[1];
 	FILE *file = fopen(argv[1], "r");
 	iiInit(file);
+
+	// modules need to be registered before the scanner runs
+	if (modulePaths) {
+		gchar** path;
+		for (path = modulePaths; *path; path++)
+			if (!module_load(*path))
+				Error("Module %s couldn't be loaded!", *path);
+		g_strfreev(modulePaths);
+	}
 		
 	if(file == NULL) {
 		printf("[%d] File %s doesn't exist!\n", rank, argv[argc-1]);
@@ -525,30 +617,106 @@ int main(int argc, char **argv) {
 	if (waitForStartSignal)
 		delayStart();
 
+	// module setup and teardown stay out of the measured interpreter time
+	if (!modules_start())
+		Error("Module initialization failed!");
+
+	// all event timestamps are relative to the kernel start on the master
+	clock_sync();
+	clock_start();
+
+	if (verify)
+		verify_init(verifySeedOption);
+
+	// ring buffers are allocated per ctime block
+	if (sampleIntervalMs > 0)
+		sampler_configure(sampleIntervalMs, sampleBufferSize);
+
+	if (traceDirectory && !parseOnly && !trace_start(traceDirectory, traceBufferSize))
+		Error("Trace couldn't be started in %s!", traceDirectory);
+
 	g_timer_start(timer);
 
 	iiStart();
 	
 	interpreterTime = g_timer_elapsed(timer, NULL);
+
+	trace_stop();
+	g_free(traceDirectory);
+
+	modules_finish();
 	g_timer_start(timer);
 
+	if (!parseOnly && sampleIntervalMs > 0)
+		sampler_export("./results_ts");
+
+	// choosing a format or an output file implies --export
+	exporting = !parseOnly && (export || silent || exportFormatName || exportPath);
+	if (exporting) {
+		export_gather_hosts();
+
+		if (rank == MASTER) {
+			const gchar* path = (exportPath? exportPath : export_default_path(exportFormat));
+
+			if (export_open(exportFormat, path))
+				export_run(argv[1], argc - 2, &argv[2]);
+			else {
+				Warning("Results couldn't be exported to %s!", path);
+				exporting = FALSE;
+			}
+		}
+		streaming = exporting && export_streaming();
+	}
+
 #ifdef HAVE_MPI
 	MPI_Barrier(MPI_COMM_WORLD);
-	
+
+	// needs the local time events, so it runs before they are gathered
+	outlierThreshold = outlierPercent;
+	imbalance_analyze();
+
 	gather_timeevents();
 	gather_coretimeevents();
+	gather_phaseevents();
+	gather_statevents();
 	gather_commandstats();
+	verify_reduce();
+	stage_reduce();
+	aggregate_reduce();
+
+	gdouble clockStats[2] = { ABS(clockOffset), clockError };
+	gdouble maxClockStats[2];
+	MPI_Reduce(clockStats, maxClockStats, 2, MPI_DOUBLE, MPI_MAX, MASTER, MPI_COMM_WORLD);
+#else
+	if (streaming) {
+		g_slist_foreach(timeList, (GFunc) export_time_event, NULL);
+		g_slist_foreach(coreTimeList, (GFunc) export_coretime_event, NULL);
+		g_slist_foreach(phaseList, (GFunc) export_phase_event, NULL);
+		g_slist_foreach(statList, (GFunc) export_stat_event, NULL);
+	}
 #endif
+
+	if (rank == MASTER && exporting) {
+		if (!streaming)
+			export_events();
+		export_close();
+	}
+	g_free(exportFormatName);
+	g_free(exportPath);
 	
 	if(rank == MASTER) {
 		if(!silent) {
 			iiTimeReport();
 			iiCoreTimeReport();
+			iiStatReport();
+			iiSkewReport();
+			iiImbalanceReport();
+			iiPhaseReport();
+			iiVerifyReport();
+			iiStageReport();
+			iiAggregateReport();
 			iiCommandReport();
 		}
-		
-		if(!parseOnly && (export || silent))
-			export_xml(argv[1]);
 	}
 	
 	if(!parseOnly && clean)
@@ -564,6 +732,7 @@ int main(int argc, char **argv) {
 #endif
 	
 	iiFree();
+	content_free();
 #ifdef HAVE_MPI
 	groups_free();
 #endif
@@ -581,6 +750,16 @@ int main(int argc, char **argv) {
 		g_printf("Parser:       %14.6fs    %5.1f%%\n", parserTime, parserTime/globalTime*100);
 		g_printf("Interpreter:  %14.6fs    %5.1f%%\n", interpreterTime, interpreterTime/globalTime*100);
 		g_printf("Finalize:     %14.6fs    %5.1f%%\n", finalizeTime, finalizeTime/globalTime*100);
+
+		if (ioEngine != &posixEngine)
+			g_printf("\nI/O backend:  %s\n", ioEngine->name);
+
+#ifdef HAVE_MPI
+		if (clockGlobal)
+			g_printf("\nClock sync:   MPI_Wtime is global\n");
+		else if (size > 1)
+			g_printf("\nClock sync:   max offset %.6fs, max error %.6fs\n", maxClockStats[0], maxClockStats[1]);
+#endif
 	}
 
 	return 0;
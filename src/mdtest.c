@@ -0,0 +1,217 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "mdtest.h"
+#include "phases.h"
+#include "iio_posix.h"
+
+/*
+ * Metadata storm in the style of mdtest. The tree nodes are numbered in
+ * breadth first order, so the children of node n are n*branch+1 up to
+ * n*branch+branch. Every process creates, stats, reads and removes its own
+ * items in every node. The phases are separated by barriers and reduced to
+ * the group master (see phases.c).
+ */
+
+typedef struct {
+	const MdtestParams* params;
+	GPtrArray* nodes;		// node paths in creation order
+	gboolean tree;			// this process creates/removes the tree
+	gboolean success;
+} Mdtest;
+
+
+static void mdtest_account(Mdtest* md, IOStatus ioStatus, glong* ops, glong* data)
+{
+	dump_coretime(coreTimeStack, ioStatus.coreTime);
+
+	if (ioStatus.success) {
+		(*ops)++;
+		if (data) (*data) += ioStatus.coreTime.data;
+	}
+	else md->success = FALSE;
+}
+
+static GPtrArray* mdtest_tree_new(const gchar* root, const MdtestParams* params)
+{
+	GPtrArray* nodes = g_ptr_array_new();
+	glong i, num = 1, width = 1;
+
+	for (i=0; i<params->depth; i++) {
+		width *= params->branch;
+		num += width;
+	}
+
+	g_ptr_array_add(nodes, g_strdup_printf("%s/mdtest_tree.0", root));
+	for (i=1; i<num; i++) {
+		const gchar* parent = g_ptr_array_index(nodes, (i-1) / params->branch);
+		g_ptr_array_add(nodes, g_strdup_printf("%s/mdtest_tree.%ld", parent, i));
+	}
+
+	return nodes;
+}
+
+static void mdtest_tree_free(GPtrArray* nodes)
+{
+	g_ptr_array_foreach(nodes, (GFunc) g_free, NULL);
+	g_ptr_array_free(nodes, TRUE);
+}
+
+static void mdtest_tree_create(Mdtest* md, PhaseContext* ctx)
+{
+	glong i, ops = 0;
+
+	phase_begin(ctx);
+	if (md->tree) {
+		for (i=0; i<md->nodes->len; i++)
+			mdtest_account(md, iio_mkdir(g_ptr_array_index(md->nodes, i)), &ops, NULL);
+	}
+	phase_end(ctx, "tree create", ops, 0);
+}
+
+static void mdtest_tree_remove(Mdtest* md, PhaseContext* ctx)
+{
+	glong i, ops = 0;
+
+	phase_begin(ctx);
+	if (md->tree) {
+		for (i=md->nodes->len-1; i>=0; i--)
+			mdtest_account(md, iio_rmdir(g_ptr_array_index(md->nodes, i)), &ops, NULL);
+	}
+	phase_end(ctx, "tree remove", ops, 0);
+}
+
+typedef enum {
+	MD_DIR_CREATE, MD_DIR_STAT, MD_DIR_REMOVE,
+	MD_FILE_CREATE, MD_FILE_STAT, MD_FILE_READ, MD_FILE_REMOVE
+} MdtestOp;
+
+static const gchar* mdtest_op_names[] = {
+	"dir create", "dir stat", "dir remove",
+	"file create", "file stat", "file read", "file remove"
+};
+
+static IOStatus mdtest_item(Mdtest* md, MdtestOp op, const gchar* path)
+{
+	const MdtestParams* params = md->params;
+
+	switch (op) {
+		case MD_DIR_CREATE:  return iio_mkdir(path);
+		case MD_DIR_REMOVE:  return iio_rmdir(path);
+		case MD_DIR_STAT:
+		case MD_FILE_STAT:   return iio_stat(path);
+		case MD_FILE_REMOVE: return iio_delete(path);
+
+		case MD_FILE_CREATE:
+			if (params->size > 0)
+				return iio_write(path, params->size, 0);
+			return iio_create(path);
+
+		case MD_FILE_READ: {
+			if (params->size > 0)
+				return iio_read(path, params->size, 0);
+
+			// empty files: open/close is all there is to read
+			File* file;
+			IOStatus open = iio_fopen(path, O_RDONLY, &file);
+			if (!open.success)
+				return open;
+
+			IOStatus close = iio_fclose(file);
+			close.coreTime.time += open.coreTime.time;
+			return close;
+		}
+	}
+
+	return iostatus_new(FALSE, 0, 0);
+}
+
+static void mdtest_items(Mdtest* md, PhaseContext* ctx, MdtestOp op)
+{
+	const gchar* prefix = (op < MD_FILE_CREATE)? "dir" : "file";
+	glong ops = 0, data = 0;
+	gint i, j;
+
+	phase_begin(ctx);
+	for (i=0; i<md->nodes->len; i++) {
+		for (j=0; j<md->params->items; j++) {
+			gchar* path = g_strdup_printf("%s/%s.%d.%d",
+					(gchar*) g_ptr_array_index(md->nodes, i), prefix, rank, j);
+			mdtest_account(md, mdtest_item(md, op, path), &ops, &data);
+			g_free(path);
+		}
+	}
+	phase_end(ctx, mdtest_op_names[op], ops, data);
+}
+
+/**
+ * Runs all mdtest phases below path. Has to be called collectively by all
+ * processes of the active group. Returns FALSE if any operation failed.
+ */
+gboolean mdtest_run(const gchar* path, const MdtestParams* params)
+{
+	g_assert(params->depth >= 0);
+	g_assert(params->branch > 0 || params->depth == 0);
+
+	Mdtest md;
+	PhaseContext ctx;
+	MdtestOp op;
+	gchar* root;
+
+	phase_context_init(&ctx, "mdtest");
+
+	md.params = params;
+	md.success = TRUE;
+
+	if (params->unique) {
+		root = g_strdup_printf("%s/mdtest.%d", path, rank);
+		md.tree = TRUE;
+	}
+	else {
+		gint groupRank = 0;
+#ifdef HAVE_MPI
+		MPI_Comm_rank(ctx.comm, &groupRank);
+#endif
+		root = g_strdup_printf("%s/mdtest.shared", path);
+		md.tree = (groupRank == MASTER);
+	}
+
+	Verbose("(Mdtest) root = %s, depth = %d, branch = %d, items = %d",
+			root, params->depth, params->branch, params->items);
+
+	if (md.tree && !iio_mkdir(root).success)
+		Warning("(Mdtest) Couldn't create root directory \"%s\"", root);
+
+	md.nodes = mdtest_tree_new(root, params);
+
+	mdtest_tree_create(&md, &ctx);
+	for (op=MD_DIR_CREATE; op<=MD_FILE_REMOVE; op++)
+		mdtest_items(&md, &ctx, op);
+	mdtest_tree_remove(&md, &ctx);
+
+	if (md.tree)
+		iio_rmdir(root);
+
+	mdtest_tree_free(md.nodes);
+	phase_context_free(&ctx);
+	g_free(root);
+
+	return md.success;
+}
@@ -0,0 +1,37 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MDTEST_H_
+#define MDTEST_H_
+
+#include "iio.h"
+
+#include <glib.h>
+
+typedef struct {
+	gint depth;			// depth of the directory tree (0 = only the root node)
+	gint branch;		// number of subdirectories per tree node
+	gint items;			// number of files and directories per node and process
+	gboolean unique;	// every process works in its own tree
+	glong size;			// bytes written on file create and read back afterwards
+} MdtestParams;
+
+
+gboolean mdtest_run(const gchar* path, const MdtestParams* params);
+
+#endif /* MDTEST_H_ */
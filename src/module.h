@@ -0,0 +1,101 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MODULE_H_
+#define MODULE_H_
+
+/*
+ * Plugin ABI for runtime loadable I/O modules (--module path.so).
+ *
+ * A plugin exports a single function
+ *
+ *     const ModuleInfo* parabench_module_info();
+ *
+ * which describes the statements it adds to PBL. Every statement has a
+ * lowercase name (letters only, no built-in keyword), a list of typed
+ * parameters and a handler returning an IOStatus, just like the iio_*
+ * functions. Plugins may call the host functions iostatus_new(), Log(),
+ * Warning() and use the CORETIME_START/CORETIME_STOP macros.
+ *
+ * Modules wrapping a client library can keep state across statements:
+ * - init() runs once per process before the kernel is executed and may
+ *   return a module context, finalize() runs after the kernel finished.
+ *   Neither is part of any timed region.
+ * - MODULE_STMT_OPEN statements are used as "$h = name(...);" and return
+ *   a module owned handle, which is stored in a file handle variable and
+ *   passed back to the module by MODULE_PARAM_HANDLE parameters.
+ * - MODULE_STMT_CLOSE statements release the handle given as first
+ *   parameter; the variable is destroyed on success. Handles that are
+ *   still open when the kernel ends are given to release().
+ *
+ * The ABI version has to be increased on every incompatible change of the
+ * structures below; the host refuses plugins with a different version.
+ */
+
+#include "iio.h"
+
+#include <glib.h>
+
+#define PARABENCH_MODULE_ABI_VERSION 2
+#define PARABENCH_MODULE_ENTRY "parabench_module_info"
+
+typedef enum {
+	MODULE_PARAM_INT,		// integer expression, passed as glong
+	MODULE_PARAM_STRING,	// string expression with $variables replaced
+	MODULE_PARAM_HANDLE		// handle variable returned by a statement of the same module
+} ModuleParamType;
+
+typedef union {
+	glong num;
+	const gchar* str;
+	gpointer handle;
+} ModuleParam;
+
+typedef enum {
+	MODULE_STMT_COMMAND,	// name(params);
+	MODULE_STMT_OPEN,		// $h = name(params); the handler stores the new handle in *result
+	MODULE_STMT_CLOSE		// name($h, params); the handle is gone after success
+} ModuleStatementKind;
+
+/* context is the pointer returned by init(), result is only set for MODULE_STMT_OPEN */
+typedef IOStatus (*ModuleHandler)(gpointer context, const ModuleParam* params, gpointer* result);
+typedef gboolean (*ModuleInitFunc)(gpointer* context);
+typedef void (*ModuleFinalizeFunc)(gpointer context);
+typedef void (*ModuleReleaseFunc)(gpointer context, gpointer handle);
+
+typedef struct {
+	const gchar* name;					// statement keyword in PBL
+	ModuleStatementKind kind;
+	const ModuleParamType* paramTypes;	// type of every parameter
+	gint numParams;						// number of parameters (without the assigned handle)
+	ModuleHandler handler;				// called once per statement execution
+} ModuleStatement;
+
+typedef struct {
+	gint abiVersion;					// PARABENCH_MODULE_ABI_VERSION
+	const gchar* name;					// module name used in messages
+	const ModuleStatement* statements;	// statements provided by the module
+	gint numStatements;
+	ModuleInitFunc init;				// optional, called before the kernel runs
+	ModuleFinalizeFunc finalize;		// optional, called after the kernel finished
+	ModuleReleaseFunc release;			// optional, frees handles left open by the kernel
+} ModuleInfo;
+
+typedef const ModuleInfo* (*ModuleInfoFunc)();
+
+#endif /* MODULE_H_ */
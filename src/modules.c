@@ -0,0 +1,347 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "modules.h"
+#include "statements.h"
+#include <string.h>
+
+// scanner keywords that don't name a statement (see stmt_get_string)
+static const gchar* scannerKeywords[] = { "warmup", "confidence", "groups", "pattern", "param", NULL };
+
+
+void modules_init()
+{
+	moduleList = NULL;
+	moduleStatements = g_ptr_array_new();
+	moduleStatementMap = g_hash_table_new(g_str_hash, g_str_equal);
+}
+
+void modules_free()
+{
+	g_hash_table_destroy(moduleStatementMap);
+	g_ptr_array_foreach(moduleStatements, (GFunc) g_free, NULL);
+	g_ptr_array_free(moduleStatements, TRUE);
+
+	if (moduleList) {
+		GSList* cur;
+		for (cur=moduleList; cur; cur=cur->next) {
+			Module* module = cur->data;
+			g_module_close(module->gmodule);
+			g_free(module);
+		}
+		g_slist_free(moduleList);
+	}
+}
+
+/**
+ * Runs the init hooks of all loaded modules. Called once per process
+ * before the kernel is executed, outside of any timed region.
+ */
+gboolean modules_start()
+{
+	GSList* cur;
+
+	for (cur=moduleList; cur; cur=cur->next) {
+		Module* module = cur->data;
+
+		if (module->info->init && !module->info->init(&module->context)) {
+			Warning("(Module) %s: initialization failed", module->info->name);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Releases handles the kernel didn't close and runs the finalize hooks
+ * in reverse load order.
+ */
+void modules_finish()
+{
+	GSList* reversed = g_slist_reverse(g_slist_copy(moduleList));
+	GSList* cur;
+
+	for (cur=reversed; cur; cur=cur->next) {
+		Module* module = cur->data;
+
+		while (module->handles) {
+			File* file = module->handles->data;
+			ModuleHandle* handle = file->handle.modfh;
+
+			Verbose("(Module) %s: releasing open handle %p", module->info->name, handle->handle);
+			if (module->info->release)
+				module->info->release(module->context, handle->handle);
+			module_handle_close(file);
+		}
+
+		if (module->info->finalize)
+			module->info->finalize(module->context);
+		module->context = NULL;
+	}
+
+	g_slist_free(reversed);
+}
+
+/**
+ * Statement names are matched by the scanner's keyword fallback, so they
+ * may only consist of letters. They are stored lowercase since the
+ * scanner is case insensitive.
+ */
+static gboolean module_name_valid(const gchar* name)
+{
+	const gchar* c;
+
+	if (!name || !*name)
+		return FALSE;
+
+	for (c=name; *c; c++)
+		if (!g_ascii_islower(*c))
+			return FALSE;
+
+	return TRUE;
+}
+
+/**
+ * The scanner matches its keywords before the module fallback, so a
+ * statement named like one of them could never be reached.
+ */
+static gboolean module_name_reserved(const gchar* name)
+{
+	StatementType type;
+	gint i;
+
+	for (type=0; type<__STMT_NUM__; type++)
+		if (g_ascii_strcasecmp(name, stmt_get_string(type)) == 0)
+			return TRUE;
+
+	for (i=0; scannerKeywords[i]; i++)
+		if (strcmp(name, scannerKeywords[i]) == 0)
+			return TRUE;
+
+	return FALSE;
+}
+
+static gboolean module_statement_valid(const ModuleInfo* info, const ModuleStatement* statement)
+{
+	gint j;
+
+	if (!module_name_valid(statement->name)) {
+		Warning("(Module) %s: invalid statement name \"%s\" (lowercase letters only)",
+				info->name, statement->name);
+		return FALSE;
+	}
+
+	if (module_name_reserved(statement->name)) {
+		Warning("(Module) %s: statement \"%s\" is a built-in keyword", info->name, statement->name);
+		return FALSE;
+	}
+
+	if (g_hash_table_lookup(moduleStatementMap, statement->name)) {
+		Warning("(Module) %s: statement \"%s\" is already registered", info->name, statement->name);
+		return FALSE;
+	}
+
+	if (!statement->handler || statement->numParams < 0) {
+		Warning("(Module) %s: statement \"%s\" is incomplete", info->name, statement->name);
+		return FALSE;
+	}
+
+	if (statement->kind != MODULE_STMT_COMMAND && statement->kind != MODULE_STMT_OPEN
+			&& statement->kind != MODULE_STMT_CLOSE) {
+		Warning("(Module) %s: statement \"%s\" has unknown kind", info->name, statement->name);
+		return FALSE;
+	}
+
+	if (statement->kind == MODULE_STMT_CLOSE
+			&& (statement->numParams < 1 || statement->paramTypes[0] != MODULE_PARAM_HANDLE)) {
+		Warning("(Module) %s: closing statement \"%s\" needs a handle as first parameter",
+				info->name, statement->name);
+		return FALSE;
+	}
+
+	for (j=0; j<statement->numParams; j++) {
+		if (statement->paramTypes[j] != MODULE_PARAM_INT && statement->paramTypes[j] != MODULE_PARAM_STRING
+				&& statement->paramTypes[j] != MODULE_PARAM_HANDLE) {
+			Warning("(Module) %s: statement \"%s\" has unknown type for parameter %d",
+					info->name, statement->name, j);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Removes the statements of module that were registered so far.
+ */
+static void module_unregister(Module* module)
+{
+	gint i;
+
+	for (i=moduleStatements->len-1; i>=0; i--) {
+		ModuleStatementDesc* desc = g_ptr_array_index(moduleStatements, i);
+
+		if (desc->module == module) {
+			g_hash_table_remove(moduleStatementMap, desc->statement->name);
+			g_ptr_array_remove_index(moduleStatements, i);
+			g_free(desc);
+		}
+	}
+}
+
+/**
+ * Registers all statements of module, or none of them if one is invalid.
+ */
+static gboolean module_register(Module* module)
+{
+	const ModuleInfo* info = module->info;
+	gint i;
+
+	for (i=0; i<info->numStatements; i++) {
+		const ModuleStatement* statement = &info->statements[i];
+
+		if (!module_statement_valid(info, statement)) {
+			module_unregister(module);
+			return FALSE;
+		}
+
+		ModuleStatementDesc* desc = g_malloc0(sizeof(ModuleStatementDesc));
+		desc->statement = statement;
+		desc->module = module;
+
+		g_ptr_array_add(moduleStatements, desc);
+		g_hash_table_insert(moduleStatementMap, (gpointer) statement->name, desc);
+		Verbose("(Module) %s: registered statement \"%s\"", info->name, statement->name);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Loads a plugin and registers its statements. Has to be called before
+ * the kernel is parsed. All processes have to load the same modules in
+ * the same order, since the command statistics are reduced by index.
+ */
+gboolean module_load(const gchar* path)
+{
+	GModule* gmodule;
+	Module* module;
+	ModuleInfoFunc infoFunc;
+	const ModuleInfo* info;
+
+	if (!g_module_supported()) {
+		Warning("(Module) Dynamic loading is not supported on this platform");
+		return FALSE;
+	}
+
+	if (!(gmodule = g_module_open(path, G_MODULE_BIND_LOCAL))) {
+		Warning("(Module) Couldn't load \"%s\": %s", path, g_module_error());
+		return FALSE;
+	}
+
+	if (!g_module_symbol(gmodule, PARABENCH_MODULE_ENTRY, (gpointer*) &infoFunc) || !infoFunc) {
+		Warning("(Module) \"%s\" doesn't export %s()", path, PARABENCH_MODULE_ENTRY);
+		g_module_close(gmodule);
+		return FALSE;
+	}
+
+	info = infoFunc();
+
+	if (!info || info->abiVersion != PARABENCH_MODULE_ABI_VERSION) {
+		Warning("(Module) \"%s\" was built for ABI version %d, expected %d",
+				path, (info? info->abiVersion : -1), PARABENCH_MODULE_ABI_VERSION);
+		g_module_close(gmodule);
+		return FALSE;
+	}
+
+	module = g_malloc0(sizeof(Module));
+	module->gmodule = gmodule;
+	module->info = info;
+
+	// modules stay resident since statements are registered by pointer
+	g_module_make_resident(gmodule);
+	moduleList = g_slist_append(moduleList, module);
+
+	// the module stays resident, but neither its statements nor its hooks are used
+	if (!module_register(module)) {
+		moduleList = g_slist_remove(moduleList, module);
+		g_free(module);
+		return FALSE;
+	}
+
+	Verbose("(Module) Loaded \"%s\" from %s", info->name, path);
+
+	return TRUE;
+}
+
+ModuleStatementDesc* module_statement_lookup(const gchar* name)
+{
+	ModuleStatementDesc* desc;
+	gchar* lower;
+
+	if (!moduleStatementMap)
+		return NULL;
+
+	lower = g_ascii_strdown(name, -1);
+	desc = g_hash_table_lookup(moduleStatementMap, lower);
+	g_free(lower);
+
+	return desc;
+}
+
+/**
+ * Wraps a handle returned by a MODULE_STMT_OPEN statement into a File,
+ * so it can be stored in a file handle variable.
+ */
+File* module_handle_new(Module* module, gpointer handle)
+{
+	ModuleHandle* modHandle = g_malloc0(sizeof(ModuleHandle));
+	modHandle->module = module;
+	modHandle->handle = handle;
+
+	File* file = file_new(FILE_MODULE, &modHandle);
+	module->handles = g_list_prepend(module->handles, file);
+
+	return file;
+}
+
+/**
+ * Returns the module handle stored in file or NULL if the file isn't a
+ * handle of the given module.
+ */
+gpointer module_handle_get(const File* file, const Module* module)
+{
+	if (!file || file->type != FILE_MODULE)
+		return NULL;
+
+	ModuleHandle* modHandle = file->handle.modfh;
+	return (modHandle->module == module)? modHandle->handle : NULL;
+}
+
+void module_handle_close(File* file)
+{
+	g_assert(file && file->type == FILE_MODULE);
+	ModuleHandle* modHandle = file->handle.modfh;
+
+	modHandle->module->handles = g_list_remove(modHandle->module->handles, file);
+	g_free(modHandle);
+	g_free(file);
+}
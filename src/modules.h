@@ -0,0 +1,65 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MODULES_H_
+#define MODULES_H_
+
+#include "module.h"
+
+#include <glib.h>
+#include <gmodule.h>
+
+typedef struct {
+	GModule* gmodule;
+	const ModuleInfo* info;
+	gpointer context;					// returned by the init hook
+	GList* handles;						// open ModuleHandles, released after the kernel
+} Module;
+
+typedef struct {
+	Module* module;						// owner of the handle
+	gpointer handle;					// module defined handle object
+} ModuleHandle;
+
+typedef struct {
+	const ModuleStatement* statement;	// statement description of the plugin
+	Module* module;						// module the statement belongs to
+	gint succeed;						// number of successful executions
+	gint fail;							// number of failed executions
+} ModuleStatementDesc;
+
+
+GSList*     moduleList;				// loaded plugins (Module)
+GPtrArray*  moduleStatements;		// registered statements in load order (ModuleStatementDesc)
+GHashTable* moduleStatementMap;		// statement name -> ModuleStatementDesc
+
+
+void modules_init();
+void modules_free();
+
+gboolean modules_start();
+void     modules_finish();
+
+gboolean             module_load(const gchar* path);
+ModuleStatementDesc* module_statement_lookup(const gchar* name);
+
+File*    module_handle_new(Module* module, gpointer handle);
+gpointer module_handle_get(const File* file, const Module* module);
+void     module_handle_close(File* file);
+
+#endif /* MODULES_H_ */
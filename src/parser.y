@@ -38,6 +38,7 @@ void yyerror(const char *str);
 #include "groups.h"
 #include "patterns.h"
 #include "ast.h"
+#include "modules.h"
 #ifdef HAVE_MPI
   #include <mpi.h>
 #endif
@@ -53,6 +54,8 @@ void yyerror(const char *str);
 inline gboolean reverse_wrapper(GNode *node, gpointer data);
 int translate_posix_flags(gchar* str);
 void replace_posix_open_flags(ParameterList* paramList);
+void module_assert_kind(const gchar* name, gboolean assigned);
+ParameterList* sampling_params_new(Expression* count, Expression* warmup, Expression* ci);
 
 %}
 
@@ -70,16 +73,22 @@ void replace_posix_open_flags(ParameterList* paramList);
 	Group* group;
 }
 
-%token TREPEAT TTIME TCTIME TDEFINE TGROUPS TPATTERN TGROUP TMASTER TBARRIER TSLEEP TPARAM
+%token TREPEAT TWARMUP TCONFIDENCE TTIME TCTIME TDEFINE TGROUPS TPATTERN TGROUP TMASTER TBARRIER TSLEEP TCOMPUTE TPARAM
 %token TPFOPEN TPFCLOSE TPFWRITE TPFREAD
 %token TKBRACEL TKBRACER TEBRACEL TEBRACER TOBRACEL TOBRACER 
 %token TEQUAL TADD TSUB TMOD TMUL TDIV TPOW TCOMMA TSEMICOLON TCOLON TTAGS TTAGD
 
 %token <num> TPRINT TWRITE TAPPEND TREAD TLOOKUP TDELETE TMKDIR TRMDIR TCREATE TSTAT TRENAME
-%token <num> TFCREAT TFOPEN TFCLOSE TFWRITE TFREAD TFSEEK TFSYNC
-%token <num> TPWRITE TPREAD TPDELETE
+%token <num> TFCREAT TFOPEN TFCLOSE TFWRITE TFREAD TFSEEK TFSYNC TFSTAT TFCNTL
+%token <num> TLINK TSYMLINK TUNLINK TCHMOD TCHOWN
+%token <num> TFALLOCATE TFTRUNCATE TFADVISE TFSYNCRANGE TFDATASYNC TSYNCPOLICY
+%token <num> TCOPY TCOPYRANGE TSENDFILE TSPLICE TSTAGE
+%token <num> TPWRITE TPREAD TPDELETE TPFPREALLOCATE TPFSETSIZE TPFATOMIC TPFSYNC TAGGWRITE
+%token <num> TOPENDIR TCLOSEDIR TREADDIR TSTATAT TCREATEAT TUNLINKAT
+%token <num> TEVICT TDROPCACHES TEVICTSCRATCH
+%token <num> TMDTEST TCHECKPOINT
 %token <num> TDIGIT
-%token <str> TSTRING TVAR TINVAR
+%token <str> TSTRING TVAR TINVAR TMODULE
 
 /* ![ModuleHook] parser_token */
 
@@ -88,7 +97,7 @@ void replace_posix_open_flags(ParameterList* paramList);
 %type <num> Number GroupTag SubgroupTag
 %type <str> Variable Label
 %type <type> CommandIdentifier FunctionIdentifier
-%type <paramList> ParameterList
+%type <paramList> ParameterList Sampling
 %type <expr> Expression IntExpression StringExpression
 %type <list> GroupList
 %type <group> Group
@@ -268,7 +277,31 @@ RepeatStatement : TREPEAT TOBRACEL TVAR TCOMMA IntExpression TOBRACER Block {
                   }
                 ;
 
-TimeStatement : TTIME Label Block {
+// repeat <count> [warmup <count>] [confidence <percent>] for statistics per label
+Sampling : TREPEAT IntExpression {
+             $$ = sampling_params_new($2, NULL, NULL);
+           }
+         | TREPEAT IntExpression TWARMUP IntExpression {
+             $$ = sampling_params_new($2, $4, NULL);
+           }
+         | TREPEAT IntExpression TCONFIDENCE IntExpression {
+             $$ = sampling_params_new($2, NULL, $4);
+           }
+         | TREPEAT IntExpression TWARMUP IntExpression TCONFIDENCE IntExpression {
+             $$ = sampling_params_new($2, $4, $6);
+           }
+         ;
+
+TimeStatement : TTIME Label Sampling Block {
+                  // Time statement is implicit block, thus we merge
+                  GNode* node = $4;
+                  g_free(node->data); 
+                  node->data = stmt_new(STMT_TIME, $3, $2, yylineno);
+                  
+                  $$ = node;
+                  free($2);
+                }
+              | TTIME Label Block {
                   // Time statement is implicit block, thus we merge
                   GNode* node = $3;
                   g_free(node->data); 
@@ -300,7 +333,16 @@ TimeStatement : TTIME Label Block {
                 }
               ;
 
-CoreTimeStatement : TCTIME Label Block {
+CoreTimeStatement : TCTIME Label Sampling Block {
+                      // Time statement is implicit block, thus we merge
+                      GNode* node = $4;
+                      g_free(node->data); 
+                      node->data = stmt_new(STMT_CTIME, $3, $2, yylineno);
+                      
+                      $$ = node;
+                      free($2);
+                    }
+                  | TCTIME Label Block {
                       // Time statement is implicit block, thus we merge
                       GNode* node = $3;
                       g_free(node->data); 
@@ -455,16 +497,41 @@ Command : CommandIdentifier TOBRACEL ParameterList TOBRACER TSEMICOLON {
 		| CommandIdentifier ParameterList TSEMICOLON {
              $$ = g_node_new(stmt_new($1, $2, NULL, yylineno));
           }
+        // statements of runtime loaded modules carry their name as label
+        | TMODULE TOBRACEL ParameterList TOBRACER TSEMICOLON {
+             module_assert_kind($1, FALSE);
+             $$ = g_node_new(stmt_new(STMT_MODULE, $3, $1, yylineno));
+             g_free($1);
+          }
+        | TMODULE ParameterList TSEMICOLON {
+             module_assert_kind($1, FALSE);
+             $$ = g_node_new(stmt_new(STMT_MODULE, $2, $1, yylineno));
+             g_free($1);
+          }
         ;
 
 
 CommandIdentifier : TPRINT   { $$ = STMT_PRINT; }
                   | TSLEEP   { $$ = STMT_SLEEP; }
+                  | TCOMPUTE { $$ = STMT_COMPUTE; }
                   | TFREAD   { $$ = STMT_FREAD; }
                   | TFWRITE  { $$ = STMT_FWRITE; }
                   | TFCLOSE  { $$ = STMT_FCLOSE; }
                   | TFSEEK   { $$ = STMT_FSEEK; }
                   | TFSYNC   { $$ = STMT_FSYNC; }
+                  | TFSTAT   { $$ = STMT_FSTAT; }
+                  | TFCNTL   { $$ = STMT_FCNTL; }
+                  | TFALLOCATE  { $$ = STMT_FALLOCATE; }
+                  | TFTRUNCATE  { $$ = STMT_FTRUNCATE; }
+                  | TFADVISE    { $$ = STMT_FADVISE; }
+                  | TFSYNCRANGE { $$ = STMT_FSYNCRANGE; }
+                  | TFDATASYNC  { $$ = STMT_FDATASYNC; }
+                  | TSYNCPOLICY { $$ = STMT_SYNCPOLICY; }
+                  | TCOPY       { $$ = STMT_COPY; }
+                  | TCOPYRANGE  { $$ = STMT_COPYRANGE; }
+                  | TSENDFILE   { $$ = STMT_SENDFILE; }
+                  | TSPLICE     { $$ = STMT_SPLICE; }
+                  | TSTAGE      { $$ = STMT_STAGE; }
                   | TWRITE   { $$ = STMT_WRITE; }
                   | TAPPEND  { $$ = STMT_APPEND; }
                   | TREAD    { $$ = STMT_READ; }
@@ -475,12 +542,32 @@ CommandIdentifier : TPRINT   { $$ = STMT_PRINT; }
                   | TCREATE  { $$ = STMT_CREATE; }
                   | TSTAT    { $$ = STMT_STAT; }
                   | TRENAME  { $$ = STMT_RENAME; }
+                  | TLINK    { $$ = STMT_LINK; }
+                  | TSYMLINK { $$ = STMT_SYMLINK; }
+                  | TUNLINK  { $$ = STMT_UNLINK; }
+                  | TCHMOD   { $$ = STMT_CHMOD; }
+                  | TCHOWN   { $$ = STMT_CHOWN; }
                   | TPFCLOSE { $$ = STMT_PFCLOSE; }
                   | TPFWRITE { $$ = STMT_PFWRITE; }
                   | TPFREAD  { $$ = STMT_PFREAD; }
                   | TPWRITE  { $$ = STMT_PWRITE; }
                   | TPREAD   { $$ = STMT_PREAD; }
                   | TPDELETE { $$ = STMT_PDELETE; }
+                  | TPFPREALLOCATE { $$ = STMT_PFPREALLOCATE; }
+                  | TPFSETSIZE { $$ = STMT_PFSETSIZE; }
+                  | TPFATOMIC  { $$ = STMT_PFATOMIC; }
+                  | TPFSYNC    { $$ = STMT_PFSYNC; }
+                  | TAGGWRITE  { $$ = STMT_AGGWRITE; }
+                  | TCLOSEDIR { $$ = STMT_CLOSEDIR; }
+                  | TREADDIR  { $$ = STMT_READDIR; }
+                  | TSTATAT   { $$ = STMT_STATAT; }
+                  | TCREATEAT { $$ = STMT_CREATEAT; }
+                  | TUNLINKAT { $$ = STMT_UNLINKAT; }
+                  | TEVICT   { $$ = STMT_EVICT; }
+                  | TDROPCACHES   { $$ = STMT_DROPCACHES; }
+                  | TEVICTSCRATCH { $$ = STMT_EVICTSCRATCH; }
+                  | TMDTEST  { $$ = STMT_MDTEST; }
+                  | TCHECKPOINT { $$ = STMT_CHECKPOINT; }
                   /* ![ModuleHook] parser_identifier */
                   ;
 
@@ -504,15 +591,59 @@ Function : TVAR TEQUAL FunctionIdentifier TOBRACEL ParameterList TOBRACER TSEMIC
              $$ = g_node_new(stmt_new($3, $5, NULL, yylineno));
              free($1);
          }
+         // module statements returning a handle
+         | TVAR TEQUAL TMODULE TOBRACEL ParameterList TOBRACER TSEMICOLON {
+             module_assert_kind($3, TRUE);
+             Expression* e = expr_constant_string_new(& $1[1]);
+             param_list_prepend($5, e);
+             $$ = g_node_new(stmt_new(STMT_MODULE, $5, $3, yylineno));
+             g_free($3);
+             free($1);
+         }
+         ;
 
 FunctionIdentifier : TFCREAT { $$ = STMT_FCREAT; }
                    | TFOPEN  { $$ = STMT_FOPEN; }
                    | TPFOPEN { $$ = STMT_PFOPEN; }
+                   | TOPENDIR { $$ = STMT_OPENDIR; }
                    ;
 
 
 %%
 
+/**
+ * Parameters of a repeated time statement: count, warmup and confidence target.
+ */
+ParameterList* sampling_params_new(Expression* count, Expression* warmup, Expression* ci)
+{
+	ParameterList* paramList = param_list_new();
+
+	if (!warmup) warmup = expr_constant_int_new(0);
+	if (!ci)     ci = expr_constant_int_new(0);
+
+	param_list_append(paramList, count);
+	param_list_append(paramList, warmup);
+	param_list_append(paramList, ci);
+
+	return paramList;
+}
+
+/**
+ * Module statements returning a handle have to be assigned to a variable,
+ * all other module statements must not.
+ */
+void module_assert_kind(const gchar* name, gboolean assigned)
+{
+	ModuleStatementDesc* desc = module_statement_lookup(name);
+	gboolean opens = (desc->statement->kind == MODULE_STMT_OPEN);
+
+	if (opens != assigned) {
+		gchar* message = g_strdup_printf(opens? "statement %s returns a handle, use $var = %s(...)"
+				: "statement %s doesn't return a handle", name, name);
+		yyerror(message);
+	}
+}
+
 void yyerror(const char *str)
 {
 	if(rank == MASTER) {
@@ -586,6 +717,8 @@ int translate_posix_flags(gchar* str)
 		flags |= O_NDELAY;
 	if (strstr(str, "O_SYNC") != 0)
 		flags |= O_SYNC;
+	if (strstr(str, "O_DSYNC") != 0)
+		flags |= O_DSYNC;
 	if (strstr(str, "O_TRUNC") != 0)
 		flags |= O_TRUNC;
 
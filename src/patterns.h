@@ -38,7 +38,8 @@ typedef struct {
 	PatternType type;		// defines the access pattern type to a file (currently only PATTERN2 implemented)
 	gint iter;				// number of iterations in level 0 and 1 (also used in 3, 4 to calculate buffer size)
 	gint elem;				// number of elements per process
-	gint level;				// the level to access in (0=NC/C, 1=C/C, 2=NC/NC, 3=C/NC)
+	gint level;				// the level to access in (0=NC/C, 1=C/C, 2=NC/NC, 3=C/NC, 4=NC/shared, 5=C/ordered,
+							// 6=NC/explicit offsets, 7=C/explicit offsets, 8=split collective)
 	MPI_Datatype datatype;	// the datatype which is used to represent data (currently mpi array)
 	MPI_Datatype eType;		// elementary datatype
 	gint type_size;			// size of the mpi datatype
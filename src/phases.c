@@ -0,0 +1,144 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "phases.h"
+#include "groups.h"
+#include <string.h>
+
+
+void phases_init()
+{
+	phaseList = NULL;
+}
+
+void phases_free()
+{
+	if (phaseList) {
+		g_slist_foreach(phaseList, (GFunc) g_free, NULL);
+		g_slist_free(phaseList);
+	}
+}
+
+PhaseEvent* phase_event_new(gint id, const gchar* name, const gchar* phase)
+{
+	PhaseEvent* event = g_malloc0(sizeof(PhaseEvent));
+	event->id = id;
+	strncpy(event->name, name, NAME_SIZE-1);
+	strncpy(event->phase, phase, NAME_SIZE-1);
+
+	return event;
+}
+
+/**
+ * Prepares a phase context for the active group. All processes of the
+ * group have to call this collectively.
+ */
+void phase_context_init(PhaseContext* ctx, const gchar* name)
+{
+	static gint phaseId = 0;
+
+	ctx->id = phaseId++;
+	ctx->name = name;
+#ifdef HAVE_MPI
+	ctx->comm = MPI_COMM_WORLD;
+	if (groupStack)
+		ctx->comm = ((GroupBlock*) g_list_first(groupStack)->data)->mpicomm;
+#endif
+	ctx->timer = g_timer_new();
+}
+
+void phase_context_free(PhaseContext* ctx)
+{
+	g_timer_destroy(ctx->timer);
+	ctx->timer = NULL;
+}
+
+/**
+ * Synchronizes the group and starts the phase clock.
+ */
+void phase_begin(PhaseContext* ctx)
+{
+#ifdef HAVE_MPI
+	MPI_ASSERT(MPI_Barrier(ctx->comm), "Phase Begin", TRUE)
+#endif
+	g_timer_start(ctx->timer);
+}
+
+/**
+ * Stops the phase clock and reduces the local results to the group master.
+ * The slowest process defines the phase time, so aggregated rates are
+ * computed from maxTime.
+ */
+void phase_end(PhaseContext* ctx, const gchar* phase, glong ops, glong data)
+{
+	g_timer_stop(ctx->timer);
+	gdouble time = g_timer_elapsed(ctx->timer, NULL);
+
+	PhaseEvent* event = phase_event_new(ctx->id, ctx->name, phase);
+	event->proc = rank;
+
+#ifdef HAVE_MPI
+	gint groupRank;
+	glong local[2] = { ops, data };
+	glong global[2];
+
+	MPI_ASSERT(MPI_Comm_rank(ctx->comm, &groupRank), "Phase End", TRUE)
+	MPI_ASSERT(MPI_Comm_size(ctx->comm, &event->procs), "Phase End", TRUE)
+	MPI_ASSERT(MPI_Reduce(local, global, 2, MPI_LONG, MPI_SUM, MASTER, ctx->comm), "Phase End", TRUE)
+	MPI_ASSERT(MPI_Reduce(&time, &event->minTime, 1, MPI_DOUBLE, MPI_MIN, MASTER, ctx->comm), "Phase End", TRUE)
+	MPI_ASSERT(MPI_Reduce(&time, &event->maxTime, 1, MPI_DOUBLE, MPI_MAX, MASTER, ctx->comm), "Phase End", TRUE)
+
+	if (groupRank != MASTER) {
+		g_free(event);
+		return;
+	}
+
+	event->ops = global[0];
+	event->data = global[1];
+#else
+	event->procs = 1;
+	event->ops = ops;
+	event->data = data;
+	event->minTime = time;
+	event->maxTime = time;
+#endif
+
+	// the reductions above still run, the whole group warms up together
+	if (warmingUp) {
+		g_free(event);
+		return;
+	}
+
+	phaseList = g_slist_append(phaseList, event);
+}
+
+/**
+ * Compare phase events by execution order and group master (stable for
+ * phases of the same statement since they are appended in order).
+ */
+gint compare_phase_events(gconstpointer a, gconstpointer b)
+{
+	const PhaseEvent* e1 = a;
+	const PhaseEvent* e2 = b;
+
+	if (e1->id != e2->id)
+		return e1->id - e2->id;
+	return e1->proc - e2->proc;
+}
@@ -0,0 +1,72 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PHASES_H_
+#define PHASES_H_
+
+#include "common.h"
+#include "timing.h"
+
+#include <glib.h>
+
+/**
+ * Phases are barrier separated sections of a collective workload statement
+ * (e.g. the create/stat/remove sweeps of mdtest). Every rank measures its
+ * own phase time, the results are reduced over the active communicator and
+ * only the group master keeps the aggregated event. Ids count the phased
+ * statements of one group, events of different groups are told apart by
+ * the rank of their group master.
+ */
+
+GSList* phaseList;			// list with aggregated phase events (group masters only)
+
+typedef struct {
+	gint id;				// used to keep track of global command start order
+	gint proc;				// rank of the group master that keeps the event
+	gint procs;				// number of processes taking part in the phase
+	glong ops;				// operations completed by all processes
+	glong data;				// data processed by all processes
+	gdouble minTime;		// phase time of the fastest process
+	gdouble maxTime;		// phase time of the slowest process
+	gchar name[NAME_SIZE];	// name of the statement the phase belongs to
+	gchar phase[NAME_SIZE];	// name of the phase
+} PhaseEvent;
+
+typedef struct {
+	gint id;				// execution id shared by all phases of one statement
+	const gchar* name;		// name of the statement the phases belong to
+#ifdef HAVE_MPI
+	MPI_Comm comm;			// communicator the phases are synchronized on
+#endif
+	GTimer* timer;			// measures the local phase time
+} PhaseContext;
+
+
+void phases_init();
+void phases_free();
+
+PhaseEvent* phase_event_new(gint id, const gchar* name, const gchar* phase);
+
+void phase_context_init(PhaseContext* ctx, const gchar* name);
+void phase_context_free(PhaseContext* ctx);
+void phase_begin(PhaseContext* ctx);
+void phase_end(PhaseContext* ctx, const gchar* phase, glong ops, glong data);
+
+gint compare_phase_events(gconstpointer a, gconstpointer b);
+
+#endif /* PHASES_H_ */
@@ -0,0 +1,185 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Example plugin: O_DIRECT file transfers with aligned buffers.
+ * Load with: parabench --module build/default/plugins/libodirect.so kernel.pbl
+ *
+ *   $h = odopen(path, blocksize);
+ *   odwrite($h, size);
+ *   odread($h, size);
+ *   odclose($h);
+ *
+ * Opening the file and allocating the aligned buffer is done once per
+ * handle, so only the transfers show up in the core time.
+ */
+
+#include "module.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef struct {
+	glong alignment;		// buffer alignment for O_DIRECT
+} ODirectContext;
+
+typedef struct {
+	int fd;
+	void* buffer;
+	glong blockSize;
+} ODirectHandle;
+
+
+static gboolean odirect_init(gpointer* context)
+{
+	ODirectContext* ctx = g_malloc0(sizeof(ODirectContext));
+	ctx->alignment = getpagesize();
+	*context = ctx;
+	return TRUE;
+}
+
+static void odirect_finalize(gpointer context)
+{
+	g_free(context);
+}
+
+static void odirect_release(gpointer context, gpointer handle)
+{
+	ODirectHandle* odh = handle;
+	if (odh->fd != -1)
+		close(odh->fd);
+	free(odh->buffer);
+	g_free(odh);
+}
+
+static IOStatus odirect_open(gpointer context, const ModuleParam* params, gpointer* result)
+{
+	ODirectContext* ctx = context;
+	const gchar* path = params[0].str;
+	glong blockSize = params[1].num;
+	ODirectHandle* odh;
+	int fd;
+
+	if (blockSize <= 0 || blockSize % ctx->alignment != 0) {
+		Warning("(ODOpen) Block size %ld is not a multiple of %ld", blockSize, ctx->alignment);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	CORETIME_START();
+	fd = open(path, O_RDWR|O_CREAT|O_DIRECT, 0644);
+	CORETIME_STOP(time);
+
+	if (fd == -1)
+		return iostatus_new(FALSE, time, 0);
+
+	odh = g_malloc0(sizeof(ODirectHandle));
+	odh->fd = fd;
+	odh->blockSize = blockSize;
+
+	if (posix_memalign(&odh->buffer, ctx->alignment, blockSize)) {
+		close(fd);
+		g_free(odh);
+		return iostatus_new(FALSE, time, 0);
+	}
+	memset(odh->buffer, '0', blockSize);
+
+	*result = odh;
+	return iostatus_new(TRUE, time, 0);
+}
+
+static IOStatus odirect_close(gpointer context, const ModuleParam* params, gpointer* result)
+{
+	ODirectHandle* odh = params[0].handle;
+
+	CORETIME_START();
+	int ret = close(odh->fd);
+	CORETIME_STOP(time);
+
+	// on failure the handle stays registered and is freed by release(),
+	// the descriptor is gone on Linux anyway and mustn't be closed twice
+	if (ret != 0) {
+		odh->fd = -1;
+		return iostatus_new(FALSE, time, 0);
+	}
+
+	free(odh->buffer);
+	g_free(odh);
+
+	return iostatus_new(TRUE, time, 0);
+}
+
+static IOStatus odirect_write(gpointer context, const ModuleParam* params, gpointer* result)
+{
+	ODirectHandle* odh = params[0].handle;
+	glong size = params[1].num;
+	glong written = 0;
+	ssize_t rc;
+
+	if (size % odh->blockSize != 0) {
+		Warning("(ODWrite) Size %ld is not a multiple of the block size %ld", size, odh->blockSize);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	CORETIME_START();
+	while (written < size && (rc = write(odh->fd, odh->buffer, odh->blockSize)) > 0)
+		written += rc;
+	CORETIME_STOP(time);
+
+	return iostatus_new(written == size, time, written);
+}
+
+static IOStatus odirect_read(gpointer context, const ModuleParam* params, gpointer* result)
+{
+	ODirectHandle* odh = params[0].handle;
+	glong size = params[1].num;
+	glong bytesRead = 0;
+	ssize_t rc = 0;
+
+	CORETIME_START();
+	while (bytesRead < size && (rc = read(odh->fd, odh->buffer, odh->blockSize)) > 0)
+		bytesRead += rc;
+	CORETIME_STOP(time);
+
+	return iostatus_new(rc >= 0, time, bytesRead);
+}
+
+
+static const ModuleParamType openParams[]     = { MODULE_PARAM_STRING, MODULE_PARAM_INT };
+static const ModuleParamType closeParams[]    = { MODULE_PARAM_HANDLE };
+static const ModuleParamType transferParams[] = { MODULE_PARAM_HANDLE, MODULE_PARAM_INT };
+
+static const ModuleStatement statements[] = {
+	{ "odopen",  MODULE_STMT_OPEN,    openParams,     2, odirect_open  },
+	{ "odclose", MODULE_STMT_CLOSE,   closeParams,    1, odirect_close },
+	{ "odwrite", MODULE_STMT_COMMAND, transferParams, 2, odirect_write },
+	{ "odread",  MODULE_STMT_COMMAND, transferParams, 2, odirect_read  },
+};
+
+static const ModuleInfo moduleInfo = {
+	PARABENCH_MODULE_ABI_VERSION, "odirect", statements, 4,
+	odirect_init, odirect_finalize, odirect_release
+};
+
+const ModuleInfo* parabench_module_info()
+{
+	return &moduleInfo;
+}
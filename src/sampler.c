@@ -0,0 +1,211 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "sampler.h"
+#include "clocksync.h"
+#include <string.h>
+#include <glib/gstdio.h>
+#include <glib/gprintf.h>
+
+static GHashTable* activeSeries = NULL;	// CoreTimeEvent -> SampleSeries
+
+
+void sampler_init()
+{
+	sampleInterval = 0;
+	sampleCapacity = 0;
+	sampleList = NULL;
+}
+
+static void sample_series_free(SampleSeries* series)
+{
+	g_free(series->ring);
+	g_free(series);
+}
+
+void sampler_free()
+{
+	if (sampleList) {
+		g_slist_foreach(sampleList, (GFunc) sample_series_free, NULL);
+		g_slist_free(sampleList);
+		sampleList = NULL;
+	}
+
+	if (activeSeries) {
+		g_hash_table_destroy(activeSeries);
+		activeSeries = NULL;
+	}
+}
+
+/**
+ * Enables the sampler with intervals of intervalMs milliseconds and a ring
+ * of capacity intervals per core time event. Intervals are placed on the
+ * global timeline, so the series of all processes share one time axis.
+ */
+void sampler_configure(glong intervalMs, glong capacity)
+{
+	g_assert(intervalMs > 0 && capacity > 0);
+
+	sampleInterval = intervalMs / 1000.0;
+	sampleCapacity = capacity;
+
+	if (!activeSeries)
+		activeSeries = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+void sampler_attach(const CoreTimeEvent* event)
+{
+	if (sampleInterval <= 0)
+		return;
+
+	SampleSeries* series = g_malloc0(sizeof(SampleSeries));
+	series->proc = event->proc;
+	series->id = event->id;
+	strncpy(series->name, event->name, NAME_SIZE-1);
+	series->event = event;
+	series->origin = clock_elapsed();
+	series->capacity = sampleCapacity;
+	series->ring = g_malloc0(sampleCapacity * sizeof(Sample));
+	series->ring[0].start = series->origin;
+
+	sampleList = g_slist_append(sampleList, series);
+	g_hash_table_insert(activeSeries, (gpointer) event, series);
+}
+
+/**
+ * Moves the current interval forward to interval number target. Skipped
+ * intervals are recorded as idle, the oldest ones are overwritten when
+ * the ring is full.
+ */
+static void sample_series_advance(SampleSeries* series, glong target)
+{
+	// more idle intervals than the ring holds only leave idle intervals behind
+	if (target - series->current > series->capacity) {
+		series->dropped += target - series->capacity - series->first;
+		series->first = series->current = target - series->capacity;
+	}
+
+	while (series->current < target) {
+		series->current++;
+
+		if (series->current - series->first >= series->capacity) {
+			series->first++;
+			series->dropped++;
+		}
+
+		Sample* sample = &series->ring[series->current % series->capacity];
+		sample->start = series->origin + series->current * sampleInterval;
+		sample->data = 0;
+		sample->ops = 0;
+		sample->coreTime = 0;
+	}
+}
+
+/**
+ * Adds a completed I/O call to the interval it completed in. Called from
+ * dump_coretime for every active core time event.
+ */
+void sampler_record(const CoreTimeEvent* event, CoreTime coreTime)
+{
+	SampleSeries* series;
+
+	if (sampleInterval <= 0 || !(series = g_hash_table_lookup(activeSeries, event)))
+		return;
+
+	gdouble now = clock_elapsed();
+	glong interval = (glong) ((now - series->origin) / sampleInterval);
+
+	if (interval > series->current)
+		sample_series_advance(series, interval);
+
+	Sample* sample = &series->ring[series->current % series->capacity];
+	sample->data += coreTime.data;
+	sample->ops++;
+	sample->coreTime += coreTime.time;
+}
+
+/**
+ * Closes the series of a finished core time event. The trailing idle
+ * intervals up to the end of the block are kept.
+ */
+void sampler_detach(const CoreTimeEvent* event)
+{
+	SampleSeries* series;
+
+	if (sampleInterval <= 0 || !(series = g_hash_table_lookup(activeSeries, event)))
+		return;
+
+	gdouble now = clock_elapsed();
+	sample_series_advance(series, (glong) ((now - series->origin) / sampleInterval));
+
+	series->event = NULL;
+	g_hash_table_remove(activeSeries, event);
+}
+
+/**
+ * Writes all series of this process to directory/samples_<rank>.csv.
+ * Format: <rank>;<event_id>;<event>;<start>;<bytes>;<ops>;<MiB/s>;<ops/s>
+ */
+gboolean sampler_export(const gchar* directory)
+{
+	GSList* iter;
+	FILE* fh;
+
+	if (!sampleList)
+		return TRUE;
+
+	if (g_mkdir_with_parents(directory, 0755) != 0) {
+		Warning("(Sampler) Couldn't create %s", directory);
+		return FALSE;
+	}
+
+	gchar* filename = g_strdup_printf("%s/samples_%d.csv", directory, rank);
+	fh = g_fopen(filename, "w");
+
+	if (fh == NULL) {
+		Warning("(Sampler) Couldn't open %s for writing", filename);
+		g_free(filename);
+		return FALSE;
+	}
+
+	g_fprintf(fh, "rank;id;event;start;bytes;ops;mibs;iops\n");
+
+	for (iter=sampleList; iter; iter=g_slist_next(iter)) {
+		SampleSeries* series = iter->data;
+		glong i;
+
+		if (series->dropped > 0)
+			Warning("(Sampler) %s: %ld intervals didn't fit into the ring buffer",
+					series->name, series->dropped);
+
+		for (i=series->first; i<=series->current; i++) {
+			Sample* sample = &series->ring[i % series->capacity];
+
+			g_fprintf(fh, "%d;%d;%s;%.6f;%ld;%ld;%.3f;%.1f\n", series->proc, series->id, series->name,
+					sample->start, sample->data, sample->ops,
+					sample->data / sampleInterval / (1024*1024), sample->ops / sampleInterval);
+		}
+	}
+
+	fclose(fh);
+	g_free(filename);
+
+	return TRUE;
+}
@@ -0,0 +1,72 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAMPLER_H_
+#define SAMPLER_H_
+
+#include "timing.h"
+
+#include <glib.h>
+
+/**
+ * The sampler splits core time events into fixed time intervals and
+ * records the bytes and operations completed in each of them, so the
+ * throughput of long running ctime blocks can be plotted over time.
+ * Every series owns a ring buffer that is allocated when the ctime block
+ * starts. When a block runs longer than the buffer covers, the oldest
+ * intervals are overwritten.
+ */
+
+typedef struct {
+	gdouble start;			// interval start on the global timeline (see clocksync.h)
+	glong data;				// bytes completed in this interval
+	glong ops;				// I/O calls completed in this interval
+	gdouble coreTime;		// core time of the calls completed in this interval
+} Sample;
+
+typedef struct {
+	gint proc;				// process id
+	gint id;				// id of the core time event
+	gchar name[NAME_SIZE];	// label of the core time event
+	const CoreTimeEvent* event;	// sampled event, NULL once the block is done
+	gdouble origin;			// start of the first interval
+	glong first;			// index of the oldest interval in the ring
+	glong current;			// absolute number of the current interval
+	glong capacity;			// number of intervals in the ring
+	glong dropped;			// intervals overwritten because the ring was full
+	Sample* ring;
+} SampleSeries;
+
+
+gdouble sampleInterval;		// interval length in seconds, 0 disables the sampler
+glong   sampleCapacity;		// ring buffer size per series in intervals
+GSList* sampleList;			// recorded series in start order (SampleSeries)
+
+
+void sampler_init();
+void sampler_free();
+
+void sampler_configure(glong intervalMs, glong capacity);
+
+void sampler_attach(const CoreTimeEvent* event);
+void sampler_detach(const CoreTimeEvent* event);
+void sampler_record(const CoreTimeEvent* event, CoreTime coreTime);
+
+gboolean sampler_export(const gchar* directory);
+
+#endif /* SAMPLER_H_ */
@@ -0,0 +1,229 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "stage.h"
+#include "iio_posix.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+	gchar* data;
+	glong length;			// valid bytes, 0 ends the stream, -1 reports a read error
+} StageBuffer;
+
+typedef struct {
+	int fd;
+	glong blockSize;
+	GAsyncQueue* empty;		// buffers ready to be filled
+	GAsyncQueue* filled;	// buffers ready to be written
+	volatile gint cancelled;	// set by the writer after a failed write
+	gdouble readTime;
+	glong waits;
+} StageReader;
+
+
+/**
+ * Takes the next buffer of a queue and counts if it had to wait for it.
+ */
+static StageBuffer* stage_pop(GAsyncQueue* queue, glong* waits)
+{
+	StageBuffer* buffer = g_async_queue_try_pop(queue);
+
+	if (!buffer) {
+		(*waits)++;
+		buffer = g_async_queue_pop(queue);
+	}
+
+	return buffer;
+}
+
+/**
+ * Fills up to length bytes, short reads are continued until the end of
+ * the file.
+ */
+static glong stage_read_block(int fd, gchar* data, glong length)
+{
+	glong done = 0;
+	ssize_t rc;
+
+	while (done < length && (rc = read(fd, data + done, length - done)) > 0)
+		done += rc;
+
+	return (rc < 0)? -1 : done;
+}
+
+static gboolean stage_write_block(int fd, const gchar* data, glong length)
+{
+	glong done = 0;
+	ssize_t rc;
+
+	while (done < length && (rc = write(fd, data + done, length - done)) > 0)
+		done += rc;
+
+	return done == length;
+}
+
+static gpointer stage_reader(gpointer data)
+{
+	StageReader* reader = data;
+	GTimer* timer = g_timer_new();
+	StageBuffer* buffer;
+
+	do {
+		buffer = stage_pop(reader->empty, &reader->waits);
+
+		if (g_atomic_int_get(&reader->cancelled))
+			buffer->length = 0;
+		else {
+			g_timer_start(timer);
+			buffer->length = stage_read_block(reader->fd, buffer->data, reader->blockSize);
+			reader->readTime += g_timer_elapsed(timer, NULL);
+		}
+
+		g_async_queue_push(reader->filled, buffer);
+	} while (buffer->length > 0);
+
+	g_timer_destroy(timer);
+	return NULL;
+}
+
+/**
+ * Copies source to dest (created or truncated) through a ring of depth
+ * buffers. Opening the files and allocating the ring isn't part of the
+ * core time.
+ */
+IOStatus stage_run(const gchar* source, const gchar* dest, glong blockSize, gint depth)
+{
+	StageReader reader;
+	StageBuffer* buffers;
+	StageBuffer* buffer;
+	gboolean success = TRUE, last;
+	glong bytes = 0, writerWaits = 0;
+	gdouble writeTime = 0;
+	int out;
+	gint i;
+
+	memset(&reader, 0, sizeof(StageReader));
+	reader.blockSize = blockSize;
+
+	if ((reader.fd = open(source, O_RDONLY)) == -1) {
+		Warning("(Stage) Couldn't open \"%s\" for reading", source);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	if ((out = open(dest, O_WRONLY|O_CREAT|O_TRUNC, DEFAULT_OPEN_MODE)) == -1) {
+		Warning("(Stage) Couldn't open \"%s\" for writing", dest);
+		close(reader.fd);
+		return iostatus_new(FALSE, 0, 0);
+	}
+
+	reader.empty = g_async_queue_new();
+	reader.filled = g_async_queue_new();
+	buffers = g_malloc0(depth * sizeof(StageBuffer));
+
+	for (i=0; i<depth; i++) {
+		if (posix_memalign((void**) &buffers[i].data, getpagesize(), blockSize))
+			Error("(Stage) Couldn't allocate %d buffers of %ld bytes", depth, blockSize);
+		memset(buffers[i].data, 0, blockSize);
+		g_async_queue_push(reader.empty, &buffers[i]);
+	}
+
+	GTimer* timer = g_timer_new();
+
+	CORETIME_START();
+	GThread* thread = g_thread_new("stage", stage_reader, &reader);
+
+	do {
+		buffer = stage_pop(reader.filled, &writerWaits);
+		last = (buffer->length <= 0);
+
+		if (buffer->length < 0)
+			success = FALSE;
+		else if (buffer->length > 0 && success) {
+			g_timer_start(timer);
+			success = stage_write_block(out, buffer->data, buffer->length);
+			writeTime += g_timer_elapsed(timer, NULL);
+
+			if (success)
+				bytes += buffer->length;
+			else
+				g_atomic_int_set(&reader.cancelled, 1);
+		}
+
+		g_async_queue_push(reader.empty, buffer);
+	} while (!last);
+
+	g_thread_join(thread);
+	CORETIME_STOP(time);
+
+	if (!success)
+		Warning("(Stage) Staging \"%s\" to \"%s\" failed after %ld bytes", source, dest, bytes);
+
+	Verbose("(Stage) %ld bytes in %fs, read %fs, write %fs, waits reader %ld, writer %ld",
+			bytes, time, reader.readTime, writeTime, reader.waits, writerWaits);
+
+	stageStats.runs++;
+	stageStats.bytes += bytes;
+	stageStats.time += time;
+	stageStats.readTime += reader.readTime;
+	stageStats.writeTime += writeTime;
+	stageStats.readerWaits += reader.waits;
+	stageStats.writerWaits += writerWaits;
+
+	g_timer_destroy(timer);
+	for (i=0; i<depth; i++)
+		free(buffers[i].data);
+	g_free(buffers);
+	g_async_queue_unref(reader.empty);
+	g_async_queue_unref(reader.filled);
+	close(reader.fd);
+	close(out);
+
+	return iostatus_new(success, time, bytes);
+}
+
+/**
+ * Sums the staged data and the waits on the master, times are taken from
+ * the slowest process.
+ */
+void stage_reduce()
+{
+#ifdef HAVE_MPI
+	glong counts[4] = { stageStats.runs, stageStats.bytes, stageStats.readerWaits, stageStats.writerWaits };
+	gdouble times[3] = { stageStats.time, stageStats.readTime, stageStats.writeTime };
+	glong sumCounts[4];
+	gdouble maxTimes[3];
+
+	MPI_Reduce(counts, sumCounts, 4, MPI_LONG, MPI_SUM, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(times, maxTimes, 3, MPI_DOUBLE, MPI_MAX, MASTER, MPI_COMM_WORLD);
+
+	if (rank == MASTER) {
+		stageStats.runs = sumCounts[0];
+		stageStats.bytes = sumCounts[1];
+		stageStats.readerWaits = sumCounts[2];
+		stageStats.writerWaits = sumCounts[3];
+		stageStats.time = maxTimes[0];
+		stageStats.readTime = maxTimes[1];
+		stageStats.writeTime = maxTimes[2];
+	}
+#endif
+}
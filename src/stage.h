@@ -0,0 +1,57 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STAGE_H_
+#define STAGE_H_
+
+#include "iio.h"
+
+#include <glib.h>
+
+/**
+ * Pipelined staging between two paths, e.g. from a burst buffer to the
+ * parallel file system. A reader thread fills a ring of depth aligned
+ * buffers of blockSize bytes, the interpreter thread drains it into the
+ * destination, so reads and writes overlap.
+ *
+ * Besides the pipeline throughput the busy time of either side is kept:
+ * the data divided by the time spent in read or write is the throughput
+ * the side achieved on its own, and the pipeline can't be faster than the
+ * slower of the two. Waits tell which side was the bottleneck.
+ */
+
+#define STAGE_BLOCK_SIZE (1024*1024)	// default transfer size
+#define STAGE_DEPTH 2					// default number of buffers (double buffering)
+
+typedef struct {
+	glong runs;				// executed stage statements
+	glong bytes;			// bytes staged
+	gdouble time;			// seconds of the whole pipelines
+	gdouble readTime;		// seconds spent in read
+	gdouble writeTime;		// seconds spent in write
+	glong readerWaits;		// reader found no free buffer
+	glong writerWaits;		// writer found no filled buffer
+} StageStats;
+
+StageStats stageStats;
+
+
+IOStatus stage_run(const gchar* source, const gchar* dest, glong blockSize, gint depth);
+void     stage_reduce();
+
+#endif /* STAGE_H_ */
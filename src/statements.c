@@ -62,6 +62,24 @@ gchar* stmt_get_string(StatementType type)
 		case STMT_FSEEK:  return "FSeek";
 		case STMT_FCREAT: return "FCreat";
 		case STMT_FSYNC:  return "FSync";
+		case STMT_FSTAT:  return "FStat";
+		case STMT_FCNTL:  return "FCntl";
+		case STMT_LINK:   return "Link";
+		case STMT_SYMLINK: return "Symlink";
+		case STMT_UNLINK: return "Unlink";
+		case STMT_CHMOD:  return "Chmod";
+		case STMT_CHOWN:  return "Chown";
+		case STMT_FALLOCATE: return "FAllocate";
+		case STMT_FTRUNCATE: return "FTruncate";
+		case STMT_FADVISE: return "FAdvise";
+		case STMT_FSYNCRANGE: return "FSyncRange";
+		case STMT_FDATASYNC: return "FDataSync";
+		case STMT_SYNCPOLICY: return "SyncPolicy";
+		case STMT_COPY:      return "Copy";
+		case STMT_COPYRANGE: return "CopyRange";
+		case STMT_SENDFILE:  return "SendFile";
+		case STMT_SPLICE:    return "Splice";
+		case STMT_STAGE:     return "Stage";
 
 		/* MPI I/O Statements */
 		case STMT_PFOPEN:  return "PFOpen";
@@ -71,6 +89,31 @@ gchar* stmt_get_string(StatementType type)
 		case STMT_PWRITE:  return "PWrite";
 		case STMT_PREAD:   return "PRead";
 		case STMT_PDELETE: return "PDelete";
+		case STMT_PFPREALLOCATE: return "PFPreallocate";
+		case STMT_PFSETSIZE: return "PFSetSize";
+		case STMT_PFATOMIC:  return "PFAtomic";
+		case STMT_PFSYNC:    return "PFSync";
+		case STMT_AGGWRITE:  return "AggWrite";
+
+		/* POSIX Directory Handle Statements */
+		case STMT_OPENDIR:  return "OpenDir";
+		case STMT_CLOSEDIR: return "CloseDir";
+		case STMT_READDIR:  return "ReadDir";
+		case STMT_STATAT:   return "StatAt";
+		case STMT_CREATEAT: return "CreateAt";
+		case STMT_UNLINKAT: return "UnlinkAt";
+
+		/* Cache Control Statements */
+		case STMT_EVICT:        return "Evict";
+		case STMT_DROPCACHES:   return "DropCaches";
+		case STMT_EVICTSCRATCH: return "EvictScratch";
+
+		/* Workload Statements */
+		case STMT_MDTEST:  return "Mdtest";
+		case STMT_CHECKPOINT: return "Checkpoint";
+
+		/* Module Statements */
+		case STMT_MODULE:  return "Module";
 
 		/* Auxiliary Statements */
 		case STMT_REPEAT:  return "repeat";
@@ -84,6 +127,7 @@ gchar* stmt_get_string(StatementType type)
 		case STMT_SLEEP:   return "sleep";
 		case STMT_PRINT:   return "print";
 		case STMT_BLOCK:   return "block";
+		case STMT_COMPUTE: return "compute";
 
 		default: return "unknown";
 	}
@@ -31,15 +31,39 @@ typedef enum {
     STMT_RMDIR,   STMT_CREATE,
     STMT_STAT,    STMT_RENAME,
     STMT_FSEEK,   STMT_FCREAT,
-    STMT_FSYNC,
+    STMT_FSYNC,   STMT_FSTAT,
+    STMT_FCNTL,   STMT_LINK,
+    STMT_SYMLINK, STMT_UNLINK,
+    STMT_CHMOD,   STMT_CHOWN,
+    STMT_FALLOCATE, STMT_FTRUNCATE,
+    STMT_FADVISE, STMT_FSYNCRANGE,
+    STMT_FDATASYNC, STMT_SYNCPOLICY,
+    STMT_COPY,    STMT_COPYRANGE,
+    STMT_SENDFILE, STMT_SPLICE,
+    STMT_STAGE,
 
     /* MPI I/O Statements */
     STMT_PFOPEN,  STMT_PFCLOSE,
     STMT_PFWRITE, STMT_PFREAD,
     STMT_PWRITE,  STMT_PREAD, //19
-    STMT_PDELETE,
+    STMT_PDELETE,  STMT_PFPREALLOCATE,
+    STMT_PFSETSIZE, STMT_PFATOMIC,
+    STMT_PFSYNC,   STMT_AGGWRITE,
+
+    /* POSIX Directory Handle Statements */
+    STMT_OPENDIR, STMT_CLOSEDIR,
+    STMT_READDIR, STMT_STATAT,
+    STMT_CREATEAT, STMT_UNLINKAT,
+
+    /* Cache Control Statements */
+    STMT_EVICT,   STMT_DROPCACHES,
+    STMT_EVICTSCRATCH,
+
+    /* Workload Statements */
+    STMT_MDTEST,  STMT_CHECKPOINT,
 
     /* Module Statements */
+    STMT_MODULE,  // runtime loaded module, label holds the statement name
     /* ![ModuleHook] statement_enum */
 
     __STMT_NUM_REPORTED__, // Statements after this entry wont be reported
@@ -50,7 +74,9 @@ typedef enum {
     STMT_ASSIGN,  STMT_GROUP,
     STMT_MASTER,  STMT_BARRIER,
     STMT_SLEEP,   STMT_PRINT,
-    STMT_BLOCK,
+    STMT_BLOCK,   STMT_COMPUTE,
+
+    __STMT_NUM__ // number of statement types
 } StatementType;
 
 typedef struct {
@@ -20,12 +20,26 @@
 #include "../build/default/config.h"
 #include "../iio.h"
 #include "../iio_posix.h"
+#include "../timing.h"
+#include "../sampler.h"
+#include "../trace.h"
+#include "../clocksync.h"
+#include "../export.h"
+#include "../verify.h"
+#include "../content.h"
+#include "../cache.h"
+#include "../stage.h"
+#include "../checkpoint.h"
+#include "../phases.h"
+#include "../variables.h"
+#include "../interpreter.h"
 
 #include <glib.h>
 #include <glib/gprintf.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <math.h>
 
 
 gboolean agileMode = FALSE;
@@ -475,6 +489,928 @@ void test_io_rename()
 	g_string_free(newname, TRUE);
 }
 
+void test_io_fstat_fcntl()
+{
+	GString* fname = g_string_new("test_fstat_");
+	g_string_append_printf(fname, "%d", ABS(g_test_rand_int()));
+
+	create_file(fname->str);
+
+	File* fh;
+	g_assert(iio_fopen(fname->str, O_RDWR, &fh).success);
+	g_assert(iio_fstat(fh).success);
+	g_assert(iio_fcntl(fh, F_GETFL, 0).success);
+	g_assert(iio_fcntl(fh, F_SETFL, O_APPEND).success);
+	g_assert(fcntl(fh->handle.posixfh, F_GETFL) & O_APPEND);
+	g_assert(!iio_fcntl(fh, -1, 0).success);
+	g_assert(iio_fclose(fh).success);
+
+	delete_file(fname->str);
+	g_string_free(fname, TRUE);
+}
+
+void test_io_fallocate()
+{
+	GString* fname = g_string_new("test_fallocate_");
+	g_string_append_printf(fname, "%d", ABS(g_test_rand_int()));
+	const gint SIZE = 4*1024*1024;
+
+	File* fh;
+	g_assert(iio_fcreat(fname->str, &fh).success);
+
+	IOStatus status = iio_fallocate(fh, 0, SIZE, 0);
+	if (!status.success) {
+		g_message("fallocate not supported on this file system, skipping");
+		g_assert(iio_fclose(fh).success);
+		delete_file(fname->str);
+		return;
+	}
+	g_assert_cmpint(get_file_size(fname->str), ==, SIZE);
+
+	// punching a hole keeps the size
+	iio_fallocate(fh, 0, SIZE/2, FALLOC_FL_PUNCH_HOLE|FALLOC_FL_KEEP_SIZE);
+	g_assert_cmpint(get_file_size(fname->str), ==, SIZE);
+
+	g_assert(iio_ftruncate(fh, SIZE/4).success);
+	g_assert_cmpint(get_file_size(fname->str), ==, SIZE/4);
+
+	g_assert(iio_fadvise(fh, 0, 0, POSIX_FADV_DONTNEED).success);
+	g_assert(!iio_fadvise(fh, 0, 0, -1).success);
+	g_assert(iio_fsyncrange(fh, 0, SIZE/4, SYNC_FILE_RANGE_WRITE).success);
+
+	g_assert(iio_fclose(fh).success);
+
+	delete_file(fname->str);
+	g_string_free(fname, TRUE);
+}
+
+void test_io_sync_policy()
+{
+	GString* fname = g_string_new("test_sync_policy_");
+	g_string_append_printf(fname, "%d", ABS(g_test_rand_int()));
+	gint i, syncs;
+
+	File* fh;
+	g_assert(iio_fcreat(fname->str, &fh).success);
+
+	IOStatus status = iio_fdatasync(fh);
+	g_assert(status.success);
+	g_assert(status.coreTime.sync == status.coreTime.time);
+
+	// no implicit syncs by default
+	status = iio_fwrite(fh, 4096, OFFSET_CUR);
+	g_assert(status.success);
+	g_assert(status.coreTime.sync == 0);
+
+	// fsync every 4th call
+	iio_set_sync_policy(fh, SYNC_FSYNC, 4);
+	for (i=0, syncs=0; i<16; i++) {
+		status = iio_fwrite(fh, 4096, OFFSET_CUR);
+		g_assert(status.success);
+		if (status.coreTime.sync > 0) syncs++;
+	}
+	g_assert_cmpint(syncs, ==, 4);
+
+	// fdatasync every 64 KiB
+	iio_set_sync_policy(fh, SYNC_FDATASYNC, 64*1024);
+	for (i=0, syncs=0; i<64; i++) {
+		status = iio_fwrite(fh, 4096, OFFSET_CUR);
+		if (status.coreTime.sync > 0) syncs++;
+	}
+	g_assert_cmpint(syncs, ==, 4);
+
+	iio_set_sync_policy(fh, SYNC_CLOSE, 0);
+	status = iio_fclose(fh);
+	g_assert(status.success);
+	g_assert(status.coreTime.sync > 0);
+
+	// a failed sync fails the statement (/dev/null can't be synced)
+	g_assert(iio_fopen("/dev/null", O_WRONLY, &fh).success);
+	iio_set_sync_policy(fh, SYNC_FSYNC, 1);
+	g_assert(!iio_fwrite(fh, 4096, OFFSET_CUR).success);
+	iio_set_sync_policy(fh, SYNC_CLOSE, 0);
+	g_assert(!iio_fclose(fh).success);
+
+	delete_file(fname->str);
+	g_string_free(fname, TRUE);
+}
+
+void test_io_links()
+{
+	GString* fname = g_string_new("test_links_");
+	g_string_append_printf(fname, "%d", ABS(g_test_rand_int()));
+	gchar* hardname = g_strconcat(fname->str, ".hard", NULL);
+	gchar* softname = g_strconcat(fname->str, ".soft", NULL);
+
+	create_file(fname->str);
+
+	g_assert(iio_link(fname->str, hardname).success);
+	g_assert(iio_symlink(fname->str, softname).success);
+	g_assert(!iio_link(fname->str, hardname).success);
+	g_assert(file_exists(hardname));
+	g_assert(file_exists(softname));
+
+	g_assert(iio_unlink(fname->str).success);
+	g_assert(!file_exists(softname)); // dangling now
+	g_assert(file_exists(hardname));
+
+	g_assert(iio_unlink(softname).success);
+	g_assert(iio_unlink(hardname).success);
+	g_assert(!iio_unlink(hardname).success);
+
+	g_free(hardname);
+	g_free(softname);
+	g_string_free(fname, TRUE);
+}
+
+void test_io_chmod_chown()
+{
+	GString* fname = g_string_new("test_chmod_");
+	g_string_append_printf(fname, "%d", ABS(g_test_rand_int()));
+	struct stat finfo;
+
+	create_file(fname->str);
+
+	g_assert(iio_chmod(fname->str, 0640).success);
+	g_assert(g_stat(fname->str, &finfo) == 0);
+	g_assert_cmpint(finfo.st_mode & 0777, ==, 0640);
+
+	// changing to the current owner is always permitted
+	g_assert(iio_chown(fname->str, getuid(), -1).success);
+	g_assert(!iio_chmod("doesntexist", 0640).success);
+
+	delete_file(fname->str);
+	g_string_free(fname, TRUE);
+}
+
+void test_io_copy()
+{
+	const CopyMethod methods[] = { COPY_READWRITE, COPY_RANGE, COPY_SENDFILE, COPY_SPLICE };
+	const glong length = 3 * COPY_CHUNK_SIZE + 17;
+	gchar *source, *copy;
+	gsize copyLength;
+	IOStatus status;
+	gint i;
+
+	g_assert(content_configure("random"));
+	g_assert(iio_write("copy_source.dat", length, 0).success);
+	content_configure("zeros");
+	g_assert(g_file_get_contents("copy_source.dat", &source, NULL, NULL));
+
+	for (i=0; i<4; i++) {
+		status = iio_copy("copy_source.dat", "copy_dest.dat", READALL, methods[i]);
+		g_assert(status.success);
+		g_assert_cmpint(status.coreTime.data, ==, length);
+
+		g_assert(g_file_get_contents("copy_dest.dat", &copy, &copyLength, NULL));
+		g_assert_cmpint(copyLength, ==, length);
+		g_assert(memcmp(source, copy, length) == 0);
+		g_free(copy);
+
+		// partial copies truncate the destination
+		g_assert(iio_copy("copy_source.dat", "copy_dest.dat", 4097, methods[i]).success);
+		g_assert(g_file_get_contents("copy_dest.dat", &copy, &copyLength, NULL));
+		g_assert_cmpint(copyLength, ==, 4097);
+		g_assert(memcmp(source, copy, 4097) == 0);
+		g_free(copy);
+
+		// copying beyond the end of the source fails
+		g_assert(!iio_copy("copy_source.dat", "copy_dest.dat", length + 1, methods[i]).success);
+		g_assert(!iio_copy("copy_missing.dat", "copy_dest.dat", READALL, methods[i]).success);
+	}
+
+	// the memfs backend copies between its own files
+	g_assert(iio_engine_select("memfs"));
+	g_assert(iio_write("/copy_source.dat", 10000, 0).success);
+	status = iio_copy("/copy_source.dat", "/copy_dest.dat", READALL, COPY_SPLICE);
+	g_assert(status.success);
+	g_assert_cmpint(status.coreTime.data, ==, 10000);
+	g_assert(iio_read("/copy_dest.dat", READALL, 0).success);
+	g_assert(!iio_copy("/copy_source.dat", "/copy_dest.dat", 10001, COPY_RANGE).success);
+
+	// copying a file onto itself fails and leaves it intact
+	g_assert(!iio_copy("/copy_source.dat", "//./copy_source.dat", READALL, COPY_SPLICE).success);
+	status = iio_read("/copy_source.dat", READALL, 0);
+	g_assert(status.success);
+	g_assert_cmpint(status.coreTime.data, ==, 10000);
+	g_assert(iio_engine_select("posix"));
+
+	g_free(source);
+	g_remove("copy_source.dat");
+	g_remove("copy_dest.dat");
+}
+
+void test_io_stage()
+{
+	const glong length = 5 * 1024 * 1024 + 3;
+	gchar *source, *staged;
+	gsize stagedLength;
+	IOStatus status;
+
+	g_assert(content_configure("random"));
+	g_assert(iio_write("stage_source.dat", length, 0).success);
+	content_configure("zeros");
+	g_assert(g_file_get_contents("stage_source.dat", &source, NULL, NULL));
+	memset(&stageStats, 0, sizeof(StageStats));
+
+	// deep ring and a single buffer with a block size not dividing the file
+	status = stage_run("stage_source.dat", "stage_dest.dat", 64 * 1024, 4);
+	g_assert(status.success);
+	g_assert_cmpint(status.coreTime.data, ==, length);
+	status = stage_run("stage_source.dat", "stage_dest.dat", 100000, 1);
+	g_assert(status.success);
+
+	g_assert(g_file_get_contents("stage_dest.dat", &staged, &stagedLength, NULL));
+	g_assert_cmpint(stagedLength, ==, length);
+	g_assert(memcmp(source, staged, length) == 0);
+	g_free(staged);
+
+	g_assert_cmpint(stageStats.runs, ==, 2);
+	g_assert_cmpint(stageStats.bytes, ==, 2 * length);
+	g_assert(stageStats.readTime > 0 && stageStats.readTime <= stageStats.time);
+	g_assert(stageStats.writeTime > 0 && stageStats.writeTime <= stageStats.time);
+
+	// an empty source gives an empty destination
+	g_assert(g_file_set_contents("stage_source.dat", "", 0, NULL));
+	g_assert(stage_run("stage_source.dat", "stage_dest.dat", 4096, 2).success);
+	g_assert(g_file_get_contents("stage_dest.dat", &staged, &stagedLength, NULL));
+	g_assert_cmpint(stagedLength, ==, 0);
+	g_free(staged);
+
+	g_assert(!stage_run("stage_missing.dat", "stage_dest.dat", 4096, 2).success);
+	g_assert(!stage_run("stage_source.dat", "stage_missing/dest.dat", 4096, 2).success);
+
+	memset(&stageStats, 0, sizeof(StageStats));
+	g_free(source);
+	g_remove("stage_source.dat");
+	g_remove("stage_dest.dat");
+}
+
+void test_io_checkpoint()
+{
+	const gchar* layouts[] = { "nn", "nn:4", "n1:64k", "nm:2" };
+	const gchar* path = "test_checkpoint";
+	CheckpointParams params;
+	gint i;
+
+	// layout and optional count or alignment
+	g_assert(checkpoint_layout_parse("nn", &params));
+	g_assert(params.layout == CHECKPOINT_NN);
+	g_assert_cmpint(params.count, ==, 1);
+	g_assert(checkpoint_layout_parse("NM", &params));
+	g_assert(params.layout == CHECKPOINT_NM);
+	g_assert_cmpint(params.count, ==, 0);
+	g_assert(checkpoint_layout_parse("n1", &params));
+	g_assert_cmpint(params.align, ==, CHECKPOINT_ALIGN);
+	g_assert(checkpoint_layout_parse("n1:64k", &params));
+	g_assert_cmpint(params.align, ==, 64 * 1024);
+	g_assert(checkpoint_layout_parse("nm:3", &params));
+	g_assert_cmpint(params.count, ==, 3);
+
+	g_assert(!checkpoint_layout_parse("nn:", &params));
+	g_assert(!checkpoint_layout_parse("xx", &params));
+	g_assert(!checkpoint_layout_parse("n1:0", &params));
+	g_assert(!checkpoint_layout_parse("nm:2x", &params));
+
+	// write, restart and remove of each layout with verified contents
+	make_dir(path);
+	rank = 0;
+	size = 1;
+	verify_init(11);
+	phases_init();
+
+	for (i=0; i<G_N_ELEMENTS(layouts); i++) {
+		g_assert(checkpoint_layout_parse(layouts[i], &params));
+		params.size = 2 * CHECKPOINT_BLOCK_SIZE + 4097;
+		params.sync = SYNC_NONE;
+		params.restart = TRUE;
+		params.shift = 1;
+
+		memset(&verifyStats, 0, sizeof(VerifyStats));
+		g_assert(checkpoint_run(path, &params));
+		g_assert_cmpint(verifyStats.bytesFilled, ==, params.size);
+		g_assert_cmpint(verifyStats.bytesChecked, ==, params.size);
+		g_assert_cmpint(verifyStats.errors, ==, 0);
+	}
+
+	// one event per phase, the checkpoint files are gone again
+	g_assert_cmpint(g_slist_length(phaseList), ==, 3 * G_N_ELEMENTS(layouts));
+	g_assert_cmpstr(((PhaseEvent*) g_slist_nth_data(phaseList, 0))->phase, ==, "write");
+	g_assert_cmpstr(((PhaseEvent*) g_slist_nth_data(phaseList, 1))->phase, ==, "restart");
+	g_assert_cmpstr(((PhaseEvent*) g_slist_nth_data(phaseList, 2))->phase, ==, "remove");
+	g_assert_cmpint(g_rmdir(path), ==, 0);
+
+	g_assert(checkpoint_layout_parse("nn", &params));
+	g_assert(!checkpoint_run("checkpoint_missing/dir", &params));
+
+	phases_free();
+	phases_init();
+	verifyEnabled = FALSE;
+}
+
+void test_io_dirhandle()
+{
+	GString* dname = g_string_new("test_dirhandle_");
+	g_string_append_printf(dname, "%d", ABS(g_test_rand_int()));
+	gint i;
+
+	make_dir(dname->str);
+
+	File* dir;
+	g_assert(iio_opendir(dname->str, &dir).success);
+	g_assert(dir);
+	g_assert(dir->type == FILE_DIR);
+
+	IOStatus empty = iio_readdir(dir, 4096);
+	g_assert(empty.success);
+
+	for (i=0; i<100; i++) {
+		gchar* name = g_strdup_printf("file.%d", i);
+		g_assert(iio_createat(dir, name).success);
+		g_assert(iio_statat(dir, name).success);
+		g_free(name);
+	}
+	g_assert(!iio_statat(dir, "doesntexist").success);
+
+	// a small buffer needs several getdents64 calls for the same result
+	IOStatus large = iio_readdir(dir, 64*1024);
+	IOStatus small = iio_readdir(dir, 512);
+	g_assert(large.success);
+	g_assert(small.success);
+	g_assert_cmpint(large.coreTime.data, >, empty.coreTime.data);
+	g_assert_cmpint(large.coreTime.data, ==, small.coreTime.data);
+
+	for (i=0; i<100; i++) {
+		gchar* name = g_strdup_printf("file.%d", i);
+		g_assert(iio_unlinkat(dir, name, 0).success);
+		g_free(name);
+	}
+
+	g_assert(iio_closedir(dir).success);
+	g_assert(iio_rmdir(dname->str).success);
+
+	g_string_free(dname, TRUE);
+}
+
+void test_io_null_backend()
+{
+	File* file;
+
+	g_assert(iio_engine_select("null"));
+	g_assert(!g_file_test("null_backend_test", G_FILE_TEST_EXISTS));
+
+	g_assert(iio_fopen("null_backend_test", O_WRONLY|O_CREAT, &file).success);
+	g_assert_cmpint(iio_fwrite(file, 1024, OFFSET_CUR).coreTime.data, ==, 1024);
+	g_assert(iio_fclose(file).success);
+	g_assert(iio_mkdir("null_backend_dir").success);
+
+	// nothing reached the file system
+	g_assert(!g_file_test("null_backend_test", G_FILE_TEST_EXISTS));
+	g_assert(!g_file_test("null_backend_dir", G_FILE_TEST_EXISTS));
+
+	g_assert(iio_engine_select("posix"));
+	g_assert(!iio_engine_select("unknown"));
+}
+
+void test_io_memfs_backend()
+{
+	IOStatus status;
+	File* file;
+	File* dir;
+
+	g_assert(iio_engine_select("memfs"));
+
+	g_assert(iio_mkdir("memfs/sub").success == FALSE);
+	g_assert(iio_mkdir_all("memfs/sub").success);
+	g_assert(!g_file_test("memfs", G_FILE_TEST_EXISTS));
+
+	// handle transfers
+	g_assert(iio_fopen("memfs/sub/data", O_RDWR|O_CREAT, &file).success);
+	g_assert(iio_fwrite(file, 4096, OFFSET_CUR).success);
+	g_assert(iio_fwrite(file, 1024, 8192).success);
+	g_assert_cmpint(iio_fread(file, READALL, OFFSET_CUR).coreTime.data, ==, 9216);
+	g_assert(iio_fseek(file, 0, SEEK_END).success);
+	g_assert(!iio_fread(file, 1, OFFSET_CUR).success);
+	g_assert(iio_ftruncate(file, 100).success);
+	g_assert_cmpint(iio_fread(file, READALL, OFFSET_CUR).coreTime.data, ==, 100);
+
+	// the content is limited to G_MAXUINT bytes
+	g_assert(!iio_fwrite(file, 1, (off_t) G_MAXUINT).success);
+	g_assert(!iio_ftruncate(file, (off_t) G_MAXUINT + 1).success);
+	g_assert(!iio_fallocate(file, (off_t) G_MAXUINT, 1, 0).success);
+	g_assert_cmpint(iio_fread(file, READALL, OFFSET_CUR).coreTime.data, ==, 100);
+	g_assert(iio_fclose(file).success);
+
+	// path based calls
+	g_assert_cmpint(iio_read("memfs/sub/data", READALL, 0).coreTime.data, ==, 100);
+	g_assert(iio_append("memfs/sub/data", 28).success);
+	g_assert_cmpint(iio_read("./memfs//sub/../sub/data", READALL, 0).coreTime.data, ==, 128);
+
+	// READALL reads the file size from the offset, the end is short as with POSIX
+	status = iio_read("memfs/sub/data", READALL, 28);
+	g_assert(!status.success);
+	g_assert_cmpint(status.coreTime.data, ==, 100);
+	g_assert(!iio_read("memfs/sub/missing", 1, 0).success);
+
+	// metadata
+	g_assert(iio_link("memfs/sub/data", "memfs/hardlink").success);
+	g_assert(iio_symlink("sub/data", "memfs/symlink").success);
+	g_assert(!iio_rmdir("memfs/sub").success);
+	g_assert(iio_rename("memfs/sub", "memfs/moved").success);
+	g_assert(iio_stat("memfs/moved/data").success);
+	g_assert(!iio_lookup("memfs/sub/data").success);
+	g_assert(iio_chmod("memfs/moved/data", 0600).success);
+	g_assert(iio_unlink("memfs/moved/data").success);
+	g_assert_cmpint(iio_read("memfs/hardlink", READALL, 0).coreTime.data, ==, 128);
+
+	// directory handle
+	g_assert(iio_opendir("memfs", &dir).success);
+	g_assert(iio_createat(dir, "created").success);
+	g_assert(iio_statat(dir, "moved").success);
+	g_assert_cmpint(iio_readdir(dir, 4096).coreTime.data, >, 0);
+	g_assert(iio_unlinkat(dir, "created", 0).success);
+	g_assert(iio_unlinkat(dir, "hardlink", 0).success);
+	g_assert(iio_unlinkat(dir, "symlink", 0).success);
+	g_assert(iio_unlinkat(dir, "moved", AT_REMOVEDIR).success);
+	g_assert_cmpint(iio_readdir(dir, 4096).coreTime.data, ==, 0);
+	g_assert(iio_closedir(dir).success);
+	g_assert(iio_delete("memfs").success);
+
+	g_assert(iio_engine_select("posix"));
+}
+
+void test_io_emul_backend()
+{
+	const gchar* config =
+		"[emul]\nbackend = memfs\n"
+		"[default]\nlatency = 2000\ndistribution = constant\n"
+		"[write]\nlatency = 0\nbandwidth = 10m\n";
+	gchar* path = "emul_backend_test.conf";
+	IOStatus status;
+
+	g_assert(g_file_set_contents(path, config, -1, NULL));
+	g_assert(iio_emul_configure(path));
+	g_assert(iio_engine_select("emul"));
+
+	status = iio_create("emul_file");
+	g_assert(status.success);
+	g_assert_cmpfloat(status.coreTime.time, >=, 0.002);
+
+	// 1 MiB at 10 MiB/s
+	status = iio_write("emul_file", 1024*1024, 0);
+	g_assert(status.success);
+	g_assert_cmpfloat(status.coreTime.time, >=, 0.1);
+
+	// failed calls are not delayed
+	status = iio_stat("emul_missing");
+	g_assert(!status.success);
+	g_assert_cmpfloat(status.coreTime.time, <, 0.002);
+
+	g_assert(iio_delete("emul_file").success);
+	g_assert(!g_file_test("emul_file", G_FILE_TEST_EXISTS));
+
+	g_assert(iio_engine_select("posix"));
+	g_remove(path);
+}
+
+void test_repetition_statistics()
+{
+	gdouble samples[] = { 4.0, 2.0, 5.0, 1.0, 3.0 };
+	gdouble mean, stddev;
+	StatEvent* event;
+
+	stat_summary(samples, 5, &mean, &stddev);
+	g_assert_cmpfloat(fabs(mean - 3.0), <, 1e-9);
+	g_assert_cmpfloat(fabs(stddev - sqrt(2.5)), <, 1e-9);
+
+	// t(0.975, 4) = 2.776
+	g_assert_cmpfloat(fabs(stat_ci95(stddev, 5) - 2.776 * sqrt(2.5) / sqrt(5)), <, 1e-9);
+	g_assert_cmpfloat(stat_ci95(1.0, 1), ==, 0);
+
+	event = statevent_new(0, "stats", FALSE, samples, 4, 2);
+	g_assert_cmpint(event->samples, ==, 4);
+	g_assert_cmpint(event->warmup, ==, 2);
+	g_assert_cmpfloat(event->min, ==, 1.0);
+	g_assert_cmpfloat(event->max, ==, 5.0);
+	g_assert_cmpfloat(event->median, ==, 3.0);
+	g_assert_cmpfloat(event->mean, ==, 3.0);
+	g_assert_cmpstr(event->name, ==, "stats");
+	g_free(event);
+}
+
+void test_repetition_warmup()
+{
+	// time["outer"] repeat 3 warmup 2 { ctime["inner"] { lookup "." } }
+	ParameterList* sampling = param_list_new();
+	ParameterList* lookup = param_list_new();
+	Expression* repeat = expr_constant_int_new(3);
+	Expression* warmup = expr_constant_int_new(2);
+	Expression* ci = expr_constant_int_new(0);
+	Expression* path = expr_constant_string_new(".");
+	GNode *outer, *inner;
+
+	param_list_append(sampling, repeat);
+	param_list_append(sampling, warmup);
+	param_list_append(sampling, ci);
+	param_list_append(lookup, path);
+
+	iiInit(NULL);
+	ast = g_node_new(stmt_new(STMT_BLOCK, NULL, NULL, 1));
+	outer = g_node_append_data(ast, stmt_new(STMT_TIME, sampling, "outer", 1));
+	inner = g_node_append_data(outer, stmt_new(STMT_CTIME, NULL, "inner", 1));
+	g_node_append_data(inner, stmt_new(STMT_LOOKUP, lookup, NULL, 1));
+
+	iiStart();
+
+	// warm-up runs of labelled children are neither recorded nor counted
+	g_assert_cmpint(g_slist_length(timeList), ==, 3);
+	g_assert_cmpint(g_slist_length(coreTimeList), ==, 3);
+	g_assert_cmpint(g_slist_length(statList), ==, 1);
+	g_assert_cmpint(statementsSucceed[STMT_LOOKUP], ==, 3);
+	g_assert(!warmingUp);
+
+	iiFree();
+}
+
+void test_throughput_sampler()
+{
+	CoreTimeEvent* event = coretime_event_new(0, "sampled", coretime_new(0, 0));
+	SampleSeries* series;
+	GList* stack = g_list_prepend(NULL, event);
+
+	sampler_init();
+	sampler_configure(20, 4);
+	sampler_attach(event);
+
+	dump_coretime(stack, coretime_new(0.001, 1024));
+	dump_coretime(stack, coretime_new(0.001, 1024));
+	g_usleep(50000);
+	dump_coretime(stack, coretime_new(0.001, 4096));
+
+	g_assert_cmpint(g_slist_length(sampleList), ==, 1);
+	series = sampleList->data;
+	g_assert_cmpint(series->ring[0].data, ==, 2048);
+	g_assert_cmpint(series->ring[0].ops, ==, 2);
+	g_assert_cmpint(series->current, >=, 2);
+	g_assert_cmpint(series->ring[1].ops, ==, 0);
+	g_assert_cmpint(series->ring[series->current % 4].data, ==, 4096);
+	g_assert_cmpint(series->dropped, ==, 0);
+
+	// idle time longer than the ring only keeps the newest intervals
+	g_usleep(120000);
+	sampler_detach(event);
+	g_assert(series->event == NULL);
+	g_assert_cmpint(series->dropped, >, 0);
+	g_assert_cmpint(series->current - series->first, ==, 3);
+
+	// calls after the block are not recorded anymore
+	dump_coretime(stack, coretime_new(0.001, 1024));
+	g_assert_cmpint(series->ring[series->current % 4].ops, ==, 0);
+
+	g_assert(sampler_export("sampler_test"));
+	g_assert(g_file_test("sampler_test/samples_0.csv", G_FILE_TEST_EXISTS));
+	g_remove("sampler_test/samples_0.csv");
+	g_rmdir("sampler_test");
+
+	sampler_free();
+	g_list_free(stack);
+	g_free(event);
+}
+
+void test_io_trace()
+{
+	File* file;
+	TraceHeader* header;
+	TraceRecord* records;
+	gchar* contents;
+	gsize length, i, numRecords;
+	gint calls = 0, strings = 0;
+
+	g_assert(trace_start("trace_test", 4));
+	g_assert(traceEnabled);
+
+	traceLine = 42;
+	g_assert(iio_fcreat("trace_file", &file).success);
+	g_assert(iio_fwrite(file, 4096, 1024).success);
+	g_assert(iio_fclose(file).success);
+	g_assert(!iio_stat("trace_missing").success);
+	g_assert(iio_delete("trace_file").success);
+
+	trace_stop();
+	g_assert(!traceEnabled);
+
+	g_assert(g_file_get_contents("trace_test/trace_0.pbt", &contents, &length, NULL));
+	header = (TraceHeader*) contents;
+	g_assert_cmpstr(header->magic, ==, TRACE_MAGIC);
+	g_assert_cmpint(header->recordSize, ==, sizeof(TraceRecord));
+
+	records = (TraceRecord*) (contents + sizeof(TraceHeader));
+	numRecords = (length - sizeof(TraceHeader)) / sizeof(TraceRecord);
+
+	for (i=0; i<numRecords; i++) {
+		if (records[i].flags & TRACE_STRING) {
+			i += (records[i].size + sizeof(TraceRecord) - 1) / sizeof(TraceRecord);
+			strings++;
+			continue;
+		}
+
+		g_assert_cmpint(records[i].line, ==, 42);
+		calls++;
+
+		// the write is attributed to the path of the handle
+		if (records[i].offset == 1024) {
+			g_assert_cmpint(records[i].size, ==, 4096);
+			g_assert(records[i].flags & TRACE_SUCCESS);
+			g_assert_cmpint(records[i].file, ==, records[0].op);
+		}
+	}
+
+	// fcreat, fwrite, fclose, stat and delete on 2 paths
+	g_assert_cmpint(calls, ==, 5);
+	g_assert_cmpint(strings, ==, 7);
+
+	g_free(contents);
+	g_remove("trace_test/trace_0.pbt");
+	g_rmdir("trace_test");
+}
+
+void test_global_clock()
+{
+	gdouble before, after;
+
+	clock_init();
+	clock_sync();
+	g_assert_cmpfloat(clockOffset, ==, 0);
+
+	clock_start();
+	before = clock_elapsed();
+	g_assert_cmpfloat(before, >=, 0);
+	g_assert_cmpfloat(before, <, 0.1);
+
+	g_usleep(10000);
+	after = clock_elapsed();
+	g_assert_cmpfloat(after - before, >=, 0.01);
+	g_assert_cmpfloat(clock_global() - clockStart, >=, after);
+}
+
+void test_export()
+{
+	TimeEvent event = { 0, 3, 1.5, 0.25, 1.75, "write \"a\";b" };
+	TimeEvent other = { 1, 3, 2.5, 0.25, 2.75, "write \"a\";b" };
+	CoreTimeEvent core = { .proc = 0, .id = 2, .name = "pwrite" };
+	GSList *savedTimeList, *savedCoreTimeList;
+	gchar* params[] = { "42" };
+	gchar *contents, *first, *second;
+	gchar** lines;
+
+	rank = 0;
+	size = 1;
+
+	/* jsonl: run description first, then one object per event */
+	g_assert(export_open(EXPORT_JSONL, "export_test.jsonl"));
+	export_run("kernel.pbl", 1, params);
+	export_time_event(&event);
+	export_close();
+
+	g_assert(g_file_get_contents("export_test.jsonl", &contents, NULL, NULL));
+	lines = g_strsplit(contents, "\n", 0);
+	g_assert_cmpint(g_strv_length(lines), ==, 3);
+	g_assert(g_str_has_prefix(lines[0], "{\"type\":\"run\",\"kernel\":\"kernel.pbl\""));
+	g_assert(strstr(lines[0], "\"parameters\":[\"42\"]"));
+	g_assert_cmpstr(lines[1], ==, "{\"type\":\"time\",\"rank\":0,\"id\":3,"
+			"\"name\":\"write \\\"a\\\";b\",\"walltime\":1.5,\"start\":0.25,\"end\":1.75}");
+	g_strfreev(lines);
+	g_free(contents);
+	g_remove("export_test.jsonl");
+
+	/* csv: metadata comments, header and one row per metric */
+	g_assert(export_open(EXPORT_CSV, "export_test.csv"));
+	export_run("kernel.pbl", 1, params);
+	export_time_event(&event);
+	export_close();
+
+	g_assert(g_file_get_contents("export_test.csv", &contents, NULL, NULL));
+	g_assert(g_str_has_prefix(contents, "# kernel: kernel.pbl\n"));
+	g_assert(strstr(contents, "# parameter 1: 42\n"));
+	g_assert(strstr(contents, "type;rank;id;name;metric;value\n"
+			"time;0;3;\"write \"\"a\"\";b\";walltime;1.5\n"));
+	g_free(contents);
+	g_remove("export_test.csv");
+
+	/* xml: open elements are closed when the export is closed */
+	g_assert(export_open(EXPORT_XML, "export_test.xml"));
+	export_run("kernel.pbl", 1, params);
+	export_time_event(&event);
+	export_close();
+
+	g_assert(g_file_get_contents("export_test.xml", &contents, NULL, NULL));
+	g_assert(strstr(contents, "<Parameter>42</Parameter>"));
+	g_assert(strstr(contents, "<EventList type=\"Time\">"));
+	g_assert(strstr(contents, "name=\"write &quot;a&quot;;b\""));
+	g_assert(g_str_has_suffix(contents, "</Report>\n"));
+	g_free(contents);
+	g_remove("export_test.xml");
+
+	/* xml: gathered events are sorted, core time events first */
+	savedTimeList = timeList;
+	savedCoreTimeList = coreTimeList;
+	timeList = g_slist_prepend(g_slist_prepend(NULL, &event), &other);
+	coreTimeList = g_slist_prepend(NULL, &core);
+
+	g_assert(export_open(EXPORT_XML, "export_test.xml"));
+	g_assert(!export_streaming());
+	export_run("kernel.pbl", 1, params);
+	export_events();
+	export_close();
+
+	g_assert(g_file_get_contents("export_test.xml", &contents, NULL, NULL));
+	first = strstr(contents, "<EventList type=\"CoreTime\">");
+	second = strstr(contents, "<EventList type=\"Time\">");
+	g_assert(first && second && first < second);
+
+	// lists without events are written as well
+	g_assert(strstr(contents, "<EventList type=\"Statistics\"/>"));
+	g_assert(strstr(contents, "<EventList type=\"Phase\"/>"));
+	first = strstr(second, "rank=\"0\"");
+	second = strstr(second, "rank=\"1\"");
+	g_assert(first && second && first < second);
+	g_free(contents);
+	g_remove("export_test.xml");
+
+	g_slist_free(timeList);
+	g_slist_free(coreTimeList);
+	timeList = savedTimeList;
+	coreTimeList = savedCoreTimeList;
+}
+
+void test_io_verify()
+{
+	const gchar* path = "verify_test.dat";
+	IOStatus status;
+	File* file;
+	gchar* buffer;
+	gchar byte;
+	int fd;
+
+	rank = 3;
+	size = 4;
+	verify_init(7);
+
+	// unaligned offsets and lengths, written by rank 3
+	status = iio_write(path, 10000, 13);
+	g_assert(status.success);
+	g_assert_cmpint(verifyStats.bytesFilled, ==, 10000);
+
+	status = iio_fopen(path, O_RDWR, &file);
+	g_assert(status.success);
+	status = iio_fwrite(file, 3000, 10013);
+	g_assert(status.success);
+
+	// another rank can check what rank 3 wrote
+	rank = 0;
+	g_assert(iio_fread(file, 13000, 13).success);
+	g_assert(iio_fread(file, 101, 5003).success);
+	g_assert(iio_read(path, 7, 8190).success);
+	g_assert_cmpint(verifyStats.bytesChecked, ==, 13108);
+	g_assert_cmpint(verifyStats.errors, ==, 0);
+
+	// the zeros in front of the first write aren't part of the pattern
+	g_assert(!iio_fread(file, 20, 0).success);
+	g_assert_cmpint(verifyStats.errors, >, 0);
+
+	// a single flipped byte is found
+	verifyStats.errors = 0;
+	fd = open(path, O_WRONLY);
+	g_assert_cmpint(pwrite(fd, "x", 1, 4242), ==, 1);
+	close(fd);
+	g_assert(!iio_fread(file, 1000, 4000).success);
+	g_assert_cmpint(verifyStats.errors, ==, 1);
+	g_assert(iio_fread(file, 1000, 5000).success);
+
+	// so is a word that names another valid writer than the rest of the read
+	verifyStats.errors = 0;
+	fd = open(path, O_RDWR);
+	g_assert_cmpint(pread(fd, &byte, 1, 6005), ==, 1);
+	byte ^= 3 ^ 1;
+	g_assert_cmpint(pwrite(fd, &byte, 1, 6005), ==, 1);
+	close(fd);
+	g_assert(!iio_fread(file, 1000, 5500).success);
+	g_assert_cmpint(verifyStats.errors, ==, 1);
+	g_assert(iio_fread(file, 1000, 7000).success);
+
+	// callers that know the writer pass its rank
+	buffer = g_malloc(100);
+	verify_fill(buffer, 100, 99, 13);
+	g_assert(!verify_check(buffer, 100, 99, 13, 2));
+	g_assert(verify_check(buffer, 100, 99, 13, 0));
+	g_free(buffer);
+
+	g_assert(iio_fclose(file).success);
+	g_remove(path);
+
+	verifyEnabled = FALSE;
+	size = 1;
+}
+
+static gint count_unique_blocks(const gchar* buffer, glong length, glong blockSize)
+{
+	gint unique = 0;
+	glong pos, prev;
+
+	for (pos=0; pos<length; pos+=blockSize) {
+		for (prev=0; prev<pos; prev+=blockSize)
+			if (memcmp(buffer + prev, buffer + pos, blockSize) == 0)
+				break;
+		unique += (prev == pos);
+	}
+
+	return unique;
+}
+
+void test_buffer_content()
+{
+	const glong length = 64 * 1024;
+	gchar* first = g_malloc0(length);
+	gchar* second = g_malloc0(length);
+	glong i, zeros;
+
+	g_assert(!content_configure("ones"));
+	g_assert(!content_configure("random:2"));
+	g_assert(!content_configure("compress:0.5"));
+	g_assert(!content_configure("dedup:2:100"));
+
+	// constant buffers are left to the writers
+	g_assert(content_configure("zeros"));
+	content_fill(first, length);
+	for (i=0; i<length && first[i] == 0; i++);
+	g_assert_cmpint(i, ==, length);
+
+	// every block of every write is unique
+	g_assert(content_configure("random"));
+	content_fill(first, length);
+	content_fill(second, length);
+	g_assert_cmpint(count_unique_blocks(first, length, 4096), ==, 16);
+	g_assert(memcmp(first, second, 4096) != 0);
+
+	// a quarter of every block is random
+	g_assert(content_configure("compress:4"));
+	content_fill(first, length);
+	for (i=0, zeros=0; i<4096; i++)
+		zeros += (first[i] == 0);
+	g_assert_cmpint(zeros, >=, 3072);
+	g_assert_cmpint(zeros, <, 3072 + 64);
+
+	// only every fourth 8k block is unique
+	g_assert(content_configure("dedup:4:8k"));
+	g_assert_cmpint(contentBlockSize, ==, 8192);
+	content_fill(first, length);
+	content_fill(second, length);
+	g_assert_cmpint(count_unique_blocks(first, length, 8192), ==, 2);
+	g_assert(memcmp(first, second, 8192) != 0);
+
+	content_configure("zeros");
+	content_free();
+	g_free(first);
+	g_free(second);
+}
+
+void test_cache_control()
+{
+	const gchar* dir = "cache_test";
+	gchar* shifted;
+
+	g_assert(g_mkdir(dir, 0755) == 0);
+	g_assert(iio_write("cache_test/a.dat", 64 * 1024, 0).success);
+	g_assert(iio_write("cache_test/b.dat", 4096, 0).success);
+
+	// single files and whole trees
+	g_assert(cache_evict("cache_test/a.dat").success);
+	g_assert(cache_evict(dir).success);
+	g_assert(!cache_evict("cache_test/missing.dat").success);
+
+	// the scratch file is removed again
+	g_assert(cache_scratch("cache_test/scratch.dat", 3 * CACHE_SCRATCH_CHUNK + 17).success);
+	g_assert(!g_file_test("cache_test/scratch.dat", G_FILE_TEST_EXISTS));
+	g_assert(!cache_scratch("cache_missing/scratch.dat", 4096).success);
+	g_assert_cmpint(cache_memory_size(), >, 0);
+
+	// rank r reads what rank r+k wrote
+	rank = 3;
+	size = 4;
+	shifted = var_replace_substrings("cache_test/$$shift(1).dat");
+	g_assert_cmpstr(shifted, ==, "cache_test/0.dat");
+	g_free(shifted);
+	shifted = var_replace_substrings("$$shift(-5)-$$size");
+	g_assert_cmpstr(shifted, ==, "2-4");
+	g_free(shifted);
+	rank = 0;
+	size = 1;
+
+	g_remove("cache_test/a.dat");
+	g_remove("cache_test/b.dat");
+	g_rmdir(dir);
+}
+
 int main(int argc, char *argv[])
 {
 	g_test_init(&argc, &argv, NULL);
@@ -497,6 +1433,27 @@ int main(int argc, char *argv[])
 	g_test_add_func("/POSIX IO/Create", test_io_create);
 	g_test_add_func("/POSIX IO/Stat", test_io_stat);
 	g_test_add_func("/POSIX IO/Rename", test_io_rename);
+	g_test_add_func("/POSIX IO/FStat and FCntl", test_io_fstat_fcntl);
+	g_test_add_func("/POSIX IO/Fallocate, ftruncate, fadvise, syncrange", test_io_fallocate);
+	g_test_add_func("/POSIX IO/Sync policy", test_io_sync_policy);
+	g_test_add_func("/POSIX IO/Link, symlink and unlink", test_io_links);
+	g_test_add_func("/POSIX IO/Chmod and chown", test_io_chmod_chown);
+	g_test_add_func("/POSIX IO/Copy", test_io_copy);
+	g_test_add_func("/POSIX IO/Staging", test_io_stage);
+	g_test_add_func("/POSIX IO/Checkpoint", test_io_checkpoint);
+	g_test_add_func("/POSIX IO/Directory handle", test_io_dirhandle);
+	g_test_add_func("/POSIX IO/Null backend", test_io_null_backend);
+	g_test_add_func("/POSIX IO/Memfs backend", test_io_memfs_backend);
+	g_test_add_func("/POSIX IO/Emulation backend", test_io_emul_backend);
+	g_test_add_func("/POSIX IO/Repetition statistics", test_repetition_statistics);
+	g_test_add_func("/POSIX IO/Repetition warm-up", test_repetition_warmup);
+	g_test_add_func("/POSIX IO/Throughput sampler", test_throughput_sampler);
+	g_test_add_func("/POSIX IO/Trace", test_io_trace);
+	g_test_add_func("/POSIX IO/Global clock", test_global_clock);
+	g_test_add_func("/POSIX IO/Result export", test_export);
+	g_test_add_func("/POSIX IO/Data verification", test_io_verify);
+	g_test_add_func("/POSIX IO/Buffer content", test_buffer_content);
+	g_test_add_func("/POSIX IO/Cache control", test_cache_control);
 
 	return g_test_run();
 }
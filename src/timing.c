@@ -19,13 +19,17 @@
 #include "config.h"
 #include "common.h"
 #include "timing.h"
+#include "sampler.h"
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
 
 
 void timing_init()
 {
 	timeList = NULL;
 	coreTimeList = NULL;
+	statList = NULL;
 
 	coreTimeStack = NULL;
 }
@@ -42,6 +46,11 @@ void timing_free()
 		g_slist_free(coreTimeList);
 	}
 
+	if (statList) {
+		g_slist_foreach(statList, (GFunc) g_free, NULL);
+		g_slist_free(statList);
+	}
+
 	if (coreTimeStack)
 		g_list_free(coreTimeStack);
 }
@@ -84,11 +93,95 @@ CoreTimeEvent* coretime_event_new(gint id, const gchar* name, CoreTime coreTime)
 	return event;
 }
 
+static gint compare_doubles(gconstpointer a, gconstpointer b)
+{
+	gdouble d0 = *((gdouble*) a);
+	gdouble d1 = *((gdouble*) b);
+
+	return (d0 < d1)? -1 : (d0 > d1);
+}
+
+/**
+ * Mean and sample standard deviation, stddev is 0 for less than 2 samples.
+ */
+void stat_summary(const gdouble* samples, glong numSamples, gdouble* mean, gdouble* stddev)
+{
+	gdouble sum = 0, squares = 0;
+	glong i;
+
+	for (i=0; i<numSamples; i++)
+		sum += samples[i];
+	*mean = (numSamples > 0)? sum / numSamples : 0;
+
+	for (i=0; i<numSamples; i++)
+		squares += (samples[i] - *mean) * (samples[i] - *mean);
+	*stddev = (numSamples > 1)? sqrt(squares / (numSamples - 1)) : 0;
+}
+
+/**
+ * Half width of the 95% confidence interval of the mean, based on the
+ * two-sided Student's t distribution.
+ */
+gdouble stat_ci95(gdouble stddev, glong numSamples)
+{
+	static const gdouble t[] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+	glong df = numSamples - 1;
+	gdouble quantile;
+
+	if (df < 1)
+		return 0;
+	else if (df <= 30)
+		quantile = t[df-1];
+	else if (df <= 60)
+		quantile = 2.000;
+	else if (df <= 120)
+		quantile = 1.980;
+	else
+		quantile = 1.960;
+
+	return quantile * stddev / sqrt(numSamples);
+}
+
+StatEvent* statevent_new(gint id, const gchar* name, gboolean core, const gdouble* samples, glong numSamples, glong warmup)
+{
+	StatEvent* event = g_malloc0(sizeof(StatEvent));
+	gdouble* sorted = g_memdup(samples, numSamples * sizeof(gdouble));
+#ifdef HAVE_MPI
+	event->proc = rank;
+#else
+	event->proc = 0;
+#endif
+	event->id = id;
+	strncpy(event->name, name, NAME_SIZE);
+	event->core = core;
+	event->samples = numSamples;
+	event->warmup = warmup;
+
+	stat_summary(samples, numSamples, &event->mean, &event->stddev);
+	event->ci = stat_ci95(event->stddev, numSamples);
+
+	if (numSamples > 0) {
+		qsort(sorted, numSamples, sizeof(gdouble), compare_doubles);
+		event->min = sorted[0];
+		event->max = sorted[numSamples-1];
+		event->median = (numSamples % 2)? sorted[numSamples/2]
+				: (sorted[numSamples/2-1] + sorted[numSamples/2]) / 2;
+	}
+
+	g_free(sorted);
+	return event;
+}
+
 CoreTime coretime_new(gdouble time, glong data)
 {
 	CoreTime coreTime;
 	coreTime.time = time;
 	coreTime.data = data;
+	coreTime.sync = 0;
 
 	return coreTime;
 }
@@ -172,9 +265,40 @@ void dump_coretime(GList* coreTimeStack, CoreTime coreTime)
 			activeCoreTimeEvent->minCallTime = currentCt;
 		if (currentCt > activeMaxCt)
 			activeCoreTimeEvent->maxCallTime = currentCt;
+
+
+		//
+		// sync time:
+
+		if (coreTime.sync > 0) {
+			activeCoreTimeEvent->numSyncs++;
+			activeCoreTimeEvent->syncTime += coreTime.sync;
+			if (coreTime.sync > activeCoreTimeEvent->maxSyncTime)
+				activeCoreTimeEvent->maxSyncTime = coreTime.sync;
+		}
+
+		sampler_record(activeCoreTimeEvent, coreTime);
 	}
 }
 
+/**
+ * Keeps the CPU busy for usec microseconds, standing in for the
+ * computation of an application. Unlike sleep the process stays
+ * runnable, so progress of background I/O isn't helped by idle cores.
+ * Returns the seconds actually spent.
+ */
+gdouble compute_busy(glong usec)
+{
+	GTimer* timer = g_timer_new();
+	gdouble seconds = usec / 1e6;
+	gdouble elapsed;
+
+	while ((elapsed = g_timer_elapsed(timer, NULL)) < seconds);
+	g_timer_destroy(timer);
+
+	return elapsed;
+}
+
 gint compare_time_events(gconstpointer a, gconstpointer b)
 {
 	TimeEvent* e0 = (TimeEvent*) a;
@@ -281,3 +405,14 @@ gint compare_coretime_events_full(gconstpointer a, gconstpointer b)
 		}
 	}
 }
+
+gint compare_stat_events(gconstpointer a, gconstpointer b)
+{
+	StatEvent* e0 = (StatEvent*) a;
+	StatEvent* e1 = (StatEvent*) b;
+
+	if (e0->proc != e1->proc)
+		return (e0->proc < e1->proc)? -1 : 1;
+
+	return (e0->id < e1->id)? -1 : (e0->id > e1->id);
+}
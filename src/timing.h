@@ -30,24 +30,29 @@
 
 #ifdef HAVE_MPI
 MPI_Datatype timeevent_type;
-MPI_Datatype coretimeevent_type;
 #endif
 
 GList*  coreTimeStack;
 
 GSList* timeList;			// list with completed time events
 GSList* coreTimeList;		// list with completed core time events
+GSList* statList;			// list with statistics of repeated time statements
+
+gboolean warmingUp;			// set during warm-up runs, which record no events
 
 typedef struct {
 	gint proc;				// process id
 	gint id;				// used to keep track of global command start order
 	gdouble value;			// time value
+	gdouble start;			// start on the global timeline (see clocksync.h)
+	gdouble end;			// end on the global timeline
 	gchar name[NAME_SIZE];	// name of the time event
 } TimeEvent;
 
 typedef struct {
 	gdouble time;			// duration of I/O function core
 	glong   data;			// data processed in I/O function core
+	gdouble sync;			// part of time spent in fsync/fdatasync
 } CoreTime;
 
 typedef struct {
@@ -60,9 +65,31 @@ typedef struct {
 	// get average call time from: avgCoreTime.time / numCalls
 	gdouble minCallTime;	// min raw I/O call time
 	gdouble maxCallTime;	// max raw I/O call time
+	glong numSyncs;			// number of calls that included a sync
+	gdouble syncTime;		// accumulated sync time
+	gdouble maxSyncTime;	// max sync time of a single call
+	gdouble start;			// start of the block on the global timeline
+	gdouble end;			// end of the block on the global timeline
 	gchar name[NAME_SIZE];	// name of the time event
 } CoreTimeEvent;
 
+typedef struct {
+	gint proc;				// process id
+	gint id;				// used to keep track of global command start order
+	gboolean core;			// samples are core times (ctime) instead of wall times
+	glong samples;			// number of measured repetitions
+	glong warmup;			// number of discarded warm-up repetitions
+	gdouble mean;
+	gdouble stddev;			// sample standard deviation
+	gdouble median;
+	gdouble min;
+	gdouble max;
+	gdouble ci;				// half width of the 95% confidence interval of the mean
+	gdouble start;			// start of the first measured repetition on the global timeline
+	gdouble end;			// end of the last repetition on the global timeline
+	gchar name[NAME_SIZE];	// label of the time statement
+} StatEvent;
+
 
 void timing_init();
 void timing_free();
@@ -70,14 +97,21 @@ void timing_free();
 TimeEvent*		timeevent_new(gint id, const gchar* name, gdouble value);
 CoreTimeEvent*	coretime_event_new(gint id, const gchar* name, CoreTime coreTime);
 CoreTime		coretime_new(gdouble time, glong data);
+StatEvent*		statevent_new(gint id, const gchar* name, gboolean core, const gdouble* samples, glong numSamples, glong warmup);
+
+void    stat_summary(const gdouble* samples, glong numSamples, gdouble* mean, gdouble* stddev);
+gdouble stat_ci95(gdouble stddev, glong numSamples);
 
 gchar* format_coretime_throughput(CoreTime coreTime);
 gchar* format_data_size(glong dataSize);
 void   dump_coretime(GList* coreTimeStack, CoreTime coreTime);
 
+gdouble compute_busy(glong usec);
+
 gint compare_time_events(gconstpointer a, gconstpointer b);
 gint compare_time_events_full(gconstpointer a, gconstpointer b);
 gint compare_coretime_events(gconstpointer a, gconstpointer b);
 gint compare_coretime_events_full(gconstpointer a, gconstpointer b);
+gint compare_stat_events(gconstpointer a, gconstpointer b);
 
 #endif /* TIMING_H_ */
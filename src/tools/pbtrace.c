@@ -0,0 +1,239 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Converts the per-rank binary traces written by parabench --trace.
+ *
+ *   pbtrace [--format=csv|chrome] [--output=FILE] trace/trace_*.pbt
+ *
+ * csv:    rank;start;op;file;offset;size;latency;line;success
+ *         (start in seconds since the kernel started on the master,
+ *         latency in seconds)
+ * chrome: Trace Event Format JSON, open in chrome://tracing or Perfetto.
+ *         Every rank is shown as one process.
+ */
+
+#include "../trace_format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gprintf.h>
+
+typedef struct {
+	TraceHeader header;
+	GPtrArray* strings;		// string id -> gchar*
+	TraceRecord* records;	// call records only, strings resolved
+	gsize numRecords;
+} Trace;
+
+static gchar* format = "csv";
+static gchar* output = NULL;
+
+static GOptionEntry entries[] =
+{
+	{ "format", 'f', 0, G_OPTION_ARG_STRING, &format, "Output format: csv (default) or chrome", "FORMAT" },
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Write to FILE instead of stdout", "FILE" },
+	{ NULL }
+};
+
+
+static const gchar* trace_string(const Trace* trace, guint32 id)
+{
+	return (id > 0 && id < trace->strings->len)? g_ptr_array_index(trace->strings, id) : "";
+}
+
+static Trace* trace_load(const gchar* filename)
+{
+	gchar* contents;
+	gsize length, pos, numSlots;
+	GError* error = NULL;
+
+	if (!g_file_get_contents(filename, &contents, &length, &error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		return NULL;
+	}
+
+	Trace* trace = g_malloc0(sizeof(Trace));
+	memcpy(&trace->header, contents, MIN(length, sizeof(TraceHeader)));
+
+	if (length < sizeof(TraceHeader) || strcmp(trace->header.magic, TRACE_MAGIC) != 0
+			|| trace->header.version != TRACE_VERSION || trace->header.recordSize != sizeof(TraceRecord)) {
+		g_printerr("%s is not a parabench trace of version %d\n", filename, TRACE_VERSION);
+		g_free(contents);
+		g_free(trace);
+		return NULL;
+	}
+
+	numSlots = (length - sizeof(TraceHeader)) / sizeof(TraceRecord);
+	TraceRecord* slots = (TraceRecord*) (contents + sizeof(TraceHeader));
+
+	trace->strings = g_ptr_array_new();
+	g_ptr_array_add(trace->strings, NULL);
+	trace->records = g_malloc(numSlots * sizeof(TraceRecord));
+
+	for (pos=0; pos<numSlots; pos++) {
+		if (slots[pos].flags & TRACE_STRING) {
+			gsize strLength = slots[pos].size;
+			gsize strSlots = (strLength + sizeof(TraceRecord) - 1) / sizeof(TraceRecord);
+
+			if (pos + strSlots >= numSlots) {
+				g_printerr("%s: truncated string record\n", filename);
+				break;
+			}
+
+			while (trace->strings->len <= slots[pos].op)
+				g_ptr_array_add(trace->strings, NULL);
+			g_ptr_array_index(trace->strings, slots[pos].op) = g_strndup((gchar*) &slots[pos+1], strLength);
+			pos += strSlots;
+		}
+		else
+			trace->records[trace->numRecords++] = slots[pos];
+	}
+
+	g_free(contents);
+	return trace;
+}
+
+static void trace_free(Trace* trace)
+{
+	g_ptr_array_foreach(trace->strings, (GFunc) g_free, NULL);
+	g_ptr_array_free(trace->strings, TRUE);
+	g_free(trace->records);
+	g_free(trace);
+}
+
+static void json_write_string(FILE* out, const gchar* string)
+{
+	const gchar* c;
+
+	fputc('"', out);
+	for (c=string; *c; c++) {
+		if (*c == '"' || *c == '\\')
+			g_fprintf(out, "\\%c", *c);
+		else if ((guchar) *c < 0x20)
+			g_fprintf(out, "\\u%04x", *c);
+		else
+			fputc(*c, out);
+	}
+	fputc('"', out);
+}
+
+static void write_csv(FILE* out, GPtrArray* traces)
+{
+	guint i;
+	gsize j;
+
+	g_fprintf(out, "rank;start;op;file;offset;size;latency;line;success\n");
+
+	for (i=0; i<traces->len; i++) {
+		Trace* trace = g_ptr_array_index(traces, i);
+		gdouble shift = trace->header.origin;
+
+		for (j=0; j<trace->numRecords; j++) {
+			TraceRecord* r = &trace->records[j];
+			g_fprintf(out, "%d;%.9f;%s;%s;%" G_GINT64_FORMAT ";%" G_GINT64_FORMAT ";%.9f;%u;%d\n",
+					trace->header.rank, shift + r->start / 1e9, trace_string(trace, r->op),
+					trace_string(trace, r->file), r->offset, r->size, r->latency / 1e9, r->line,
+					(r->flags & TRACE_SUCCESS) != 0);
+		}
+	}
+}
+
+static void write_chrome(FILE* out, GPtrArray* traces)
+{
+	gboolean first = TRUE;
+	guint i;
+	gsize j;
+
+	g_fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+	for (i=0; i<traces->len; i++) {
+		Trace* trace = g_ptr_array_index(traces, i);
+		gdouble shift = trace->header.origin * 1e6;
+
+		g_fprintf(out, "%s{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}",
+				(first? "" : ",\n"), trace->header.rank, trace->header.rank);
+		first = FALSE;
+
+		for (j=0; j<trace->numRecords; j++) {
+			TraceRecord* r = &trace->records[j];
+
+			g_fprintf(out, ",\n{\"ph\":\"X\",\"cat\":\"io\",\"name\":");
+			json_write_string(out, trace_string(trace, r->op));
+			g_fprintf(out, ",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"file\":",
+					trace->header.rank, shift + r->start / 1e3, r->latency / 1e3);
+			json_write_string(out, trace_string(trace, r->file));
+			g_fprintf(out, ",\"offset\":%" G_GINT64_FORMAT ",\"size\":%" G_GINT64_FORMAT ",\"line\":%u,\"success\":%s}}",
+					r->offset, r->size, r->line, (r->flags & TRACE_SUCCESS)? "true" : "false");
+		}
+	}
+
+	g_fprintf(out, "\n]}\n");
+}
+
+int main(int argc, char** argv)
+{
+	GError* error = NULL;
+	GOptionContext* context;
+	GPtrArray* traces = g_ptr_array_new();
+	FILE* out = stdout;
+	gint i;
+
+	context = g_option_context_new("TRACE...");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("option parsing failed: %s\n", error->message);
+		return 1;
+	}
+	g_option_context_free(context);
+
+	if (argc < 2 || (strcmp(format, "csv") != 0 && strcmp(format, "chrome") != 0)) {
+		g_printerr("usage: pbtrace [--format=csv|chrome] [--output=FILE] TRACE...\n");
+		return 1;
+	}
+
+	for (i=1; i<argc; i++) {
+		Trace* trace = trace_load(argv[i]);
+		if (!trace)
+			return 1;
+
+		g_ptr_array_add(traces, trace);
+	}
+
+	if (output && !(out = fopen(output, "w"))) {
+		g_printerr("Couldn't open %s for writing\n", output);
+		return 1;
+	}
+
+	if (strcmp(format, "csv") == 0)
+		write_csv(out, traces);
+	else
+		write_chrome(out, traces);
+
+	if (out != stdout)
+		fclose(out);
+
+	g_ptr_array_foreach(traces, (GFunc) trace_free, NULL);
+	g_ptr_array_free(traces, TRUE);
+
+	return 0;
+}
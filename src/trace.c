@@ -0,0 +1,303 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "common.h"
+#include "trace.h"
+#include "clocksync.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <glib/gstdio.h>
+
+#define TRACE_CALIBRATION_EVENTS 20000
+
+typedef struct {
+	TraceRecord* records;
+	guint capacity;			// power of two
+	volatile gint head;		// next slot written by the interpreter
+	volatile gint tail;		// next slot drained by the flusher
+} TraceRing;
+
+static TraceRing ring;
+static GThread* flusher = NULL;
+static volatile gint flusherRunning = 0;
+static FILE* traceFile = NULL;
+
+static struct timespec traceOrigin;
+static GHashTable* stringIds = NULL;	// operation names and paths -> string id
+static GHashTable* fileIds = NULL;		// open File -> string id of its path
+static guint32 nextStringId;
+
+static glong numEvents;
+static glong numStalls;
+static gdouble eventOverhead;			// calibrated cost of trace_io in nanoseconds
+
+
+static guint64 trace_clock()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (guint64) (now.tv_sec - traceOrigin.tv_sec) * 1000000000 + (now.tv_nsec - traceOrigin.tv_nsec);
+}
+
+/**
+ * Reserves the next slot of the ring. Waits for the flusher if the ring
+ * is full, every wait is counted as a stall.
+ */
+static TraceRecord* trace_ring_reserve(TraceRing* r)
+{
+	guint head = g_atomic_int_get(&r->head);
+
+	if (head - (guint) g_atomic_int_get(&r->tail) >= r->capacity) {
+		numStalls++;
+		while (head - (guint) g_atomic_int_get(&r->tail) >= r->capacity)
+			g_thread_yield();
+	}
+
+	return &r->records[head & (r->capacity - 1)];
+}
+
+static void trace_ring_commit(TraceRing* r)
+{
+	g_atomic_int_inc(&r->head);
+}
+
+static guint32 trace_string_id(const gchar* string)
+{
+	guint32 id = GPOINTER_TO_UINT(g_hash_table_lookup(stringIds, string));
+	if (id)
+		return id;
+
+	id = nextStringId++;
+	g_hash_table_insert(stringIds, g_strdup(string), GUINT_TO_POINTER(id));
+
+	// the definition precedes the first record using the string
+	gsize length = strlen(string);
+	TraceRecord* record = trace_ring_reserve(&ring);
+	memset(record, 0, sizeof(TraceRecord));
+	record->op = id;
+	record->size = length;
+	record->flags = TRACE_STRING;
+	trace_ring_commit(&ring);
+
+	gsize copied;
+	for (copied=0; copied<length; copied+=sizeof(TraceRecord)) {
+		record = trace_ring_reserve(&ring);
+		memset(record, 0, sizeof(TraceRecord));
+		memcpy(record, string + copied, MIN(sizeof(TraceRecord), length - copied));
+		trace_ring_commit(&ring);
+	}
+
+	return id;
+}
+
+static void trace_record(TraceRing* r, guint32 op, guint32 file, glong offset, IOStatus status)
+{
+	guint64 end = trace_clock();
+	guint64 latency = (guint64) (status.coreTime.time * 1e9);
+
+	TraceRecord* record = trace_ring_reserve(r);
+	record->start = (latency < end)? end - latency : 0;
+	record->latency = latency;
+	record->offset = offset;
+	record->size = status.coreTime.data;
+	record->op = op;
+	record->file = file;
+	record->line = traceLine;
+	record->flags = status.success? TRACE_SUCCESS : 0;
+	trace_ring_commit(r);
+}
+
+static gpointer trace_flush(gpointer data)
+{
+	for (;;) {
+		gboolean running = g_atomic_int_get(&flusherRunning);
+		guint tail = g_atomic_int_get(&ring.tail);
+		guint head = g_atomic_int_get(&ring.head);
+
+		if (head == tail) {
+			if (!running)
+				break;
+			g_usleep(1000);
+			continue;
+		}
+
+		// write the contiguous part up to the end of the ring
+		guint first = tail & (ring.capacity - 1);
+		guint count = MIN(head - tail, ring.capacity - first);
+
+		if (fwrite(&ring.records[first], sizeof(TraceRecord), count, traceFile) != count)
+			Warning("(Trace) Writing the trace failed");
+
+		g_atomic_int_add(&ring.tail, count);
+	}
+
+	return NULL;
+}
+
+/**
+ * Measures the cost of trace_io on a scratch ring, which is drained
+ * without being written. Page faults of the real ring are not included.
+ */
+static gdouble trace_calibrate()
+{
+	TraceRing scratch;
+	IOStatus status = iostatus_new(TRUE, 0.000001, 4096);
+	struct timespec start, stop;
+	gint i;
+
+	scratch.capacity = 1024;
+	scratch.records = g_malloc0(scratch.capacity * sizeof(TraceRecord));
+	scratch.head = scratch.tail = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i=0; i<TRACE_CALIBRATION_EVENTS; i++) {
+		// the lookups stand in for the interning of the operation and the path
+		guint32 op = GPOINTER_TO_UINT(g_hash_table_lookup(stringIds, "calibrate"));
+		guint32 file = GPOINTER_TO_UINT(g_hash_table_lookup(stringIds, "calibrate/file"));
+		trace_record(&scratch, op, file, i, status);
+		if (scratch.head - scratch.tail >= scratch.capacity)
+			scratch.tail = scratch.head;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	g_free(scratch.records);
+
+	return ((stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec)) / TRACE_CALIBRATION_EVENTS;
+}
+
+/**
+ * Starts tracing into directory/trace_<rank>.pbt with a ring of at least
+ * bufferSize records.
+ */
+gboolean trace_start(const gchar* directory, glong bufferSize)
+{
+	TraceHeader header;
+
+	g_assert(!traceEnabled && bufferSize > 0);
+
+	if (g_mkdir_with_parents(directory, 0755) != 0) {
+		Warning("(Trace) Couldn't create %s", directory);
+		return FALSE;
+	}
+
+	gchar* filename = g_strdup_printf("%s/trace_%d.pbt", directory, rank);
+	traceFile = g_fopen(filename, "wb");
+
+	if (!traceFile) {
+		Warning("(Trace) Couldn't open %s for writing", filename);
+		g_free(filename);
+		return FALSE;
+	}
+	g_free(filename);
+
+	ring.capacity = 1;
+	while (ring.capacity < bufferSize)
+		ring.capacity <<= 1;
+	ring.records = g_malloc0(ring.capacity * sizeof(TraceRecord));
+	ring.head = ring.tail = 0;
+
+	stringIds = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	fileIds = g_hash_table_new(g_direct_hash, g_direct_equal);
+	nextStringId = 1;
+	numEvents = numStalls = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &traceOrigin);
+
+	memset(&header, 0, sizeof(TraceHeader));
+	strncpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_VERSION;
+	header.recordSize = sizeof(TraceRecord);
+	header.rank = rank;
+	header.size = size;
+	header.origin = clock_elapsed();
+	fwrite(&header, sizeof(TraceHeader), 1, traceFile);
+
+	eventOverhead = trace_calibrate();
+
+	g_atomic_int_set(&flusherRunning, 1);
+	flusher = g_thread_new("trace", trace_flush, NULL);
+
+	traceEnabled = TRUE;
+	return TRUE;
+}
+
+/**
+ * Stops tracing, drains the ring and reports the trace overhead.
+ */
+void trace_stop()
+{
+	if (!traceEnabled)
+		return;
+
+	traceEnabled = FALSE;
+	g_atomic_int_set(&flusherRunning, 0);
+	g_thread_join(flusher);
+	flusher = NULL;
+
+	glong bytes = ftell(traceFile);
+	fclose(traceFile);
+	traceFile = NULL;
+
+	if (rank == MASTER) {
+		Log("Trace: %ld events, %ld bytes written by rank %d", numEvents, bytes, rank);
+		Log("Trace: ~%.0f ns per event (calibrated), %ld buffer stalls, %.6f s total",
+				eventOverhead, numStalls, numEvents * eventOverhead / 1e9);
+	}
+
+	g_hash_table_destroy(stringIds);
+	g_hash_table_destroy(fileIds);
+	g_free(ring.records);
+	ring.records = NULL;
+}
+
+/**
+ * Records a completed call. op has to be a string literal, path may be
+ * NULL if the call works on an open file.
+ */
+void trace_io(const gchar* op, gconstpointer file, const gchar* path, glong offset, IOStatus status)
+{
+	guint32 fileId = 0;
+
+	if (path)
+		fileId = trace_string_id(path);
+	else if (file)
+		fileId = GPOINTER_TO_UINT(g_hash_table_lookup(fileIds, file));
+
+	trace_record(&ring, trace_string_id(op), fileId, offset, status);
+	numEvents++;
+}
+
+/**
+ * Remembers the path of an opened file, so calls on the handle can be
+ * attributed to it.
+ */
+void trace_file_open(gconstpointer file, const gchar* path)
+{
+	if (traceEnabled && file)
+		g_hash_table_insert(fileIds, (gpointer) file, GUINT_TO_POINTER(trace_string_id(path)));
+}
+
+void trace_file_close(gconstpointer file)
+{
+	if (traceEnabled)
+		g_hash_table_remove(fileIds, file);
+}
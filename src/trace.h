@@ -0,0 +1,41 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "iio.h"
+#include "trace_format.h"
+
+#include <glib.h>
+
+gboolean traceEnabled;		// set while a trace is recorded
+guint    traceLine;			// kernel line of the executing statement
+
+#define TRACE_IO(op, file, path, offset, status) \
+	if (traceEnabled && !warmingUp) trace_io((op), (file), (path), (offset), (status))
+
+
+gboolean trace_start(const gchar* directory, glong bufferSize);
+void     trace_stop();
+
+void trace_io(const gchar* op, gconstpointer file, const gchar* path, glong offset, IOStatus status);
+void trace_file_open(gconstpointer file, const gchar* path);
+void trace_file_close(gconstpointer file);
+
+#endif /* TRACE_H_ */
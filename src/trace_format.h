@@ -0,0 +1,62 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACE_FORMAT_H_
+#define TRACE_FORMAT_H_
+
+#include <glib.h>
+
+/**
+ * Per-operation trace. Every traced I/O call is written as a fixed size
+ * record into a single producer, single consumer ring buffer. A flusher
+ * thread drains the ring into <dir>/trace_<rank>.pbt, so the interpreter
+ * never waits for the file system unless the ring runs full.
+ *
+ * File layout: TraceHeader followed by TraceRecords. Operation names and
+ * paths are interned, a record with TRACE_STRING set defines string op
+ * with size bytes, which follow in the next ceil(size/sizeof(TraceRecord))
+ * record slots. String ids start with 1, 0 means no file.
+ */
+
+#define TRACE_MAGIC		"PBTRACE"
+#define TRACE_VERSION	2
+
+#define TRACE_SUCCESS	0x1		// the call succeeded
+#define TRACE_STRING	0x2		// record defines a string
+
+typedef struct {
+	gchar magic[8];
+	guint32 version;
+	guint32 recordSize;		// sizeof(TraceRecord)
+	gint32 rank;
+	gint32 size;			// number of processes
+	gdouble origin;			// timestamp 0 on the global timeline (seconds since the kernel started)
+} TraceHeader;
+
+typedef struct {
+	guint64 start;			// call start, nanoseconds since the trace was started
+	guint64 latency;		// core time of the call in nanoseconds
+	gint64 offset;			// file offset, -1 if the call has none
+	gint64 size;			// bytes processed (string length for TRACE_STRING)
+	guint32 op;				// string id of the operation name
+	guint32 file;			// string id of the path, 0 if unknown
+	guint32 line;			// kernel line of the statement
+	guint32 flags;
+} TraceRecord;
+
+#endif /* TRACE_FORMAT_H_ */
@@ -201,6 +201,30 @@ gchar* var_replace_substrings(const gchar* what)
 						g_string_append(resultString, envValue);
 
 						ipos = ipos + argLen;
+					}else if( strncmp(varName, "shift", 5) == 0){
+						// rank of the process k ranks further: $$shift(k)
+						gint argLen = 0;
+						while( varName[ipos + argLen] != ')' && varName[ipos + argLen] != 0){
+							argLen++;
+						}
+						if(varName[ipos + argLen] != ')' ||varName[ipos] != '(' ){
+							printf("Error, $$shift requires parameter i.e. $$shift(K)\n" );
+							exit(1);
+						}
+						varName[ipos + argLen] = 0;
+
+						char * end;
+						glong shift = strtol(& varName[ipos+1], & end, 10);
+						if(*end != 0 || end == & varName[ipos+1]){
+							printf("Error, $$shift requires an integer parameter, got \"%s\"\n", & varName[ipos+1]);
+							exit(1);
+						}
+
+						glong n = MAX(size, 1);
+						g_string_append_printf(resultString, "%ld", ((rank + shift) % n + n) % n);
+
+						// continue behind the closing bracket
+						ipos = ipos + argLen + 1;
 					}
 
 					// add post variable data
@@ -209,8 +233,12 @@ gchar* var_replace_substrings(const gchar* what)
 					varName[ipos] = 0;
 
 					//printf("%s \n", pos + 2);
-					if( strstr(varName, "rank") != NULL){
+					if( strncmp(varName, "shift", 5) == 0){
+						// already processed
+					}else if( strstr(varName, "rank") != NULL){
 						g_string_append_printf(resultString, "%d", rank);
+					}else if( strcmp(varName, "size") == 0){
+						g_string_append_printf(resultString, "%d", size);
 					}else if( strstr(varName, "rand") != NULL){
 						g_string_append_printf(resultString, "%u", g_random_int());
 					}else if( strstr(varName, "crand") != NULL){
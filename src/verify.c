@@ -0,0 +1,259 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "timing.h"
+#include "verify.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+  #include <nmmintrin.h>
+  #define VERIFY_SSE42
+#endif
+
+#define VERIFY_CHUNK 512		// words generated at once (4 KiB)
+#define CRC32C_POLY 0x82F63B78	// reflected Castagnoli polynomial
+
+static guint32 crcTable[256];
+static gboolean crcHardware = FALSE;
+
+
+void verify_init(guint64 seed)
+{
+	guint32 i, j, crc;
+
+	for (i=0; i<256; i++) {
+		crc = i;
+		for (j=0; j<8; j++)
+			crc = (crc & 1)? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+		crcTable[i] = crc;
+	}
+
+#ifdef VERIFY_SSE42
+	crcHardware = __builtin_cpu_supports("sse4.2");
+#endif
+
+	memset(&verifyStats, 0, sizeof(VerifyStats));
+	verifySeed = seed;
+	verifyEnabled = TRUE;
+}
+
+/**
+ * Sums up the statistics of all processes on the master, the times are
+ * the ones of the slowest process.
+ */
+void verify_reduce()
+{
+#ifdef HAVE_MPI
+	glong counts[3] = { verifyStats.bytesFilled, verifyStats.bytesChecked, verifyStats.errors };
+	gdouble times[2] = { verifyStats.fillTime, verifyStats.checkTime };
+	glong sumCounts[3];
+	gdouble maxTimes[2];
+
+	MPI_Reduce(counts, sumCounts, 3, MPI_LONG, MPI_SUM, MASTER, MPI_COMM_WORLD);
+	MPI_Reduce(times, maxTimes, 2, MPI_DOUBLE, MPI_MAX, MASTER, MPI_COMM_WORLD);
+
+	if (rank == MASTER) {
+		verifyStats.bytesFilled = sumCounts[0];
+		verifyStats.bytesChecked = sumCounts[1];
+		verifyStats.errors = sumCounts[2];
+		verifyStats.fillTime = maxTimes[0];
+		verifyStats.checkTime = maxTimes[1];
+	}
+#endif
+}
+
+/**
+ * Files are told apart by their path (FNV-1a), so all processes have to
+ * use the same spelling of it.
+ */
+guint64 verify_key(const gchar* path)
+{
+	guint64 hash = G_GUINT64_CONSTANT(14695981039346656037);
+
+	for (; *path; path++) {
+		hash ^= (guchar) *path;
+		hash *= G_GUINT64_CONSTANT(1099511628211);
+	}
+
+	return hash ^ verifySeed;
+}
+
+
+/* pattern generators, both produce the same words */
+
+static inline guint32 crc32c_table(guint32 crc, guint64 value)
+{
+	gint i;
+
+	for (i=0; i<8; i++) {
+		crc = crcTable[(crc ^ value) & 0xff] ^ (crc >> 8);
+		value >>= 8;
+	}
+
+	return crc;
+}
+
+static void pattern_table(guint64* words, gint n, guint64 key, guint64 index)
+{
+	gint i;
+
+	for (i=0; i<n; i++)
+		words[i] = ((guint64) crc32c_table(key >> 32, index + i) << 32)
+				| crc32c_table((guint32) key, index + i);
+}
+
+#ifdef VERIFY_SSE42
+__attribute__((target("sse4.2")))
+static void pattern_sse42(guint64* words, gint n, guint64 key, guint64 index)
+{
+	gint i;
+
+	// the crc32 instruction has a latency of 3 cycles but a throughput of
+	// one per cycle, the words are independent so the calls overlap
+	for (i=0; i<n; i++)
+		words[i] = ((guint64) _mm_crc32_u64(key >> 32, index + i) << 32)
+				| (guint32) _mm_crc32_u64((guint32) key, index + i);
+}
+#endif
+
+static inline void pattern(guint64* words, gint n, guint64 key, guint64 index)
+{
+#ifdef VERIFY_SSE42
+	if (crcHardware) {
+		pattern_sse42(words, n, key, index);
+		return;
+	}
+#endif
+	pattern_table(words, n, key, index);
+}
+
+
+/**
+ * Fills buffer with the pattern of the bytes [offset, offset+length) of
+ * the file identified by key.
+ */
+void verify_fill(gchar* buffer, glong length, guint64 key, off_t offset)
+{
+	guint64 words[VERIFY_CHUNK];
+	guint64 tag = (guint64) rank << VERIFY_RANK_SHIFT;
+	guint64 index = offset / 8;
+	glong skip = offset % 8;	// bytes of the first word in front of offset
+	glong pos = 0;
+	gint i, n;
+
+	CORETIME_START();
+	while (pos < length) {
+		n = MIN(VERIFY_CHUNK, (skip + length - pos + 7) / 8);
+		pattern(words, n, key, index);
+
+		for (i=0; i<n; i++)
+			words[i] = GUINT64_TO_LE(words[i] ^ tag);
+
+		glong bytes = MIN(n*8 - skip, length - pos);
+		memcpy(buffer + pos, (gchar*) words + skip, bytes);
+
+		pos += bytes;
+		index += n;
+		skip = 0;
+	}
+	CORETIME_STOP(time);
+
+	verifyStats.bytesFilled += length;
+	verifyStats.fillTime += time;
+}
+
+/**
+ * Checks the bytes [start, start+bytes) of a pattern word against the
+ * writer tag, bytes that weren't read are skipped. Without a tag yet
+ * (G_MAXUINT64) the rank in the top bits becomes the tag of the range.
+ */
+static inline gboolean verify_word(const gchar* buffer, guint64 expected, glong start, glong bytes, guint64* tag)
+{
+	guint64 data = 0, present = 0, diff;
+
+	if (bytes == sizeof(guint64)) {
+		memcpy(&data, buffer, sizeof(guint64));
+		diff = GUINT64_FROM_LE(data) ^ expected;
+	}
+	else {
+		memcpy((gchar*) &data + start, buffer, bytes);
+		memset((gchar*) &present + start, 0xff, bytes);
+		present = GUINT64_FROM_LE(present);
+		diff = (GUINT64_FROM_LE(data) ^ expected) & present;
+	}
+
+	if (*tag == G_MAXUINT64) {
+		if ((diff >> VERIFY_RANK_SHIFT) >= size)
+			return FALSE;
+		*tag = (diff >> VERIFY_RANK_SHIFT) << VERIFY_RANK_SHIFT;
+	}
+
+	if (bytes != sizeof(guint64))
+		return ((diff ^ *tag) & present) == 0;
+	return diff == *tag;
+}
+
+/**
+ * Checks the bytes [offset, offset+length) of the file identified by key.
+ * All words have to carry the rank writer, with VERIFY_ANY_WRITER the one
+ * of the first word.
+ */
+gboolean verify_check(const gchar* buffer, glong length, guint64 key, off_t offset, gint writer)
+{
+	guint64 words[VERIFY_CHUNK];
+	guint64 tag = (writer == VERIFY_ANY_WRITER)? G_MAXUINT64 : (guint64) writer << VERIFY_RANK_SHIFT;
+	guint64 index = offset / 8;
+	glong skip = offset % 8;
+	glong pos = 0, errors = 0;
+	off_t firstError = -1;
+	gint i, n;
+
+	CORETIME_START();
+	while (pos < length) {
+		n = MIN(VERIFY_CHUNK, (skip + length - pos + 7) / 8);
+		pattern(words, n, key, index);
+
+		for (i=0; i<n; i++) {
+			glong start = (i == 0)? skip : 0;
+			glong bytes = MIN(8 - start, length - pos);
+
+			if (!verify_word(buffer + pos, words[i], start, bytes, &tag)) {
+				if (firstError < 0)
+					firstError = offset + pos;
+				errors++;
+			}
+			pos += bytes;
+		}
+
+		index += n;
+		skip = 0;
+	}
+	CORETIME_STOP(time);
+
+	verifyStats.bytesChecked += length;
+	verifyStats.checkTime += time;
+	verifyStats.errors += errors;
+
+	if (errors)
+		Warning("(Verify) %ld words of %ld bytes at offset %ld don't match the written data, first at offset %ld",
+				errors, length, (glong) offset, (glong) firstError);
+
+	return errors == 0;
+}
@@ -0,0 +1,63 @@
+/* Parabench - A parallel file system benchmark
+ * Copyright (C) 2009-2010  Dennis Runz
+ * University of Heidelberg
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFY_H_
+#define VERIFY_H_
+
+#include <glib.h>
+#include <sys/types.h>
+
+/**
+ * End-to-end data verification (--verify). Writers fill their buffers
+ * with a pattern derived from the seed, the file, the offset in the file
+ * and their rank, readers check every byte they get back. The pattern is
+ * made of 64 bit words: two CRC32C values of the word index keyed by the
+ * seed and the path, with the rank of the writer in the top bits. Readers
+ * pass the rank they expect, or VERIFY_ANY_WRITER to take it from the first
+ * word of the range, so every word of one read has to come from the same
+ * writer. Corrupted or stale data is detected with the offset it was found
+ * at.
+ *
+ * Filling and checking happen outside the core time, their cost is
+ * reported separately.
+ */
+
+#define VERIFY_RANK_SHIFT 40	// the writer rank occupies the top 24 bits of every word
+#define VERIFY_ANY_WRITER -1	// the first word of a checked range names its writer
+
+typedef struct {
+	glong bytesFilled;		// bytes generated for writes
+	glong bytesChecked;		// bytes checked after reads
+	glong errors;			// words that didn't match the pattern
+	gdouble fillTime;		// seconds spent generating
+	gdouble checkTime;		// seconds spent checking
+} VerifyStats;
+
+gboolean verifyEnabled;
+guint64 verifySeed;
+VerifyStats verifyStats;
+
+
+void verify_init(guint64 seed);
+void verify_reduce();
+
+guint64  verify_key(const gchar* path);
+void     verify_fill(gchar* buffer, glong length, guint64 key, off_t offset);
+gboolean verify_check(const gchar* buffer, glong length, guint64 key, off_t offset, gint writer);
+
+#endif /* VERIFY_H_ */
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <glib/gstdio.h>
+#include <glib/gprintf.h>
 
 
 static const gchar* indentString = "  ";
@@ -36,34 +37,41 @@ static XmlStackFrame* xml_new_stackframe(const gchar* name, guint level)
 	return frame;
 }
 
-XmlDocument* xml_document_new()
+/**
+ * Opens fileName for writing, returns NULL if it can't be created.
+ */
+XmlDocument* xml_document_new(const gchar* fileName)
 {
+	FILE* fh = g_fopen(fileName, "w");
+	if (!fh)
+		return NULL;
+
 	XmlDocument* doc = g_malloc0(sizeof(XmlDocument));
-	doc->buffer = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	doc->file = fh;
 	doc->stack = NULL;
+	doc->depth = 0;
 	doc->level = 1;
+	g_fprintf(doc->file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
 	return doc;
 }
 
+/**
+ * Closes all open elements and the file.
+ */
 void xml_document_free(XmlDocument* doc)
 {
-	g_string_free(doc->buffer, TRUE);
-	g_list_free(doc->stack);
-	g_free(doc);
-}
+	while (doc->stack)
+		xml_end_element(doc);
 
-void xml_document_save(XmlDocument* doc, const gchar* fileName)
-{
-	FILE* fh = g_fopen(fileName, "w");
-	g_fprintf(fh, "%s", doc->buffer->str);
-	fclose(fh);
+	fclose(doc->file);
+	g_free(doc);
 }
 
 static void xml_indent(XmlDocument* doc)
 {
-	guint i, level = g_list_length(doc->stack);
-	for (i=0; i<level; i++)
-		g_string_append(doc->buffer, indentString);
+	guint i;
+	for (i=0; i<doc->depth; i++)
+		fputs(indentString, doc->file);
 }
 
 void xml_start_element(XmlDocument* doc, const gchar* name)
@@ -74,7 +82,7 @@ void xml_start_element(XmlDocument* doc, const gchar* name)
 		// if the last element has no content,
 		// we can add the new element
 		if (!frame->hasContent) {
-			g_string_append(doc->buffer, ">\n");
+			fputs(">\n", doc->file);
 			frame->hasContent = TRUE;
 			doc->level++;
 		}
@@ -83,9 +91,10 @@ void xml_start_element(XmlDocument* doc, const gchar* name)
 	xml_indent(doc);
 
 	// append element
-	g_string_append_printf(doc->buffer, "<%s", name);
+	g_fprintf(doc->file, "<%s", name);
 
 	doc->stack = g_list_prepend(doc->stack, xml_new_stackframe(name, doc->level));
+	doc->depth++;
 }
 
 void xml_set_content(XmlDocument* doc, const gchar* value)
@@ -94,8 +103,10 @@ void xml_set_content(XmlDocument* doc, const gchar* value)
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
 
 		if (!frame->hasContent) {
-			g_string_append_printf(doc->buffer, ">%s", value);
+			gchar* escaped = g_markup_escape_text(value, -1);
+			g_fprintf(doc->file, ">%s", escaped);
 			frame->hasContent = TRUE;
+			g_free(escaped);
 		}
 	}
 }
@@ -104,7 +115,8 @@ void xml_end_element(XmlDocument* doc)
 {
 	if (doc->stack) {
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
-		doc->stack = g_list_remove_link(doc->stack, g_list_first(doc->stack));
+		doc->stack = g_list_delete_link(doc->stack, g_list_first(doc->stack));
+		doc->depth--;
 
 		if (frame->hasContent) {
 			// indentation depends on whether the open tag
@@ -113,33 +125,26 @@ void xml_end_element(XmlDocument* doc)
 			if (doc->level > frame->level)
 				xml_indent(doc);
 
-			g_string_append_printf(doc->buffer, "</%s>\n", frame->name);
+			g_fprintf(doc->file, "</%s>\n", frame->name);
 		}
 		else
-			g_string_append(doc->buffer, "/>\n");
+			fputs("/>\n", doc->file);
 
 		doc->level++;
 		g_free(frame);
 	}
 }
 
-void xml_add_attribute(XmlDocument* doc, const gchar* key, const gchar* value)
-{
-	if (doc->stack) {
-		XmlStackFrame* frame = g_list_first(doc->stack)->data;
-
-		if (!frame->hasContent)
-			g_string_append_printf(doc->buffer, " %s=\"%s\"", key, value);
-	}
-}
-
 void xml_add_attribute_string(XmlDocument* doc, const gchar* key, const gchar* value)
 {
 	if (doc->stack) {
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
 
-		if (!frame->hasContent)
-			g_string_append_printf(doc->buffer, " %s=\"%s\"", key, value);
+		if (!frame->hasContent) {
+			gchar* escaped = g_markup_escape_text(value, -1);
+			g_fprintf(doc->file, " %s=\"%s\"", key, escaped);
+			g_free(escaped);
+		}
 	}
 }
 
@@ -149,7 +154,7 @@ void xml_add_attribute_int(XmlDocument* doc, const gchar* key, gint value)
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
 
 		if (!frame->hasContent)
-			g_string_append_printf(doc->buffer, " %s=\"%d\"", key, value);
+			g_fprintf(doc->file, " %s=\"%d\"", key, value);
 	}
 }
 
@@ -159,7 +164,7 @@ void xml_add_attribute_long(XmlDocument* doc, const gchar* key, glong value)
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
 
 		if (!frame->hasContent)
-			g_string_append_printf(doc->buffer, " %s=\"%ld\"", key, value);
+			g_fprintf(doc->file, " %s=\"%ld\"", key, value);
 	}
 }
 
@@ -169,7 +174,7 @@ void xml_add_attribute_double(XmlDocument* doc, const gchar* key, gdouble value)
 		XmlStackFrame* frame = g_list_first(doc->stack)->data;
 
 		if (!frame->hasContent)
-			g_string_append_printf(doc->buffer, " %s=\"%f\"", key, value);
+			g_fprintf(doc->file, " %s=\"%f\"", key, value);
 	}
 }
 
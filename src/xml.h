@@ -20,14 +20,17 @@
 #define XML_H_
 
 #include <glib.h>
+#include <stdio.h>
 
 /**
- * Provides a streaming like interface to properly format XML output.
+ * Streaming XML writer. Elements are written to the file as soon as they
+ * are started, only the stack of open elements is kept in memory.
  */
 
 typedef struct {
-	GString* buffer;
+	FILE* file;
 	GList* stack;
+	guint depth;	// number of open elements
 	guint level;	// current level (row number)
 } XmlDocument;
 
@@ -38,9 +41,8 @@ typedef struct {
 } XmlStackFrame;
 
 
-XmlDocument* xml_document_new();
+XmlDocument* xml_document_new(const gchar* fileName);
 void xml_document_free(XmlDocument* doc);
-void xml_document_save(XmlDocument* doc, const gchar* fileName);
 
 void xml_start_element(XmlDocument* doc, const gchar* name);
 void xml_set_content(XmlDocument* doc, const gchar* value);